@@ -21,6 +21,7 @@ from .context import *
 from .configuration_space import *
 from .binding import *
 from .configuration import *
+from .configuration_batch import *
 from .features_space import *
 from .features import *
 from .objective_space import *
@@ -34,6 +34,7 @@ ccs_evaluation          = ccs_object
 ccs_features_evaluation = ccs_object
 ccs_tuner               = ccs_object
 ccs_features_tuner      = ccs_object
+ccs_configuration_batch = ccs_object
 
 ccs_false = 0
 ccs_true = 1
@@ -145,7 +146,8 @@ class ccs_object_type(CEnumeration):
     'FEATURES_SPACE',
     'FEATURES',
     'FEATURES_EVALUATION',
-    'FEATURES_TUNER' ]
+    'FEATURES_TUNER',
+    'CONFIGURATION_BATCH' ]
 
 class ccs_error(CEnumeration):
   _members_ = [ 
@@ -171,7 +173,8 @@ class ccs_error(CEnumeration):
     'UNSUPPORTED_OPERATION',
     'INVALID_EVALUATION',
     'INVALID_FEATURES',
-    'INVALID_FEATURES_TUNER' ]
+    'INVALID_FEATURES_TUNER',
+    'SAMPLING_EXHAUSTED' ]
 
 class ccs_data_type(CEnumeration):
   _members_ = [
@@ -403,6 +406,8 @@ class Object:
       return Tuner.from_handle(h, retain = retain, auto_release = auto_release)
     elif v == ccs_object_type.FEATURES_TUNER:
       return FeaturesTuner.from_handle(h, retain = retain, auto_release = auto_release)
+    elif v == ccs_object_type.CONFIGURATION_BATCH:
+      return ConfigurationBatch.from_handle(h, retain = retain, auto_release = auto_release)
     else:
       raise Error(ccs_error(ccs_error.INVALID_OBJECT))
 
@@ -446,3 +451,4 @@ from .evaluation import Evaluation
 from .features_evaluation import FeaturesEvaluation
 from .tuner import Tuner
 from .features_tuner import FeaturesTuner
+from .configuration_batch import ConfigurationBatch
@@ -124,7 +124,7 @@ class Binding(Object):
     v = ccs_hash()
     res = ccs_binding_hash(self.handle, ct.byref(v))
     Error.check(res)
-    return self.value
+    return v.value
 
   def __hash__(self):
     return self.hash
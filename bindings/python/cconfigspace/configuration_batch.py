@@ -0,0 +1,99 @@
+import ctypes as ct
+from .base import Object, Error, ccs_error, _ccs_get_function, ccs_configuration_space, ccs_configuration, ccs_configuration_batch, ccs_numeric_type, ccs_numeric, ccs_float, ccs_int
+from .hyperparameter import Hyperparameter
+from .configuration_space import ConfigurationSpace
+from .configuration import Configuration
+
+ccs_create_configuration_batch = _ccs_get_function("ccs_create_configuration_batch", [ccs_configuration_space, ct.c_size_t, ct.POINTER(ccs_configuration), ct.c_void_p, ct.POINTER(ccs_configuration_batch)])
+ccs_configuration_batch_get_configuration_space = _ccs_get_function("ccs_configuration_batch_get_configuration_space", [ccs_configuration_batch, ct.POINTER(ccs_configuration_space)])
+ccs_configuration_batch_get_user_data = _ccs_get_function("ccs_configuration_batch_get_user_data", [ccs_configuration_batch, ct.POINTER(ct.c_void_p)])
+ccs_configuration_batch_get_num_configurations = _ccs_get_function("ccs_configuration_batch_get_num_configurations", [ccs_configuration_batch, ct.POINTER(ct.c_size_t)])
+ccs_configuration_batch_get_column = _ccs_get_function("ccs_configuration_batch_get_column", [ccs_configuration_batch, ct.c_size_t, ct.POINTER(ccs_numeric_type), ct.POINTER(ct.POINTER(ccs_numeric)), ct.POINTER(ct.POINTER(ct.c_uint64))])
+ccs_configuration_batch_get_configurations = _ccs_get_function("ccs_configuration_batch_get_configurations", [ccs_configuration_batch, ct.c_size_t, ct.POINTER(ccs_configuration), ct.POINTER(ct.c_size_t)])
+
+class ConfigurationBatch(Object):
+  def __init__(self, handle = None, retain = False, auto_release = True,
+               configuration_space = None, configurations = [], user_data = None):
+    if handle is None:
+      count = len(configurations)
+      confs = (ccs_configuration * count)(*[x.handle.value for x in configurations])
+      handle = ccs_configuration_batch()
+      res = ccs_create_configuration_batch(configuration_space.handle, count, confs, user_data, ct.byref(handle))
+      Error.check(res)
+      super().__init__(handle = handle, retain = False)
+    else:
+      super().__init__(handle = handle, retain = retain, auto_release = auto_release)
+
+  @classmethod
+  def from_handle(cls, handle, retain = True, auto_release = True):
+    return cls(handle = handle, retain = retain, auto_release = auto_release)
+
+  @property
+  def configuration_space(self):
+    if hasattr(self, "_configuration_space"):
+      return self._configuration_space
+    v = ccs_configuration_space()
+    res = ccs_configuration_batch_get_configuration_space(self.handle, ct.byref(v))
+    Error.check(res)
+    self._configuration_space = ConfigurationSpace.from_handle(v)
+    return self._configuration_space
+
+  @property
+  def user_data(self):
+    if hasattr(self, "_user_data"):
+      return self._user_data
+    v = ct.c_void_p()
+    res = ccs_configuration_batch_get_user_data(self.handle, ct.byref(v))
+    Error.check(res)
+    self._user_data = v
+    return v
+
+  @property
+  def num_configurations(self):
+    if hasattr(self, "_num_configurations"):
+      return self._num_configurations
+    v = ct.c_size_t()
+    res = ccs_configuration_batch_get_num_configurations(self.handle, ct.byref(v))
+    Error.check(res)
+    self._num_configurations = v.value
+    return self._num_configurations
+
+  def _column(self, hyperparameter):
+    if isinstance(hyperparameter, Hyperparameter):
+      hyperparameter = self.configuration_space.hyperparameter_index(hyperparameter)
+    elif isinstance(hyperparameter, str):
+      hyperparameter = self.configuration_space.hyperparameter_index_by_name(hyperparameter)
+    t = ccs_numeric_type(0)
+    v = ct.POINTER(ccs_numeric)()
+    a = ct.POINTER(ct.c_uint64)()
+    res = ccs_configuration_batch_get_column(self.handle, hyperparameter, ct.byref(t), ct.byref(v), ct.byref(a))
+    Error.check(res)
+    return (t.value, v, a)
+
+  # Returns a ctypes array sharing the memory of the column. The array keeps
+  # the batch alive.
+  def column(self, hyperparameter):
+    t, v, a = self._column(hyperparameter)
+    ctype = ccs_float if t == ccs_numeric_type.NUM_FLOAT else ccs_int
+    res = (ctype * self.num_configurations).from_address(ct.addressof(v.contents))
+    res._batch = self
+    return res
+
+  def actives(self, hyperparameter):
+    t, v, a = self._column(hyperparameter)
+    return [((a[i // 64] >> (i % 64)) & 1) == 1 for i in range(self.num_configurations)]
+
+  # Returns a NumPy array sharing the memory of the column.
+  def to_numpy(self, hyperparameter):
+    import numpy
+    return numpy.ctypeslib.as_array(self.column(hyperparameter))
+
+  @property
+  def configurations(self):
+    count = self.num_configurations
+    if count == 0:
+      return []
+    v = (ccs_configuration * count)()
+    res = ccs_configuration_batch_get_configurations(self.handle, count, v, None)
+    Error.check(res)
+    return [Configuration(handle = ccs_configuration(x), retain = False) for x in v]
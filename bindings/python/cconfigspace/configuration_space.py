@@ -1,16 +1,37 @@
 import ctypes as ct
-from .base import Object, Error, ccs_error, _ccs_get_function, ccs_context, ccs_hyperparameter, ccs_configuration_space, ccs_configuration, ccs_rng, ccs_distribution, ccs_expression, ccs_datum
+from .base import Object, Error, ccs_error, _ccs_get_function, ccs_context, ccs_hyperparameter, ccs_configuration_space, ccs_configuration, ccs_rng, ccs_distribution, ccs_expression, ccs_datum, ccs_bool, CEnumeration
 from .context import Context
 from .distribution import Distribution
 from .hyperparameter import Hyperparameter
 from .expression import Expression
 from .expression_parser import ccs_parser
 from .rng import Rng
-from parglare.parser import Context as PContext
+
+class ccs_sampling_method(CEnumeration):
+  _members_ = [
+    ('RANDOM', 0),
+    'LATIN_HYPERCUBE',
+    'HALTON',
+    'SOBOL' ]
+
+class ccs_configuration_validity(CEnumeration):
+  _members_ = [
+    ('VALID', 0),
+    'INVALID_SPACE',
+    'INVALID_ACTIVATION',
+    'INVALID_VALUE',
+    'FORBIDDEN' ]
 
 ccs_create_configuration_space = _ccs_get_function("ccs_create_configuration_space", [ct.c_char_p, ct.c_void_p, ct.POINTER(ccs_configuration_space)])
 ccs_configuration_space_set_rng = _ccs_get_function("ccs_configuration_space_set_rng", [ccs_configuration_space, ccs_rng])
 ccs_configuration_space_get_rng = _ccs_get_function("ccs_configuration_space_get_rng", [ccs_configuration_space, ct.POINTER(ccs_rng)])
+ccs_configuration_space_set_lazy_sampling = _ccs_get_function("ccs_configuration_space_set_lazy_sampling", [ccs_configuration_space, ccs_bool])
+ccs_configuration_space_get_lazy_sampling = _ccs_get_function("ccs_configuration_space_get_lazy_sampling", [ccs_configuration_space, ct.POINTER(ccs_bool)])
+ccs_configuration_space_set_sampling_method = _ccs_get_function("ccs_configuration_space_set_sampling_method", [ccs_configuration_space, ccs_sampling_method])
+ccs_configuration_space_get_sampling_method = _ccs_get_function("ccs_configuration_space_get_sampling_method", [ccs_configuration_space, ct.POINTER(ccs_sampling_method)])
+ccs_configuration_space_set_unique_sampling = _ccs_get_function("ccs_configuration_space_set_unique_sampling", [ccs_configuration_space, ccs_bool])
+ccs_configuration_space_get_unique_sampling = _ccs_get_function("ccs_configuration_space_get_unique_sampling", [ccs_configuration_space, ct.POINTER(ccs_bool)])
+ccs_configuration_space_exclude_configurations = _ccs_get_function("ccs_configuration_space_exclude_configurations", [ccs_configuration_space, ct.c_size_t, ct.POINTER(ccs_configuration)])
 ccs_configuration_space_add_hyperparameter = _ccs_get_function("ccs_configuration_space_add_hyperparameter", [ccs_configuration_space, ccs_hyperparameter, ccs_distribution])
 ccs_configuration_space_add_hyperparameters = _ccs_get_function("ccs_configuration_space_add_hyperparameters", [ccs_configuration_space, ct.c_size_t, ct.POINTER(ccs_hyperparameter), ct.POINTER(ccs_distribution)])
 ccs_configuration_space_set_distribution = _ccs_get_function("ccs_configuration_space_set_distribution", [ccs_configuration_space, ccs_distribution, ct.POINTER(ct.c_size_t)])
@@ -20,13 +41,17 @@ ccs_configuration_space_get_condition = _ccs_get_function("ccs_configuration_spa
 ccs_configuration_space_get_conditions = _ccs_get_function("ccs_configuration_space_get_conditions", [ccs_configuration_space, ct.c_size_t, ct.POINTER(ccs_expression), ct.POINTER(ct.c_size_t)])
 ccs_configuration_space_add_forbidden_clause = _ccs_get_function("ccs_configuration_space_add_forbidden_clause", [ccs_configuration_space, ccs_expression])
 ccs_configuration_space_add_forbidden_clauses = _ccs_get_function("ccs_configuration_space_add_forbidden_clauses", [ccs_configuration_space, ct.c_size_t, ccs_expression])
+ccs_configuration_space_freeze_forbidden_clauses_order = _ccs_get_function("ccs_configuration_space_freeze_forbidden_clauses_order", [ccs_configuration_space, ccs_bool])
 ccs_configuration_space_get_forbidden_clause = _ccs_get_function("ccs_configuration_space_get_forbidden_clause", [ccs_configuration_space, ct.c_size_t, ct.POINTER(ccs_expression)])
 ccs_configuration_space_get_forbidden_clauses = _ccs_get_function("ccs_configuration_space_get_forbidden_clauses", [ccs_configuration_space, ct.c_size_t, ct.POINTER(ccs_expression), ct.POINTER(ct.c_size_t)])
 ccs_configuration_space_check_configuration = _ccs_get_function("ccs_configuration_space_check_configuration", [ccs_configuration_space, ccs_configuration])
 ccs_configuration_space_check_configuration_values = _ccs_get_function("ccs_configuration_space_check_configuration_values", [ccs_configuration_space, ct.c_size_t, ct.POINTER(ccs_datum)])
+ccs_configuration_space_check_configurations = _ccs_get_function("ccs_configuration_space_check_configurations", [ccs_configuration_space, ct.c_size_t, ct.POINTER(ccs_configuration), ct.POINTER(ccs_bool), ct.POINTER(ccs_configuration_validity)])
+ccs_configuration_space_check_configurations_values = _ccs_get_function("ccs_configuration_space_check_configurations_values", [ccs_configuration_space, ct.c_size_t, ct.c_size_t, ct.POINTER(ccs_datum), ct.POINTER(ccs_bool), ct.POINTER(ccs_configuration_validity)])
 ccs_configuration_space_get_default_configuration = _ccs_get_function("ccs_configuration_space_get_default_configuration", [ccs_configuration_space, ct.POINTER(ccs_configuration)])
 ccs_configuration_space_sample = _ccs_get_function("ccs_configuration_space_sample", [ccs_configuration_space, ct.POINTER(ccs_configuration)])
 ccs_configuration_space_samples = _ccs_get_function("ccs_configuration_space_samples", [ccs_configuration_space, ct.c_size_t, ct.POINTER(ccs_configuration)])
+ccs_configuration_space_samples_parallel = _ccs_get_function("ccs_configuration_space_samples_parallel", [ccs_configuration_space, ct.c_size_t, ct.c_size_t, ct.POINTER(ccs_configuration)])
 
 class ConfigurationSpace(Context):
   def __init__(self, handle = None, retain = False, auto_release = True,
@@ -55,6 +80,50 @@ class ConfigurationSpace(Context):
     res = ccs_configuration_space_set_rng(self.handle, r.handle)
     Error.check(res)
 
+  @property
+  def lazy_sampling(self):
+    v = ccs_bool()
+    res = ccs_configuration_space_get_lazy_sampling(self.handle, ct.byref(v))
+    Error.check(res)
+    return False if v.value == 0 else True
+
+  @lazy_sampling.setter
+  def lazy_sampling(self, lazy_sampling):
+    res = ccs_configuration_space_set_lazy_sampling(self.handle, lazy_sampling)
+    Error.check(res)
+
+  @property
+  def sampling_method(self):
+    v = ccs_sampling_method(0)
+    res = ccs_configuration_space_get_sampling_method(self.handle, ct.byref(v))
+    Error.check(res)
+    return v.value
+
+  @sampling_method.setter
+  def sampling_method(self, sampling_method):
+    res = ccs_configuration_space_set_sampling_method(self.handle, sampling_method)
+    Error.check(res)
+
+  @property
+  def unique_sampling(self):
+    v = ccs_bool()
+    res = ccs_configuration_space_get_unique_sampling(self.handle, ct.byref(v))
+    Error.check(res)
+    return False if v.value == 0 else True
+
+  @unique_sampling.setter
+  def unique_sampling(self, unique_sampling):
+    res = ccs_configuration_space_set_unique_sampling(self.handle, unique_sampling)
+    Error.check(res)
+
+  def exclude_configurations(self, configurations):
+    count = len(configurations)
+    if count == 0:
+      return None
+    configs = (ccs_configuration * count)(*[x.handle.value for x in configurations])
+    res = ccs_configuration_space_exclude_configurations(self.handle, count, configs)
+    Error.check(res)
+
   def add_hyperparameter(self, hyperparameter, distribution = None):
     if distribution:
       distribution = distribution.handle
@@ -104,7 +173,7 @@ class ConfigurationSpace(Context):
 
   def set_condition(self, hyperparameter, expression):
     if isinstance(expression, str):
-      expression = ccs_parser.parse(expression, context = PContext(extra=self))
+      expression = ccs_parser.parse(expression, context = self)
     if isinstance(hyperparameter, Hyperparameter):
       hyperparameter = self.hyperparameter_index(hyperparameter)
     elif isinstance(hyperparameter, str):
@@ -153,7 +222,7 @@ class ConfigurationSpace(Context):
 
   def add_forbidden_clause(self, expression):
     if isinstance(expression, str):
-      expression = ccs_parser.parse(expression, context = PContext(extra=self))
+      expression = ccs_parser.parse(expression, context = self)
     res = ccs_configuration_space_add_forbidden_clause(self.handle, expression.handle)
     Error.check(res)
 
@@ -161,11 +230,15 @@ class ConfigurationSpace(Context):
     sz = len(expressions)
     if sz == 0:
       return None
-    expressions = [ ccs_parser.parse(expression, context = PContext(extra=self)) if isinstance(expression, str) else expression for expression in expressions ]
+    expressions = [ ccs_parser.parse(expression, context = self) if isinstance(expression, str) else expression for expression in expressions ]
     v = (ccs_expression * sz)(*[x.handle.value for x in expressions])
     res = ccs_configuration_space_add_forbidden_clauses(self.handle, sz, v)
     Error.check(res)
 
+  def freeze_forbidden_clauses_order(self, freeze = True):
+    res = ccs_configuration_space_freeze_forbidden_clauses_order(self.handle, freeze)
+    Error.check(res)
+
   def forbidden_clause(self, index):
     v = ccs_expression()
     res = ccs_configuration_space_get_forbidden_clause(self.handle, index, ct.byref(v))
@@ -203,6 +276,36 @@ class ConfigurationSpace(Context):
     res = ccs_configuration_space_check_configuration_values(self.handle, count, v)
     Error.check(res)
 
+  # Returns, for each configuration, ccs_configuration_validity.VALID or the
+  # reason why it is not valid.
+  def check_configurations(self, configurations):
+    count = len(configurations)
+    if count == 0:
+      return []
+    v = (ccs_configuration * count)(*[x.handle.value for x in configurations])
+    valids = (ccs_bool * count)()
+    reasons = (ccs_configuration_validity * count)()
+    res = ccs_configuration_space_check_configurations(self.handle, count, v, valids, reasons)
+    Error.check(res)
+    return [x.value for x in reasons]
+
+  def check_configurations_values(self, values):
+    count = len(values)
+    if count == 0:
+      return []
+    num_values = self.num_hyperparameters
+    if any(len(x) != num_values for x in values):
+      raise Error(ccs_error(ccs_error.INVALID_VALUE))
+    v = (ccs_datum * (count * num_values))()
+    for i in range(count):
+      for j in range(num_values):
+        v[i * num_values + j].value = values[i][j]
+    valids = (ccs_bool * count)()
+    reasons = (ccs_configuration_validity * count)()
+    res = ccs_configuration_space_check_configurations_values(self.handle, count, num_values, v, valids, reasons)
+    Error.check(res)
+    return [x.value for x in reasons]
+
   @property
   def default_configuration(self):
     v = ccs_configuration()
@@ -224,4 +327,12 @@ class ConfigurationSpace(Context):
     Error.check(res)
     return [Configuration(handle = ccs_configuration(x), retain = False) for x in v]
 
+  def samples_parallel(self, count, num_threads = 0):
+    if count == 0:
+      return []
+    v = (ccs_configuration * count)()
+    res = ccs_configuration_space_samples_parallel(self.handle, num_threads, count, v)
+    Error.check(res)
+    return [Configuration(handle = ccs_configuration(x), retain = False) for x in v]
+
 from .configuration import Configuration
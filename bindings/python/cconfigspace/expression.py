@@ -64,9 +64,13 @@ ccs_expression_get_nodes = _ccs_get_function("ccs_expression_get_nodes", [ccs_ex
 ccs_literal_get_value = _ccs_get_function("ccs_literal_get_value", [ccs_expression, ct.POINTER(ccs_datum)])
 ccs_variable_get_hyperparameter = _ccs_get_function("ccs_variable_get_hyperparameter", [ccs_expression, ct.POINTER(ccs_hyperparameter)])
 ccs_expression_eval = _ccs_get_function("ccs_expression_eval", [ccs_expression, ccs_context, ct.POINTER(ccs_datum), ct.POINTER(ccs_datum)])
+ccs_expression_eval_batch = _ccs_get_function("ccs_expression_eval_batch", [ccs_expression, ccs_context, ct.c_size_t, ct.POINTER(ccs_datum), ct.POINTER(ccs_datum)])
 ccs_expression_list_eval_node = _ccs_get_function("ccs_expression_list_eval_node", [ccs_expression, ccs_context, ct.POINTER(ccs_datum), ct.c_size_t, ct.POINTER(ccs_datum)])
 ccs_expression_get_hyperparameters = _ccs_get_function("ccs_expression_get_hyperparameters", [ccs_expression, ct.c_size_t, ct.POINTER(ccs_hyperparameter), ct.POINTER(ct.c_size_t)])
 ccs_expression_check_context = _ccs_get_function("ccs_expression_check_context", [ccs_expression, ccs_context])
+ccs_expression_compile = _ccs_get_function("ccs_expression_compile", [ccs_expression, ccs_context])
+ccs_expression_parse = _ccs_get_function("ccs_expression_parse", [ccs_context, ct.c_char_p, ct.POINTER(ccs_expression)])
+ccs_expression_simplify = _ccs_get_function("ccs_expression_simplify", [ccs_expression, ct.POINTER(ccs_expression)])
 
 class Expression(Object):
   def __init__(self, handle = None, retain = False, auto_release = True,
@@ -189,10 +193,34 @@ class Expression(Object):
     Error.check(res)
     return v.value
 
+  def eval_batch(self, context, rows):
+    count = context.num_hyperparameters
+    num_rows = len(rows)
+    v = (ccs_datum * (count * num_rows))()
+    for j in range(num_rows):
+      if count != len(rows[j]):
+        raise Error(ccs_error(ccs_error.INVALID_VALUE))
+      for i in range(count):
+        v[j * count + i].value = rows[j][i]
+    r = (ccs_datum * num_rows)()
+    res = ccs_expression_eval_batch(self.handle, context.handle, num_rows, v, r)
+    Error.check(res)
+    return [x.value for x in r]
+
   def check_context(self, context):
     res = ccs_expression_check_context(self.handle, context.handle)
     Error.check(res)
 
+  def compile(self, context = None):
+    res = ccs_expression_compile(self.handle, context.handle if context else None)
+    Error.check(res)
+
+  def simplify(self):
+    v = ccs_expression()
+    res = ccs_expression_simplify(self.handle, ct.byref(v))
+    Error.check(res)
+    return Expression.from_handle(handle = v, retain = False)
+
   def __str__(self):
     t = self.type
     symbol = ccs_expression_symbols[t]
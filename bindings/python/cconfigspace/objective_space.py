@@ -6,7 +6,6 @@ from .expression import Expression
 from .expression_parser import ccs_parser
 from .configuration_space import ConfigurationSpace
 from .configuration import Configuration
-from parglare.parser import Context as PContext
 
 class ccs_objective_type(CEnumeration):
   _members_ = [
@@ -52,7 +51,7 @@ class ObjectiveSpace(Context):
 
   def add_objective(self, expression, t = ccs_objective_type.MINIMIZE):
     if isinstance(expression, str):
-      expression = ccs_parser.parse(expression, context = PContext(extra=self))
+      expression = ccs_parser.parse(expression, context = self)
     res = ccs_objective_space_add_objective(self.handle, expression.handle, t)
     Error.check(res)
 
@@ -60,7 +59,7 @@ class ObjectiveSpace(Context):
     if isinstance(expressions, dict):
       types = expressions.values()
       expressions = expressions.keys()
-    expressions = [ ccs_parser.parse(expression, context = PContext(extra=self)) if isinstance(expression, str) else expression for expression in expressions ]
+    expressions = [ ccs_parser.parse(expression, context = self) if isinstance(expression, str) else expression for expression in expressions ]
     sz = len(expressions)
     if sz == 0:
       return None
@@ -3,17 +3,27 @@ from . import libcconfigspace
 from .base import Object, Error, ccs_float, ccs_result, ccs_rng, _ccs_get_function
 
 ccs_rng_create = _ccs_get_function("ccs_rng_create", [ct.POINTER(ccs_rng)])
+ccs_rng_create_with_type = _ccs_get_function("ccs_rng_create_with_type", [ct.c_void_p, ct.POINTER(ccs_rng)])
+ccs_rng_philox4x32_10 = ct.c_void_p.in_dll(libcconfigspace, "ccs_rng_philox4x32_10")
 ccs_rng_set_seed = _ccs_get_function("ccs_rng_set_seed", [ccs_rng, ct.c_ulong])
+ccs_rng_get_state = _ccs_get_function("ccs_rng_get_state", [ccs_rng, ct.c_size_t, ct.c_void_p, ct.POINTER(ct.c_size_t)])
+ccs_rng_set_state = _ccs_get_function("ccs_rng_set_state", [ccs_rng, ct.c_size_t, ct.c_void_p])
 ccs_rng_get = _ccs_get_function("ccs_rng_get", [ccs_rng, ct.POINTER(ct.c_ulong)])
 ccs_rng_uniform = _ccs_get_function("ccs_rng_uniform", [ccs_rng, ct.POINTER(ccs_float)])
+ccs_rng_uniform_fill = _ccs_get_function("ccs_rng_uniform_fill", [ccs_rng, ct.c_size_t, ct.POINTER(ccs_float)])
+ccs_rng_jump = _ccs_get_function("ccs_rng_jump", [ccs_rng, ct.c_uint64])
+ccs_rng_split = _ccs_get_function("ccs_rng_split", [ccs_rng, ct.c_size_t, ct.POINTER(ccs_rng)])
 ccs_rng_min = _ccs_get_function("ccs_rng_min", [ccs_rng, ct.POINTER(ct.c_ulong)])
 ccs_rng_max = _ccs_get_function("ccs_rng_max", [ccs_rng, ct.POINTER(ct.c_ulong)])
 
 class Rng(Object):
-  def __init__(self, handle = None, retain = False, auto_release = True):
+  def __init__(self, handle = None, retain = False, auto_release = True, philox = False):
     if handle is None:
       handle = ccs_rng(0)
-      res = ccs_rng_create(ct.byref(handle))
+      if philox:
+        res = ccs_rng_create_with_type(ccs_rng_philox4x32_10, ct.byref(handle))
+      else:
+        res = ccs_rng_create(ct.byref(handle))
       Error.check(res)
       super().__init__(handle = handle, retain = False)
     else:
@@ -28,8 +38,22 @@ class Rng(Object):
       res = ccs_rng_set_seed(self.handle, value)
       Error.check(res)
       return None
+    if name == 'state':
+      res = ccs_rng_set_state(self.handle, len(value), value)
+      Error.check(res)
+      return None
     super().__setattr__(name, value)
 
+  @property
+  def state(self):
+    sz = ct.c_size_t()
+    res = ccs_rng_get_state(self.handle, 0, None, ct.byref(sz))
+    Error.check(res)
+    v = ct.create_string_buffer(sz.value)
+    res = ccs_rng_get_state(self.handle, sz, v, None)
+    Error.check(res)
+    return v.raw
+
   def get(self):
     v = ct.c_ulong(0)
     res = ccs_rng_get(self.handle, ct.byref(v))
@@ -42,6 +66,26 @@ class Rng(Object):
     Error.check(res)
     return v.value
 
+  def uniforms(self, count):
+    if count == 0:
+      return []
+    v = (ccs_float * count)()
+    res = ccs_rng_uniform_fill(self.handle, count, v)
+    Error.check(res)
+    return list(v)
+
+  def jump(self, count):
+    res = ccs_rng_jump(self.handle, count)
+    Error.check(res)
+
+  def split(self, count):
+    if count == 0:
+      return []
+    v = (ccs_rng * count)()
+    res = ccs_rng_split(self.handle, count, v)
+    Error.check(res)
+    return [Rng(handle = ccs_rng(x), retain = False) for x in v]
+
   @property
   def min(self):
     v = ct.c_ulong(0)
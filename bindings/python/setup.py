@@ -1,6 +1,4 @@
 from setuptools import setup, find_packages
-from pkg_resources import require
-require("parglare==0.12.0")
 setup(
     name = "cconfigspace",
     version = "0.0.1",
@@ -0,0 +1,56 @@
+import unittest
+import math
+import sys
+sys.path.insert(1, '.')
+sys.path.insert(1, '..')
+import cconfigspace as ccs
+
+class TestConfigurationBatch(unittest.TestCase):
+
+  def test_create(self):
+    cs = ccs.ConfigurationSpace(name = "space")
+    h1 = ccs.NumericalHyperparameter(lower = -1.0, upper = 1.0)
+    h2 = ccs.NumericalHyperparameter(data_type = ccs.NUM_INTEGER, lower = 0, upper = 10, quantization = 0)
+    h3 = ccs.CategoricalHyperparameter(values = [1, 2.0, "3"])
+    cs.add_hyperparameters([h1, h2, h3])
+    cs.set_condition(h1, ccs.Expression(t = ccs.LESS, nodes = [h2, 5]))
+    confs = cs.samples(100)
+    b = ccs.ConfigurationBatch(configuration_space = cs, configurations = confs)
+    self.assertEqual( ccs.CONFIGURATION_BATCH, b.object_type )
+    self.assertEqual( cs.handle.value, b.configuration_space.handle.value )
+    self.assertEqual( 100, b.num_configurations )
+    col1 = b.column(h1)
+    col2 = b.column(h2.name)
+    col3 = b.column(2)
+    actives = b.actives(h1)
+    for i in range(100):
+      v = confs[i].values
+      self.assertEqual( v[0] != ccs.ccs_inactive, actives[i] )
+      if actives[i]:
+        self.assertEqual( v[0], col1[i] )
+      else:
+        self.assertTrue( math.isnan(col1[i]) )
+      self.assertEqual( v[1], col2[i] )
+      self.assertEqual( v[2], h3.values[col3[i]] )
+    self.assertEqual( confs, b.configurations )
+    col3[0] = (col3[0] + 1) % 3
+    self.assertEqual( h3.values[col3[0]], b.configurations[0].value(h3) )
+
+  def test_to_numpy(self):
+    try:
+      import numpy
+    except ImportError:
+      self.skipTest("numpy is not available")
+    cs = ccs.ConfigurationSpace(name = "space")
+    h1 = ccs.NumericalHyperparameter(lower = -1.0, upper = 1.0)
+    cs.add_hyperparameter(h1)
+    confs = cs.samples(10)
+    b = ccs.ConfigurationBatch(configuration_space = cs, configurations = confs)
+    a = b.to_numpy(h1)
+    self.assertEqual( (10,), a.shape )
+    self.assertEqual( [c.values[0] for c in confs], a.tolist() )
+    a[0] = 0.5
+    self.assertEqual( 0.5, b.configurations[0].values[0] )
+
+if __name__ == '__main__':
+    unittest.main()
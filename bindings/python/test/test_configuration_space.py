@@ -58,6 +58,53 @@ class TestConfigurationSpace(unittest.TestCase):
     self.assertEqual( d.handle.value, dist.handle.value )
     self.assertEqual( 0, indx )
 
+  def test_sampling_method(self):
+    cs = ccs.ConfigurationSpace(name = "space")
+    h1 = ccs.NumericalHyperparameter()
+    h2 = ccs.NumericalHyperparameter()
+    cs.add_hyperparameters([h1, h2])
+    self.assertEqual( ccs.ccs_sampling_method.RANDOM, cs.sampling_method )
+    for m in [ccs.ccs_sampling_method.LATIN_HYPERCUBE, ccs.ccs_sampling_method.HALTON, ccs.ccs_sampling_method.SOBOL]:
+      cs.sampling_method = m
+      self.assertEqual( m, cs.sampling_method )
+      for c in cs.samples(100):
+        cs.check(c)
+
+  def test_unique_sampling(self):
+    cs = ccs.ConfigurationSpace(name = "space")
+    h1 = ccs.CategoricalHyperparameter(values = [1, 2, 3])
+    h2 = ccs.NumericalHyperparameter(data_type = ccs.NUM_INTEGER, lower = 0, upper = 4, quantization = 0)
+    cs.add_hyperparameters([h1, h2])
+    self.assertFalse( cs.unique_sampling )
+    cs.unique_sampling = True
+    self.assertTrue( cs.unique_sampling )
+    confs = cs.samples(6)
+    cs.exclude_configurations(confs)
+    confs += cs.samples(6)
+    self.assertEqual( 12, len(set(confs)) )
+    with self.assertRaises(ccs.Error) as e:
+      cs.sample()
+    self.assertEqual( ccs.ccs_error.SAMPLING_EXHAUSTED, e.exception.message.value )
+    cs.unique_sampling = False
+    cs.sample()
+
+  def test_check_configurations(self):
+    cs = ccs.ConfigurationSpace(name = "space")
+    h1 = ccs.NumericalHyperparameter(lower = -1.0, upper = 1.0)
+    h2 = ccs.NumericalHyperparameter(data_type = ccs.NUM_INTEGER, lower = 0, upper = 10, quantization = 0)
+    cs.add_hyperparameters([h1, h2])
+    cs.set_condition(h1, ccs.Expression(t = ccs.LESS, nodes = [h2, 5]))
+    cs.add_forbidden_clause(ccs.Expression(t = ccs.EQUAL, nodes = [h2, 7]))
+    confs = cs.samples(20)
+    self.assertEqual( [ccs.ccs_configuration_validity.VALID] * 20, cs.check_configurations(confs) )
+    values = [ [0.5, 2], [ccs.ccs_inactive, 2], [0.5, 6], [2.0, 2], [ccs.ccs_inactive, 7], [ccs.ccs_inactive, 6] ]
+    reasons = [ ccs.ccs_configuration_validity.VALID,
+                ccs.ccs_configuration_validity.INVALID_ACTIVATION,
+                ccs.ccs_configuration_validity.INVALID_ACTIVATION,
+                ccs.ccs_configuration_validity.INVALID_VALUE,
+                ccs.ccs_configuration_validity.FORBIDDEN,
+                ccs.ccs_configuration_validity.VALID ]
+    self.assertEqual( reasons, cs.check_configurations_values(values) )
 
   def test_conditions(self):
     h1 = ccs.NumericalHyperparameter(lower = -1.0, upper = 1.0, default = 0.0)
@@ -86,6 +133,11 @@ class TestConfigurationSpace(unittest.TestCase):
     forbidden_clauses = cs.forbidden_clauses
     self.assertEqual( 1, len(forbidden_clauses) )
     self.assertEqual( e3.handle.value, forbidden_clauses[0].handle.value )
+    self.assertFalse( cs.lazy_sampling )
+    cs.lazy_sampling = True
+    self.assertTrue( cs.lazy_sampling )
+    for c in cs.samples(100):
+      cs.check(c)
 
   def extract_active_parameters(self, values):
     res = ['p1']
@@ -28,6 +28,50 @@ class TestRng(unittest.TestCase):
     self.assertTrue( v >= 0.0 )
     self.assertTrue( v <  1.0 )
 
+  def test_uniforms(self):
+    for rng in [ccs.Rng(), ccs.Rng(philox = True)]:
+      rng.seed = 10
+      v1 = [rng.uniform() for i in range(70)]
+      rng.seed = 10
+      v2 = rng.uniforms(3) + rng.uniforms(67)
+      self.assertEqual(v1, v2)
+
+  def test_philox(self):
+    rng = ccs.Rng(philox = True)
+    rng.seed = 0
+    self.assertEqual( 0xffffffff, rng.max )
+    self.assertEqual( [0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8], [rng.get() for i in range(4)] )
+
+  def test_jump(self):
+    for rng in [ccs.Rng(), ccs.Rng(philox = True)]:
+      rng.seed = 10
+      v1 = [rng.get() for i in range(11)]
+      rng.seed = 10
+      rng.jump(10)
+      self.assertEqual(v1[10], rng.get())
+
+  def test_split(self):
+    for rng in [ccs.Rng(), ccs.Rng(philox = True)]:
+      rng.seed = 10
+      v1 = [r.get() for r in rng.split(4)]
+      rng.seed = 10
+      children = rng.split(4)
+      self.assertEqual(4, len(children))
+      self.assertEqual(v1, [r.get() for r in children])
+      self.assertEqual(4, len(set(v1)))
+
+  def test_state(self):
+    for rng in [ccs.Rng(), ccs.Rng(philox = True)]:
+      rng.seed = 10
+      rng.jump(3)
+      state = rng.state
+      self.assertIsInstance( state, bytes )
+      v1 = [rng.get() for i in range(10)]
+      rng.state = state
+      self.assertEqual(v1, [rng.get() for i in range(10)])
+    with self.assertRaises(ccs.Error):
+      ccs.Rng().state = ccs.Rng(philox = True).state
+
   def test_set_seed(self):
     rng = ccs.Rng()
     rng.seed = 10
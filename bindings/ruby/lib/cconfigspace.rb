@@ -11,6 +11,7 @@ require_relative 'cconfigspace/context'
 require_relative 'cconfigspace/configuration_space'
 require_relative 'cconfigspace/binding'
 require_relative 'cconfigspace/configuration'
+require_relative 'cconfigspace/configuration_batch'
 require_relative 'cconfigspace/features_space'
 require_relative 'cconfigspace/features'
 require_relative 'cconfigspace/objective_space'
@@ -82,6 +82,7 @@ module CCS
   typedef :pointer, :ccs_features_evaluation_t
   typedef :pointer, :ccs_tuner_t
   typedef :pointer, :ccs_features_tuner_t
+  typedef :pointer, :ccs_configuration_batch_t
   typedef :pointer, :ccs_object_t
   class MemoryPointer
     alias read_ccs_rng_t read_pointer
@@ -99,6 +100,7 @@ module CCS
     alias read_ccs_features_evaluation_t read_pointer
     alias read_ccs_tuner_t read_pointer
     alias read_ccs_features_tuner_t read_pointer
+    alias read_ccs_configuration_batch_t read_pointer
     alias read_ccs_object_t read_pointer
   end
 
@@ -125,7 +127,8 @@ module CCS
     :CCS_UNSUPPORTED_OPERATION,
     :CCS_INVALID_EVALUATION,
     :CCS_INVALID_FEATURES,
-    :CCS_INVALID_FEATURES_TUNER ]
+    :CCS_INVALID_FEATURES_TUNER,
+    :CCS_SAMPLING_EXHAUSTED ]
 
   ObjectType = enum FFI::Type::INT32, :ccs_object_type_t, [
     :CCS_RNG,
@@ -140,7 +143,8 @@ module CCS
     :CCS_FEATURES_SPACE,
     :CCS_FEATURES,
     :CCS_FEATURES_EVALUATION,
-    :CCS_FEATURES_TUNER ]
+    :CCS_FEATURES_TUNER,
+    :CCS_CONFIGURATION_BATCH ]
 
   class MemoryPointer
     def read_ccs_object_type_t
@@ -510,6 +514,8 @@ module CCS
         CCS::Tuner
       when :CCS_FEATURES_TUNER
         CCS::FeaturesTuner
+      when :CCS_CONFIGURATION_BATCH
+        CCS::ConfigurationBatch
       else
         raise CCSError, :CCS_INVALID_OBJECT
       end.from_handle(handle, **opts)
@@ -0,0 +1,81 @@
+module CCS
+
+  attach_function :ccs_create_configuration_batch, [:ccs_configuration_space_t, :size_t, :pointer, :pointer, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_batch_get_configuration_space, [:ccs_configuration_batch_t, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_batch_get_user_data, [:ccs_configuration_batch_t, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_batch_get_num_configurations, [:ccs_configuration_batch_t, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_batch_get_column, [:ccs_configuration_batch_t, :size_t, :pointer, :pointer, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_batch_get_configurations, [:ccs_configuration_batch_t, :size_t, :pointer, :pointer], :ccs_result_t
+
+  class ConfigurationBatch < Object
+    add_handle_property :configuration_space, :ccs_configuration_space_t, :ccs_configuration_batch_get_configuration_space, memoize: true
+    add_property :user_data, :pointer, :ccs_configuration_batch_get_user_data, memoize: true
+    add_property :num_configurations, :size_t, :ccs_configuration_batch_get_num_configurations, memoize: true
+
+    def initialize(handle = nil, retain: false, auto_release: true,
+                   configuration_space: nil, configurations: [], user_data: nil)
+      if handle
+        super(handle, retain: retain, auto_release: auto_release)
+      else
+        count = configurations.size
+        p_configurations = MemoryPointer::new(:ccs_configuration_t, count)
+        p_configurations.write_array_of_pointer(configurations.collect(&:handle)) if count > 0
+        ptr = MemoryPointer::new(:ccs_configuration_batch_t)
+        res = CCS.ccs_create_configuration_batch(configuration_space, count, p_configurations, user_data, ptr)
+        CCS.error_check(res)
+        super(ptr.read_ccs_configuration_batch_t, retain: false)
+      end
+    end
+
+    def self.from_handle(handle, retain: true, auto_release: true)
+      self::new(handle, retain: retain, auto_release: auto_release)
+    end
+
+    # Returns the numerical type of the column, a pointer to its values and a
+    # pointer to its activity bitmap. The pointers share the memory of the
+    # batch and are only valid as long as the batch is.
+    def column_pointers(hyperparameter)
+      case hyperparameter
+      when String, Symbol
+        hyperparameter = configuration_space.hyperparameter_index_by_name(hyperparameter)
+      when Hyperparameter
+        hyperparameter = configuration_space.hyperparameter_index(hyperparameter)
+      end
+      p_type = MemoryPointer::new(:ccs_numeric_type_t)
+      p_values = MemoryPointer::new(:pointer)
+      p_actives = MemoryPointer::new(:pointer)
+      res = CCS.ccs_configuration_batch_get_column(@handle, hyperparameter, p_type, p_values, p_actives)
+      CCS.error_check(res)
+      [p_type.read_ccs_numeric_type_t, p_values.read_pointer, p_actives.read_pointer]
+    end
+
+    def column(hyperparameter)
+      type, values, _ = column_pointers(hyperparameter)
+      count = num_configurations
+      return [] if count == 0
+      if type == :CCS_NUM_FLOAT
+        values.read_array_of_double(count)
+      else
+        values.read_array_of_int64(count)
+      end
+    end
+
+    def actives(hyperparameter)
+      _, _, actives = column_pointers(hyperparameter)
+      count = num_configurations
+      return [] if count == 0
+      words = actives.read_array_of_uint64((count + 63) / 64)
+      count.times.collect { |i| (words[i / 64] >> (i % 64)) & 1 == 1 }
+    end
+
+    def configurations
+      count = num_configurations
+      return [] if count == 0
+      ptr = MemoryPointer::new(:ccs_configuration_t, count)
+      res = CCS.ccs_configuration_batch_get_configurations(@handle, count, ptr, nil)
+      CCS.error_check(res)
+      count.times.collect { |i| Configuration::new(ptr[i].read_pointer, retain: false) }
+    end
+  end
+
+end
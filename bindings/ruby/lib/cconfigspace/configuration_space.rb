@@ -1,7 +1,40 @@
 module CCS
+
+  SamplingMethod = enum FFI::Type::INT32, :ccs_sampling_method_t, [
+    :CCS_SAMPLING_RANDOM,
+    :CCS_SAMPLING_LATIN_HYPERCUBE,
+    :CCS_SAMPLING_HALTON,
+    :CCS_SAMPLING_SOBOL
+  ]
+  class MemoryPointer
+    def read_ccs_sampling_method_t
+      SamplingMethod.from_native(read_int32, nil)
+    end
+  end
+
+  ConfigurationValidity = enum FFI::Type::INT32, :ccs_configuration_validity_t, [
+    :CCS_CONFIGURATION_VALID,
+    :CCS_CONFIGURATION_INVALID_SPACE,
+    :CCS_CONFIGURATION_INVALID_ACTIVATION,
+    :CCS_CONFIGURATION_INVALID_VALUE,
+    :CCS_CONFIGURATION_FORBIDDEN
+  ]
+  class MemoryPointer
+    def read_array_of_ccs_configuration_validity_t(count)
+      read_array_of_int32(count).collect { |v| ConfigurationValidity.from_native(v, nil) }
+    end
+  end
+
   attach_function :ccs_create_configuration_space, [:string, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_configuration_space_set_rng, [:ccs_configuration_space_t, :ccs_rng_t], :ccs_result_t
   attach_function :ccs_configuration_space_get_rng, [:ccs_configuration_space_t, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_space_set_lazy_sampling, [:ccs_configuration_space_t, :ccs_bool_t], :ccs_result_t
+  attach_function :ccs_configuration_space_get_lazy_sampling, [:ccs_configuration_space_t, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_space_set_sampling_method, [:ccs_configuration_space_t, :ccs_sampling_method_t], :ccs_result_t
+  attach_function :ccs_configuration_space_get_sampling_method, [:ccs_configuration_space_t, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_space_set_unique_sampling, [:ccs_configuration_space_t, :ccs_bool_t], :ccs_result_t
+  attach_function :ccs_configuration_space_get_unique_sampling, [:ccs_configuration_space_t, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_space_exclude_configurations, [:ccs_configuration_space_t, :size_t, :pointer], :ccs_result_t
   attach_function :ccs_configuration_space_add_hyperparameter, [:ccs_configuration_space_t, :ccs_hyperparameter_t, :ccs_distribution_t], :ccs_result_t
   attach_function :ccs_configuration_space_add_hyperparameters, [:ccs_configuration_space_t, :size_t, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_configuration_space_set_distribution, [:ccs_configuration_space_t, :ccs_distribution_t, :pointer], :ccs_result_t
@@ -11,13 +44,17 @@ module CCS
   attach_function :ccs_configuration_space_get_conditions, [:ccs_configuration_space_t, :size_t, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_configuration_space_add_forbidden_clause, [:ccs_configuration_space_t, :ccs_expression_t], :ccs_result_t
   attach_function :ccs_configuration_space_add_forbidden_clauses, [:ccs_configuration_space_t, :size_t, :ccs_expression_t], :ccs_result_t
+  attach_function :ccs_configuration_space_freeze_forbidden_clauses_order, [:ccs_configuration_space_t, :ccs_bool_t], :ccs_result_t
   attach_function :ccs_configuration_space_get_forbidden_clause, [:ccs_configuration_space_t, :size_t, :pointer], :ccs_result_t
   attach_function :ccs_configuration_space_get_forbidden_clauses, [:ccs_configuration_space_t, :size_t, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_configuration_space_check_configuration, [:ccs_configuration_space_t, :ccs_configuration_t], :ccs_result_t
   attach_function :ccs_configuration_space_check_configuration_values, [:ccs_configuration_space_t, :size_t, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_space_check_configurations, [:ccs_configuration_space_t, :size_t, :pointer, :pointer, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_space_check_configurations_values, [:ccs_configuration_space_t, :size_t, :size_t, :pointer, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_configuration_space_get_default_configuration, [:ccs_configuration_space_t, :pointer], :ccs_result_t
   attach_function :ccs_configuration_space_sample, [:ccs_configuration_space_t, :pointer], :ccs_result_t
   attach_function :ccs_configuration_space_samples, [:ccs_configuration_space_t, :size_t, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_space_samples_parallel, [:ccs_configuration_space_t, :size_t, :size_t, :pointer], :ccs_result_t
 
   class ConfigurationSpace < Context
 
@@ -50,6 +87,55 @@ module CCS
       r
     end
 
+    def lazy_sampling
+      ptr = MemoryPointer::new(:ccs_bool_t)
+      res = CCS.ccs_configuration_space_get_lazy_sampling(@handle, ptr)
+      CCS.error_check(res)
+      ptr.read_ccs_bool_t == CCS::FALSE ? false : true
+    end
+
+    def lazy_sampling=(lazy_sampling)
+      res = CCS.ccs_configuration_space_set_lazy_sampling(@handle, lazy_sampling ? CCS::TRUE : CCS::FALSE)
+      CCS.error_check(res)
+      lazy_sampling
+    end
+
+    def sampling_method
+      ptr = MemoryPointer::new(:ccs_sampling_method_t)
+      res = CCS.ccs_configuration_space_get_sampling_method(@handle, ptr)
+      CCS.error_check(res)
+      ptr.read_ccs_sampling_method_t
+    end
+
+    def sampling_method=(sampling_method)
+      res = CCS.ccs_configuration_space_set_sampling_method(@handle, sampling_method)
+      CCS.error_check(res)
+      sampling_method
+    end
+
+    def unique_sampling
+      ptr = MemoryPointer::new(:ccs_bool_t)
+      res = CCS.ccs_configuration_space_get_unique_sampling(@handle, ptr)
+      CCS.error_check(res)
+      ptr.read_ccs_bool_t == CCS::FALSE ? false : true
+    end
+
+    def unique_sampling=(unique_sampling)
+      res = CCS.ccs_configuration_space_set_unique_sampling(@handle, unique_sampling ? CCS::TRUE : CCS::FALSE)
+      CCS.error_check(res)
+      unique_sampling
+    end
+
+    def exclude_configurations(configurations)
+      count = configurations.size
+      return self if count == 0
+      p_configurations = MemoryPointer::new(:ccs_configuration_t, count)
+      p_configurations.write_array_of_pointer(configurations.collect(&:handle))
+      res = CCS.ccs_configuration_space_exclude_configurations(@handle, count, p_configurations)
+      CCS.error_check(res)
+      self
+    end
+
     def add_hyperparameter(hyperparameter, distribution: nil)
       res = CCS.ccs_configuration_space_add_hyperparameter(@handle, hyperparameter, distribution)
       CCS.error_check(res)
@@ -185,6 +271,12 @@ module CCS
       self
     end
 
+    def freeze_forbidden_clauses_order(freeze = true)
+      res = CCS.ccs_configuration_space_freeze_forbidden_clauses_order(@handle, freeze ? CCS::TRUE : CCS::FALSE)
+      CCS.error_check(res)
+      self
+    end
+
     def forbidden_clause(index)
       ptr = MemoryPointer::new(:ccs_expression_t)
       res = CCS.ccs_configuration_space_get_forbidden_clause(@handle, index, ptr)
@@ -223,6 +315,34 @@ module CCS
       self
     end
 
+    # Returns, for each configuration, :CCS_CONFIGURATION_VALID or the reason
+    # why it is not valid.
+    def check_configurations(configurations)
+      count = configurations.size
+      return [] if count == 0
+      p_configurations = MemoryPointer::new(:ccs_configuration_t, count)
+      p_configurations.write_array_of_pointer(configurations.collect(&:handle))
+      p_valids = MemoryPointer::new(:ccs_bool_t, count)
+      p_reasons = MemoryPointer::new(:ccs_configuration_validity_t, count)
+      res = CCS.ccs_configuration_space_check_configurations(@handle, count, p_configurations, p_valids, p_reasons)
+      CCS.error_check(res)
+      p_reasons.read_array_of_ccs_configuration_validity_t(count)
+    end
+
+    def check_configurations_values(values)
+      count = values.size
+      return [] if count == 0
+      num_values = num_hyperparameters
+      raise CCSError, :CCS_INVALID_VALUE if values.any? { |v| v.size != num_values }
+      ptr = MemoryPointer::new(:ccs_datum_t, count * num_values)
+      values.flatten(1).each_with_index {  |v, i| Datum::new(ptr[i]).value = v }
+      p_valids = MemoryPointer::new(:ccs_bool_t, count)
+      p_reasons = MemoryPointer::new(:ccs_configuration_validity_t, count)
+      res = CCS.ccs_configuration_space_check_configurations_values(@handle, count, num_values, ptr, p_valids, p_reasons)
+      CCS.error_check(res)
+      p_reasons.read_array_of_ccs_configuration_validity_t(count)
+    end
+
     def default_configuration
       ptr = MemoryPointer::new(:ccs_configuration_t)
       res = CCS.ccs_configuration_space_get_default_configuration(@handle, ptr)
@@ -244,5 +364,13 @@ module CCS
       CCS.error_check(res)
       count.times.collect { |i| Configuration::new(ptr[i].read_pointer, retain: false) }
     end
+
+    def samples_parallel(count, num_threads: 0)
+      return [] if count == 0
+      ptr = MemoryPointer::new(:ccs_configuration_t, count)
+      res = CCS.ccs_configuration_space_samples_parallel(@handle, num_threads, count, ptr)
+      CCS.error_check(res)
+      count.times.collect { |i| Configuration::new(ptr[i].read_pointer, retain: false) }
+    end
   end
 end
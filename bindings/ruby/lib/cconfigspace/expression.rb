@@ -91,9 +91,13 @@ module CCS
   attach_function :ccs_literal_get_value, [:ccs_expression_t, :pointer], :ccs_result_t
   attach_function :ccs_variable_get_hyperparameter, [:ccs_expression_t, :pointer], :ccs_result_t
   attach_function :ccs_expression_eval, [:ccs_expression_t, :ccs_context_t, :pointer, :pointer], :ccs_result_t
+  attach_function :ccs_expression_eval_batch, [:ccs_expression_t, :ccs_context_t, :size_t, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_expression_list_eval_node, [:ccs_expression_t, :ccs_context_t, :pointer, :size_t, :pointer], :ccs_result_t
   attach_function :ccs_expression_get_hyperparameters, [:ccs_expression_t, :size_t, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_expression_check_context, [:ccs_expression_t, :ccs_context_t], :ccs_result_t
+  attach_function :ccs_expression_compile, [:ccs_expression_t, :ccs_context_t], :ccs_result_t
+  attach_function :ccs_expression_parse, [:ccs_context_t, :string, :pointer], :ccs_result_t
+  attach_function :ccs_expression_simplify, [:ccs_expression_t, :pointer], :ccs_result_t
 
   class Expression < Object
     add_property :type, :ccs_expression_type_t, :ccs_expression_get_type, memoize: true
@@ -167,6 +171,19 @@ module CCS
       Datum::new(ptr).value
     end
 
+    def eval_batch(context, rows)
+      count = context.num_hyperparameters
+      p_values = MemoryPointer::new(:ccs_datum_t, count * rows.size)
+      rows.each_with_index { |row, j|
+        raise CCSError, :CCS_INVALID_VALUE if row.size != count
+        row.each_with_index { |v, i| Datum::new(p_values[j * count + i]).value = v }
+      }
+      ptr = MemoryPointer::new(:ccs_datum_t, rows.size)
+      res = CCS.ccs_expression_eval_batch(@handle, context, rows.size, p_values, ptr)
+      CCS.error_check(res)
+      rows.size.times.collect { |j| Datum::new(ptr[j]).value }
+    end
+
     def hyperparameters
       @hyperparameters ||= begin
         ptr = MemoryPointer::new(:size_t)
@@ -190,6 +207,19 @@ module CCS
       self
     end
 
+    def compile(context = nil)
+      res = CCS.ccs_expression_compile(@handle, context)
+      CCS.error_check(res)
+      self
+    end
+
+    def simplify
+      ptr = MemoryPointer::new(:ccs_expression_t)
+      res = CCS.ccs_expression_simplify(@handle, ptr)
+      CCS.error_check(res)
+      Expression.from_handle(ptr.read_ccs_expression_t, retain: false)
+    end
+
     def to_s
       t = type
       symbol = ExpressionSymbols[t]
@@ -1,22 +1,33 @@
 module CCS
 
   attach_function :ccs_rng_create, [:pointer], :ccs_result_t
+  attach_function :ccs_rng_create_with_type, [:pointer, :pointer], :ccs_result_t
+  attach_variable :ccs_rng_philox4x32_10, :pointer
   attach_function :ccs_rng_set_seed, [:ccs_rng_t, :ulong], :ccs_result_t
+  attach_function :ccs_rng_get_state, [:ccs_rng_t, :size_t, :pointer, :pointer], :ccs_result_t
+  attach_function :ccs_rng_set_state, [:ccs_rng_t, :size_t, :pointer], :ccs_result_t
   attach_function :ccs_rng_get, [:ccs_rng_t, :pointer], :ccs_result_t
   attach_function :ccs_rng_min, [:ccs_rng_t, :pointer], :ccs_result_t
   attach_function :ccs_rng_max, [:ccs_rng_t, :pointer], :ccs_result_t
   attach_function :ccs_rng_uniform, [:ccs_rng_t, :pointer], :ccs_result_t
+  attach_function :ccs_rng_uniform_fill, [:ccs_rng_t, :size_t, :pointer], :ccs_result_t
+  attach_function :ccs_rng_jump, [:ccs_rng_t, :uint64], :ccs_result_t
+  attach_function :ccs_rng_split, [:ccs_rng_t, :size_t, :pointer], :ccs_result_t
 
   class Rng < Object
     add_property :min, :ulong, :ccs_rng_min, memoize: true
     add_property :max, :ulong, :ccs_rng_max, memoize: true
 
-    def initialize(handle = nil, retain: false, auto_release: true)
+    def initialize(handle = nil, retain: false, auto_release: true, philox: false)
       if handle
-        super
+        super(handle, retain: retain, auto_release: auto_release)
       else
         ptr = MemoryPointer::new(:ccs_rng_t)
-        res = CCS.ccs_rng_create(ptr)
+        if philox
+          res = CCS.ccs_rng_create_with_type(CCS.ccs_rng_philox4x32_10, ptr)
+        else
+          res = CCS.ccs_rng_create(ptr)
+        end
         CCS.error_check(res)
         super(ptr.read_pointer, retain: false)
       end
@@ -32,6 +43,25 @@ module CCS
       s
     end
 
+    def state
+      ptr = MemoryPointer::new(:size_t)
+      res = CCS.ccs_rng_get_state(@handle, 0, nil, ptr)
+      CCS.error_check(res)
+      sz = ptr.read_size_t
+      buff = MemoryPointer::new(sz)
+      res = CCS.ccs_rng_get_state(@handle, sz, buff, nil)
+      CCS.error_check(res)
+      buff.read_bytes(sz)
+    end
+
+    def state=(s)
+      ptr = MemoryPointer::new(s.bytesize)
+      ptr.put_bytes(0, s)
+      res = CCS.ccs_rng_set_state(@handle, s.bytesize, ptr)
+      CCS.error_check(res)
+      s
+    end
+
     def get
       ptr = MemoryPointer::new(:ulong)
       res = CCS.ccs_rng_get(@handle, ptr)
@@ -45,6 +75,28 @@ module CCS
       CCS.error_check(res)
       ptr.read_ccs_float_t
     end
+
+    def uniforms(count)
+      return [] if count == 0
+      ptr = MemoryPointer::new(:ccs_float_t, count)
+      res = CCS.ccs_rng_uniform_fill(@handle, count, ptr)
+      CCS.error_check(res)
+      ptr.read_array_of_double(count)
+    end
+
+    def jump(count)
+      res = CCS.ccs_rng_jump(@handle, count)
+      CCS.error_check(res)
+      self
+    end
+
+    def split(count)
+      return [] if count == 0
+      ptr = MemoryPointer::new(:ccs_rng_t, count)
+      res = CCS.ccs_rng_split(@handle, count, ptr)
+      CCS.error_check(res)
+      ptr.read_array_of_pointer(count).collect { |h| Rng::from_handle(h, retain: false) }
+    end
   end
 
   DefaultRng = Rng::new
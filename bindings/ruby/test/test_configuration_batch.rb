@@ -0,0 +1,40 @@
+[ '../lib', 'lib' ].each { |d| $:.unshift(d) if File::directory?(d) }
+require 'minitest/autorun'
+require 'cconfigspace'
+
+class CConfigSpaceTestConfigurationBatch < Minitest::Test
+  def setup
+    CCS.init
+  end
+
+  def test_create
+    cs = CCS::ConfigurationSpace::new(name: "space")
+    h1 = CCS::NumericalHyperparameter::new(lower: -1.0, upper: 1.0)
+    h2 = CCS::NumericalHyperparameter::new(data_type: :CCS_NUM_INTEGER, lower: 0, upper: 10, quantization: 0)
+    h3 = CCS::CategoricalHyperparameter::new(values: [1, 2.0, "3"])
+    cs.add_hyperparameters([h1, h2, h3])
+    cs.set_condition(h1, CCS::Expression::new(type: :CCS_LESS, nodes: [h2, 5]))
+    confs = cs.samples(100)
+    b = CCS::ConfigurationBatch::new(configuration_space: cs, configurations: confs)
+    assert_equal( :CCS_CONFIGURATION_BATCH, b.object_type )
+    assert_equal( cs.handle, b.configuration_space.handle )
+    assert_equal( 100, b.num_configurations )
+    col1 = b.column(h1)
+    col2 = b.column(h2.name)
+    col3 = b.column(2)
+    actives = b.actives(h1)
+    confs.each_with_index { |c, i|
+      v = c.values
+      assert_equal( v[0] != CCS::Inactive, actives[i] )
+      if actives[i]
+        assert_equal( v[0], col1[i] )
+      else
+        assert( col1[i].nan? )
+      end
+      assert_equal( v[1], col2[i] )
+      assert_equal( v[2], h3.values[col3[i]] )
+    }
+    assert_equal( confs, b.configurations )
+  end
+
+end
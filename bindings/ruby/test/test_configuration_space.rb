@@ -60,6 +60,57 @@ class CConfigSpaceTestConfigurationSpace < Minitest::Test
     assert_equal( 0, indx )
   end
 
+  def test_sampling_method
+    cs = CCS::ConfigurationSpace::new(name: "space")
+    h1 = CCS::NumericalHyperparameter::new
+    h2 = CCS::NumericalHyperparameter::new
+    cs.add_hyperparameters([h1, h2])
+    assert_equal( :CCS_SAMPLING_RANDOM, cs.sampling_method )
+    [:CCS_SAMPLING_LATIN_HYPERCUBE, :CCS_SAMPLING_HALTON, :CCS_SAMPLING_SOBOL].each { |m|
+      cs.sampling_method = m
+      assert_equal( m, cs.sampling_method )
+      cs.samples(100).each { |c|
+        cs.check(c)
+      }
+    }
+  end
+
+  def test_unique_sampling
+    cs = CCS::ConfigurationSpace::new(name: "space")
+    h1 = CCS::CategoricalHyperparameter::new(values: [1, 2, 3])
+    h2 = CCS::NumericalHyperparameter::new(data_type: :CCS_NUM_INTEGER, lower: 0, upper: 4, quantization: 0)
+    cs.add_hyperparameters([h1, h2])
+    refute( cs.unique_sampling )
+    cs.unique_sampling = true
+    assert( cs.unique_sampling )
+    confs = cs.samples(6)
+    cs.exclude_configurations(confs)
+    confs += cs.samples(6)
+    confs.combination(2).each { |a, b| refute_equal( a, b ) }
+    assert_raises(CCS::CCSError, :CCS_SAMPLING_EXHAUSTED) { cs.sample }
+    cs.unique_sampling = false
+    cs.sample
+  end
+
+  def test_check_configurations
+    cs = CCS::ConfigurationSpace::new(name: "space")
+    h1 = CCS::NumericalHyperparameter::new(lower: -1.0, upper: 1.0)
+    h2 = CCS::NumericalHyperparameter::new(data_type: :CCS_NUM_INTEGER, lower: 0, upper: 10, quantization: 0)
+    cs.add_hyperparameters([h1, h2])
+    cs.set_condition(h1, CCS::Expression::new(type: :CCS_LESS, nodes: [h2, 5]))
+    cs.add_forbidden_clause(CCS::Expression::new(type: :CCS_EQUAL, nodes: [h2, 7]))
+    confs = cs.samples(20)
+    assert_equal( [:CCS_CONFIGURATION_VALID] * 20, cs.check_configurations(confs) )
+    values = [ [0.5, 2], [CCS::Inactive, 2], [0.5, 6], [2.0, 2], [CCS::Inactive, 7], [CCS::Inactive, 6] ]
+    reasons = [ :CCS_CONFIGURATION_VALID,
+                :CCS_CONFIGURATION_INVALID_ACTIVATION,
+                :CCS_CONFIGURATION_INVALID_ACTIVATION,
+                :CCS_CONFIGURATION_INVALID_VALUE,
+                :CCS_CONFIGURATION_FORBIDDEN,
+                :CCS_CONFIGURATION_VALID ]
+    assert_equal( reasons, cs.check_configurations_values(values) )
+  end
+
   def test_conditions
     h1 = CCS::NumericalHyperparameter::new(lower: -1.0, upper: 1.0, default: 0.0)
     h2 = CCS::NumericalHyperparameter::new(lower: -1.0, upper: 1.0)
@@ -87,6 +138,12 @@ class CConfigSpaceTestConfigurationSpace < Minitest::Test
     forbidden_clauses = cs.forbidden_clauses
     assert_equal( 1, forbidden_clauses.length )
     assert_equal( e3.handle, forbidden_clauses[0].handle )
+    refute( cs.lazy_sampling )
+    cs.lazy_sampling = true
+    assert( cs.lazy_sampling )
+    cs.samples(100).each { |c|
+      cs.check(c)
+    }
   end
 
   def extract_active_parameters(values)
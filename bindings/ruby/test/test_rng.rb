@@ -31,6 +31,57 @@ class CConfigSpaceTestRng < Minitest::Test
     assert( v <  1.0 )
   end
 
+  def test_uniforms
+    [CCS::Rng::new, CCS::Rng::new(philox: true)].each { |rng|
+      rng.seed = 10
+      v1 = 70.times.collect { rng.uniform }
+      rng.seed = 10
+      v2 = rng.uniforms(3) + rng.uniforms(67)
+      assert_equal(v1, v2)
+    }
+  end
+
+  def test_philox
+    rng = CCS::Rng::new(philox: true)
+    rng.seed = 0
+    assert_equal( 0xffffffff, rng.max )
+    assert_equal( [0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8], 4.times.collect { rng.get } )
+  end
+
+  def test_jump
+    [CCS::Rng::new, CCS::Rng::new(philox: true)].each { |rng|
+      rng.seed = 10
+      v1 = 11.times.collect { rng.get }
+      rng.seed = 10
+      rng.jump(10)
+      assert_equal(v1[10], rng.get)
+    }
+  end
+
+  def test_split
+    [CCS::Rng::new, CCS::Rng::new(philox: true)].each { |rng|
+      rng.seed = 10
+      v1 = rng.split(4).collect { |r| r.get }
+      rng.seed = 10
+      children = rng.split(4)
+      assert_equal(4, children.size)
+      assert_equal(v1, children.collect { |r| r.get })
+      assert_equal(4, v1.uniq.size)
+    }
+  end
+
+  def test_state
+    [CCS::Rng::new, CCS::Rng::new(philox: true)].each { |rng|
+      rng.seed = 10
+      rng.jump(3)
+      state = rng.state
+      v1 = 10.times.collect { rng.get }
+      rng.state = state
+      assert_equal(v1, 10.times.collect { rng.get })
+    }
+    assert_raises(CCS::CCSError, :CCS_INVALID_VALUE) { CCS::Rng::new.state = CCS::Rng::new(philox: true).state }
+  end
+
   def test_set_seed
     rng = CCS::Rng::new
     rng.seed = 10
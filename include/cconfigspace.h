@@ -14,6 +14,7 @@
 #include "cconfigspace/binding.h"
 #include "cconfigspace/configuration_space.h"
 #include "cconfigspace/configuration.h"
+#include "cconfigspace/configuration_batch.h"
 #include "cconfigspace/features_space.h"
 #include "cconfigspace/features.h"
 #include "cconfigspace/objective_space.h"
@@ -140,6 +140,10 @@ typedef struct _ccs_tuner_s               *ccs_tuner_t;
  * An opaque type defining a CCS features tuner.
  */
 typedef struct _ccs_features_tuner_s      *ccs_features_tuner_t;
+/**
+ * An opaque type defining a CCS configuration batch.
+ */
+typedef struct _ccs_configuration_batch_s *ccs_configuration_batch_t;
 
 /**
  * The different possible return codes of a CCS function.
@@ -192,6 +196,8 @@ enum ccs_error_e {
 	CCS_INVALID_FEATURES,
 	/** The provided features tuner is invalid */
 	CCS_INVALID_FEATURES_TUNER,
+	/** Every distinct configuration has already been sampled */
+	CCS_SAMPLING_EXHAUSTED,
 	/** Guard */
 	CCS_ERROR_MAX,
 	/** Try forcing 32 bits value for bindings */
@@ -225,6 +231,7 @@ enum ccs_object_type_e {
 	CCS_FEATURES,            /*!< A features */
 	CCS_FEATURES_EVALUATION, /*!< An evaluation of a configuration given specific features */
 	CCS_FEATURES_TUNER,      /*!< A features aware tuner */
+	CCS_CONFIGURATION_BATCH, /*!< A batch of configurations stored by columns */
 	CCS_OBJECT_TYPE_MAX,     /*!< Guard */
 	/** Try forcing 32 bits value for bindings */
 	CCS_OBJECT_TYPE_FORCE_32BIT = INT32_MAX
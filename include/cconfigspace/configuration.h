@@ -40,6 +40,43 @@ ccs_create_configuration(ccs_configuration_space_t configuration_space,
                          void                     *user_data,
                          ccs_configuration_t      *configuration_ret);
 
+/**
+ * Create new instances of configurations on a given configuration space. The
+ * configurations and their values are allocated in a single block of memory,
+ * which is freed once all the configurations have been released. Each
+ * configuration retains its own reference count. If no values are provided
+ * the values will be initialized to #CCS_NONE.
+ * @param[in] configuration_space
+ * @param[in] num_configurations the number of configurations to create
+ * @param[in] num_values the number of values provided per configuration
+ * @param[in] values an optional array of \p num_configurations times \p
+ *                   num_values values to initialize the configurations. The
+ *                   values of a configuration are contiguous
+ * @param[in] user_data a pointer to the user data to attach to the
+ *                      configuration instances
+ * @param[out] configurations an array of \p num_configurations that will
+ *                            contain the newly created configurations
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space
+ * @return -#CCS_INVALID_VALUE if \p configurations is NULL and \p
+ *                             num_configurations is greater than 0; or if \p
+ *                             values is NULL and \p num_values is greater than
+ *                             0; or if the number of values provided is not
+ *                             equal to the number of hyperparameters in the
+ *                             configuration space; or if \p num_configurations
+ *                             is greater than INT32_MAX
+ * @return -#CCS_OUT_OF_MEMORY if there was a lack of memory to allocate the new
+ *                             configurations
+ */
+extern ccs_result_t
+ccs_create_configurations(ccs_configuration_space_t  configuration_space,
+                          size_t                     num_configurations,
+                          size_t                     num_values,
+                          ccs_datum_t               *values,
+                          void                      *user_data,
+                          ccs_configuration_t       *configurations);
+
 /**
  * Get the associated configuration space.
  * @param[in] configuration
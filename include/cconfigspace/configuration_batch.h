@@ -0,0 +1,169 @@
+#ifndef _CCS_CONFIGURATION_BATCH_H
+#define _CCS_CONFIGURATION_BATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file configuration_batch.h
+ * A configuration batch stores configurations of a configuration space (see
+ * configuration_space.h) by columns, for instance to feed them to a surrogate
+ * model. Each hyperparameter of the configuration space has a column of
+ * numerical values, and a bitmap of the configurations where it is active:
+ * configuration i is active if bit i % 64 of word i / 64 of the bitmap is set.
+ * Numerical hyperparameters store their values, in a column of their
+ * numerical type. Categorical, ordinal and discrete hyperparameters store the
+ * index of their values among their possible values, in a #CCS_NUM_INTEGER
+ * column. Inactive entries are NaN in #CCS_NUM_FLOAT columns and 0 in
+ * #CCS_NUM_INTEGER columns.
+ */
+
+/**
+ * Create a new configuration batch from configurations of a configuration
+ * space.
+ * @param[in] configuration_space
+ * @param[in] num_configurations the number of configurations in the batch
+ * @param[in] configurations an array of \p num_configurations configurations
+ *                           of the configuration space
+ * @param[in] user_data a pointer to the user data to attach to this
+ *                      configuration batch instance
+ * @param[out] configuration_batch_ret a pointer to the variable that will hold
+ *                                     the newly created configuration batch
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space; or if one of the
+ *                              configurations is not a valid CCS configuration
+ * @return -#CCS_INVALID_VALUE if \p configuration_batch_ret is NULL; or if \p
+ *                             configurations is NULL and \p
+ *                             num_configurations is greater than 0
+ * @return -#CCS_INVALID_CONFIGURATION if one of the configurations is not
+ *                                     associated to the configuration space;
+ *                                     or if one of its values is not a
+ *                                     possible value of its hyperparameter
+ * @return -#CCS_OUT_OF_MEMORY if there was a lack of memory to allocate the new
+ *                             configuration batch
+ */
+extern ccs_result_t
+ccs_create_configuration_batch(
+	ccs_configuration_space_t  configuration_space,
+	size_t                     num_configurations,
+	ccs_configuration_t       *configurations,
+	void                      *user_data,
+	ccs_configuration_batch_t *configuration_batch_ret);
+
+/**
+ * Get the associated configuration space.
+ * @param[in] configuration_batch
+ * @param[out] configuration_space_ret a pointer to the variable that will
+ *                                     contain the configuration space
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_batch is not a valid CCS
+ *                              configuration batch
+ * @return -#CCS_INVALID_VALUE if \p configuration_space_ret is NULL
+ */
+extern ccs_result_t
+ccs_configuration_batch_get_configuration_space(
+	ccs_configuration_batch_t  configuration_batch,
+	ccs_configuration_space_t *configuration_space_ret);
+
+/**
+ * Get the associated `user_data` pointer.
+ * @param[in] configuration_batch
+ * @param[out] user_data_ret a pointer to `void *` variable that will contain
+ *                           the value of the `user_data`
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_batch is not a valid CCS
+ *                              configuration batch
+ * @return -#CCS_INVALID_VALUE if \p user_data_ret is NULL
+ */
+extern ccs_result_t
+ccs_configuration_batch_get_user_data(
+	ccs_configuration_batch_t   configuration_batch,
+	void                      **user_data_ret);
+
+/**
+ * Get the number of configurations in a configuration batch.
+ * @param[in] configuration_batch
+ * @param[out] num_configurations_ret a pointer to the variable that will
+ *                                    contain the number of configurations
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_batch is not a valid CCS
+ *                              configuration batch
+ * @return -#CCS_INVALID_VALUE if \p num_configurations_ret is NULL
+ */
+extern ccs_result_t
+ccs_configuration_batch_get_num_configurations(
+	ccs_configuration_batch_t  configuration_batch,
+	size_t                    *num_configurations_ret);
+
+/**
+ * Get the column of a hyperparameter in a configuration batch. The returned
+ * buffers belong to the configuration batch, and remain valid as long as it
+ * does. They can be modified, in which case the configurations returned by
+ * ccs_configuration_batch_get_configurations reflect the modifications.
+ * @param[in] configuration_batch
+ * @param[in] index the index of the hyperparameter in the configuration space
+ * @param[out] data_type_ret an optional pointer to the variable that will
+ *                           contain the numerical type of the column
+ * @param[out] values_ret an optional pointer to the variable that will
+ *                        contain the address of the column, an array of as
+ *                        many values as there are configurations in the batch
+ * @param[out] actives_ret an optional pointer to the variable that will
+ *                         contain the address of the activity bitmap of the
+ *                         hyperparameter
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_batch is not a valid CCS
+ *                              configuration batch
+ * @return -#CCS_OUT_OF_BOUNDS if \p index is greater than or equal to the
+ *                             number of hyperparameters of the configuration
+ *                             space
+ */
+extern ccs_result_t
+ccs_configuration_batch_get_column(
+	ccs_configuration_batch_t   configuration_batch,
+	size_t                      index,
+	ccs_numeric_type_t         *data_type_ret,
+	ccs_numeric_t             **values_ret,
+	uint64_t                  **actives_ret);
+
+/**
+ * Get the configurations of a configuration batch, as new configurations.
+ * @param[in] configuration_batch
+ * @param[in] num_configurations the number of configurations that can be
+ *                               added to \p configurations. If \p
+ *                               configurations is not NULL \p
+ *                               num_configurations must be greater than 0
+ * @param[out] configurations an array of \p num_configurations that will
+ *                            contain the new configurations, or NULL. If the
+ *                            array is too big, extra values are set to NULL
+ * @param[out] num_configurations_ret a pointer to a variable that will contain
+ *                                    the number of configurations in the
+ *                                    batch, or NULL
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_batch is not a valid CCS
+ *                              configuration batch
+ * @return -#CCS_INVALID_VALUE if \p configurations is NULL and \p
+ *                             num_configurations is greater than 0; or if \p
+ *                             configurations is NULL and \p
+ *                             num_configurations_ret is NULL; or if \p
+ *                             num_configurations is less than the number of
+ *                             configurations in the batch
+ * @return -#CCS_INVALID_CONFIGURATION if an index of a categorical, ordinal
+ *                                     or discrete column is not the index of
+ *                                     a possible value of its hyperparameter
+ * @return -#CCS_OUT_OF_MEMORY if there was a lack of memory to allocate the new
+ *                             configurations
+ */
+extern ccs_result_t
+ccs_configuration_batch_get_configurations(
+	ccs_configuration_batch_t  configuration_batch,
+	size_t                     num_configurations,
+	ccs_configuration_t       *configurations,
+	size_t                    *num_configurations_ret);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_CCS_CONFIGURATION_BATCH_H
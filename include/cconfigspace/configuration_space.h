@@ -14,6 +14,60 @@ extern "C" {
  * be specified.
  */
 
+/**
+ * CCS sampling methods of configuration spaces.
+ */
+enum ccs_sampling_method_e {
+	/** Independent random samples of the hyperparameters' distributions */
+	CCS_SAMPLING_RANDOM,
+	/** Latin hypercube designs, one per batch of samples, large batches
+	 * being sampled as a sliced Latin hypercube design, one slice per
+	 * window of a few thousand samples */
+	CCS_SAMPLING_LATIN_HYPERCUBE,
+	/** Randomly shifted Halton sequence */
+	CCS_SAMPLING_HALTON,
+	/** Randomly digitally shifted Sobol sequence */
+	CCS_SAMPLING_SOBOL,
+	/** Guard */
+	CCS_SAMPLING_METHOD_MAX,
+	/** Try forcing 32 bits value for bindings */
+	CCS_SAMPLING_METHOD_FORCE_32BIT = INT32_MAX
+};
+
+/**
+ * A commodity type to represent CCS sampling methods.
+ */
+typedef enum ccs_sampling_method_e ccs_sampling_method_t;
+
+/**
+ * CCS validity of configurations in a configuration space, reporting why a
+ * configuration is not valid.
+ */
+enum ccs_configuration_validity_e {
+	/** The configuration is valid */
+	CCS_CONFIGURATION_VALID,
+	/** The configuration is not associated to the configuration space, or
+	 * its number of values is not the number of hyperparameters */
+	CCS_CONFIGURATION_INVALID_SPACE,
+	/** A hyperparameter is active while its condition is not verified, or
+	 * inactive while it is */
+	CCS_CONFIGURATION_INVALID_ACTIVATION,
+	/** The value of an active hyperparameter is not a valid value for this
+	 * hyperparameter */
+	CCS_CONFIGURATION_INVALID_VALUE,
+	/** A forbidden clause evaluates to #ccs_true */
+	CCS_CONFIGURATION_FORBIDDEN,
+	/** Guard */
+	CCS_CONFIGURATION_VALIDITY_MAX,
+	/** Try forcing 32 bits value for bindings */
+	CCS_CONFIGURATION_VALIDITY_FORCE_32BIT = INT32_MAX
+};
+
+/**
+ * A commodity type to represent CCS configuration validities.
+ */
+typedef enum ccs_configuration_validity_e ccs_configuration_validity_t;
+
 /**
  * Create a new empty configuration space.
  * @param[in] name pointer to a string that will be copied internally
@@ -88,6 +142,154 @@ extern ccs_result_t
 ccs_configuration_space_get_rng(ccs_configuration_space_t  configuration_space,
                                 ccs_rng_t                 *rng_ret);
 
+/**
+ * Enable or disable lazy sampling in a configuration space. When sampling
+ * lazily, hyperparameters are sampled in topological order, and only for the
+ * configurations where their condition holds. Distributions over several
+ * hyperparameters are still sampled for every configuration. The sampled
+ * configurations follow the same distribution as without lazy sampling, but
+ * the random stream is consumed differently, so the same seed yields
+ * different configurations. Lazy sampling is disabled by default.
+ * @param[in,out] configuration_space
+ * @param[in] lazy_sampling #CCS_TRUE to enable lazy sampling, #CCS_FALSE to
+ *                          disable it
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space
+ */
+extern ccs_result_t
+ccs_configuration_space_set_lazy_sampling(
+	ccs_configuration_space_t configuration_space,
+	ccs_bool_t                lazy_sampling);
+
+/**
+ * Get whether a configuration space samples lazily.
+ * @param[in] configuration_space
+ * @param[out] lazy_sampling_ret a pointer to the variable that will contain
+ *                               #CCS_TRUE if lazy sampling is enabled,
+ *                               #CCS_FALSE otherwise
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space
+ * @return -#CCS_INVALID_VALUE if \p lazy_sampling_ret is NULL
+ */
+extern ccs_result_t
+ccs_configuration_space_get_lazy_sampling(
+	ccs_configuration_space_t  configuration_space,
+	ccs_bool_t                *lazy_sampling_ret);
+
+/**
+ * Set the sampling method of a configuration space. Methods other than
+ * #CCS_SAMPLING_RANDOM draw points of the unit hypercube, one coordinate per
+ * hyperparameter, and map them through the inverse distribution functions of
+ * the hyperparameters' distributions. Latin hypercube designs are drawn anew
+ * for each batch of samples, while the Halton and Sobol sequences are
+ * continued from one batch to the next, and restarted with a new random shift
+ * when the method, the random generator or the hyperparameters change.
+ * The distributions are truncated to the hyperparameters' sampling intervals,
+ * so that every point of the design maps to a value inside them, and to the
+ * values allowed by the forbidden clauses that restrict the sampled values
+ * (see #ccs_configuration_space_add_forbidden_clause). Inactive
+ * hyperparameters and other forbidden configurations are handled as for
+ * random sampling, and rejected configurations are replaced by further points
+ * of the design: a new Latin hypercube design over the replaced
+ * configurations, or the following points of the Halton and Sobol sequences.
+ * Parallel sampling always samples at random, and lazy sampling only applies
+ * to random sampling. The default method is #CCS_SAMPLING_RANDOM.
+ * @param[in,out] configuration_space
+ * @param[in] sampling_method the sampling method to use
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space
+ * @return -#CCS_INVALID_VALUE if \p sampling_method is not a valid sampling
+ *                             method
+ */
+extern ccs_result_t
+ccs_configuration_space_set_sampling_method(
+	ccs_configuration_space_t configuration_space,
+	ccs_sampling_method_t     sampling_method);
+
+/**
+ * Get the sampling method of a configuration space.
+ * @param[in] configuration_space
+ * @param[out] sampling_method_ret a pointer to the variable that will contain
+ *                                 the sampling method
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space
+ * @return -#CCS_INVALID_VALUE if \p sampling_method_ret is NULL
+ */
+extern ccs_result_t
+ccs_configuration_space_get_sampling_method(
+	ccs_configuration_space_t  configuration_space,
+	ccs_sampling_method_t     *sampling_method_ret);
+
+/**
+ * Enable or disable unique sampling in a configuration space. When sampling
+ * unique configurations, the configuration space remembers the
+ * configurations it returned, as well as the configurations excluded with
+ * ccs_configuration_space_exclude_configurations, and rejects them when they
+ * are sampled again. If every hyperparameter is categorical, ordinal,
+ * discrete or integer numerical, sampled from their default distributions,
+ * and they have few combinations of values, the distinct valid
+ * configurations are counted, and sampling reports -#CCS_SAMPLING_EXHAUSTED
+ * once they have all been returned or excluded.
+ * Disabling unique sampling, or adding hyperparameters, conditions or
+ * forbidden clauses, forgets the remembered configurations. Unique sampling
+ * is disabled by default.
+ * @param[in,out] configuration_space
+ * @param[in] unique_sampling #CCS_TRUE to enable unique sampling, #CCS_FALSE
+ *                            to disable it
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space
+ */
+extern ccs_result_t
+ccs_configuration_space_set_unique_sampling(
+	ccs_configuration_space_t configuration_space,
+	ccs_bool_t                unique_sampling);
+
+/**
+ * Get whether a configuration space samples unique configurations.
+ * @param[in] configuration_space
+ * @param[out] unique_sampling_ret a pointer to the variable that will contain
+ *                                 #CCS_TRUE if unique sampling is enabled,
+ *                                 #CCS_FALSE otherwise
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space
+ * @return -#CCS_INVALID_VALUE if \p unique_sampling_ret is NULL
+ */
+extern ccs_result_t
+ccs_configuration_space_get_unique_sampling(
+	ccs_configuration_space_t  configuration_space,
+	ccs_bool_t                *unique_sampling_ret);
+
+/**
+ * Exclude configurations from unique sampling, for instance the
+ * configurations already evaluated by a tuner. Invalid configurations are
+ * ignored.
+ * @param[in,out] configuration_space
+ * @param[in] num_configurations the number of configurations to exclude
+ * @param[in] configurations an array of \p num_configurations configurations
+ *                           of the configuration space
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space; or if one of the
+ *                              configurations is not a valid CCS configuration
+ * @return -#CCS_INVALID_VALUE if \p configurations is NULL and \p
+ *                             num_configurations is greater than 0
+ * @return -#CCS_INVALID_CONFIGURATION if one of the configurations is not
+ *                                     associated to the configuration space
+ * @return -#CCS_OUT_OF_MEMORY if there was not enough memory to remember the
+ *                             configurations
+ */
+extern ccs_result_t
+ccs_configuration_space_exclude_configurations(
+	ccs_configuration_space_t  configuration_space,
+	size_t                     num_configurations,
+	ccs_configuration_t       *configurations);
+
 /**
  * Add a hyperparameter to the configuration space.
  * @param[in,out] configuration_space
@@ -465,7 +667,13 @@ ccs_configuration_space_get_conditions(
 	size_t                    *num_expressions_ret);
 
 /**
- * Add a forbidden clause to a configuration space.
+ * Add a forbidden clause to a configuration space. Unconditional
+ * hyperparameters sampled from their own distribution are sampled from the
+ * values allowed by the forbidden clauses that only reference them: clauses
+ * over a single categorical, ordinal or discrete hyperparameter, or over
+ * several of them with few combinations of values, and clauses over a single
+ * numerical hyperparameter that compare it to numerical literals. Other
+ * forbidden clauses reject the sampled configurations that they match.
  * @param[in,out] configuration_space
  * @param[in] expression the forbidden clause to dd to the configuration space
  * @return #CCS_SUCCESS on success
@@ -513,6 +721,27 @@ ccs_configuration_space_add_forbidden_clauses(
 	size_t                     num_expressions,
 	ccs_expression_t          *expressions);
 
+/**
+ * Freeze or unfreeze the order in which forbidden clauses are tested.
+ * Configuration spaces record how often each forbidden clause rejects a sampled
+ * configuration, and periodically reorder the clauses so that the most
+ * selective and cheapest clauses are tested first. Freezing reorders the
+ * clauses one last time using the collected statistics and stops recording.
+ * Unfreezing resumes recording. The order of forbidden clauses as returned by
+ * #ccs_configuration_space_get_forbidden_clauses is never affected, but when
+ * several forbidden clauses fail to evaluate, the order can change which error
+ * is reported.
+ * @param[in,out] configuration_space
+ * @param[in] freeze #CCS_TRUE to freeze the order, #CCS_FALSE to unfreeze it
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space
+ */
+extern ccs_result_t
+ccs_configuration_space_freeze_forbidden_clauses_order(
+	ccs_configuration_space_t configuration_space,
+	ccs_bool_t                freeze);
+
 /**
  * Get the forbidden clause of rank index in a configuration space.
  * @param[in] configuration_space
@@ -609,6 +838,72 @@ ccs_configuration_space_check_configuration_values(
 	size_t                     num_values,
 	ccs_datum_t               *values);
 
+/**
+ * Check that configurations are valid in a configuration space. Contrary to
+ * ccs_configuration_space_check_configuration, invalid configurations are not
+ * an error: the validity of each configuration, and the reason why it is not
+ * valid, are returned. Checking configurations in a batch is faster than
+ * checking them one at a time.
+ * @param[in] configuration_space
+ * @param[in] num_configurations the number of configurations to check
+ * @param[in] configurations an array of \p num_configurations configurations
+ * @param[out] valids_ret an array of \p num_configurations booleans that will
+ *                        contain #CCS_TRUE for valid configurations and
+ *                        #CCS_FALSE for the others
+ * @param[out] reasons_ret an optional array of \p num_configurations
+ *                         validities that will contain why the configurations
+ *                         are not valid. Hyperparameters are checked in
+ *                         topological order of their conditions, parents
+ *                         before children, and the first failure is
+ *                         reported. Forbidden clauses are checked last
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space; or if one of the
+ *                              configurations is not a valid CCS configuration
+ * @return -#CCS_INVALID_VALUE if \p configurations or \p valids_ret are NULL
+ *                             and \p num_configurations is greater than 0
+ * @return -#CCS_OUT_OF_MEMORY if there was a lack of memory to allocate
+ *                             temporary storage
+ */
+extern ccs_result_t
+ccs_configuration_space_check_configurations(
+	ccs_configuration_space_t     configuration_space,
+	size_t                        num_configurations,
+	ccs_configuration_t          *configurations,
+	ccs_bool_t                   *valids_ret,
+	ccs_configuration_validity_t *reasons_ret);
+
+/**
+ * Check that rows of values would create valid configurations for a
+ * configuration space. See ccs_configuration_space_check_configurations.
+ * @param[in] configuration_space
+ * @param[in] num_configurations the number of rows of values to check
+ * @param[in] num_values the number of values in each row
+ * @param[in] values an array of \p num_configurations rows of \p num_values
+ *                   values, stored contiguously row by row
+ * @param[out] valids_ret an array of \p num_configurations booleans that will
+ *                        contain #CCS_TRUE for valid rows and #CCS_FALSE for
+ *                        the others
+ * @param[out] reasons_ret an optional array of \p num_configurations
+ *                         validities that will contain why the rows are not
+ *                         valid
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space
+ * @return -#CCS_INVALID_VALUE if \p values or \p valids_ret are NULL and \p
+ *                             num_configurations is greater than 0
+ * @return -#CCS_OUT_OF_MEMORY if there was a lack of memory to allocate
+ *                             temporary storage
+ */
+extern ccs_result_t
+ccs_configuration_space_check_configurations_values(
+	ccs_configuration_space_t     configuration_space,
+	size_t                        num_configurations,
+	size_t                        num_values,
+	ccs_datum_t                  *values,
+	ccs_bool_t                   *valids_ret,
+	ccs_configuration_validity_t *reasons_ret);
+
 /**
  * Get the default configuration of a configuration space
  * @param[in] configuration_space
@@ -640,6 +935,9 @@ ccs_configuration_space_get_default_configuration(
  * @return -#CCS_INVALID_VALUE if configuration_ret is NULL
  * @return -#CCS_SAMPLING_UNSUCCESSFUL if no valid configuration could be
  *                                     sampled
+ * @return -#CCS_SAMPLING_EXHAUSTED if unique sampling is enabled and every
+ *                                  distinct configuration was already
+ *                                  sampled or excluded
  * @return -#CCS_OUT_OF_MEMORY if there was not enough memory to allocate the
  *                             new configuration
  */
@@ -666,6 +964,11 @@ ccs_configuration_space_sample(ccs_configuration_space_t  configuration_space,
  *                                     could be sampled. Configurations that
  *                                     could be sampled will be returned
  *                                     contiguously, and the rest will be NULL
+ * @return -#CCS_SAMPLING_EXHAUSTED if unique sampling is enabled and the
+ *                                  distinct configurations were exhausted.
+ *                                  Configurations that could be sampled will
+ *                                  be returned contiguously, and the rest
+ *                                  will be NULL
  * @return -#CCS_OUT_OF_MEMORY if there was not enough memory to allocate new
  *                             configurations. Configurations that could be
  *                             allocated will be returned, and the rest will be
@@ -676,6 +979,48 @@ ccs_configuration_space_samples(ccs_configuration_space_t  configuration_space,
                                 size_t                     num_configurations,
                                 ccs_configuration_t       *configurations);
 
+/**
+ * Get a given number of configurations sampled randomly from a configuration
+ * space, using several threads. The request is split in chunks sampled with
+ * independent generators of the same type as the configuration space
+ * generator, seeded from a single draw of the configuration space generator.
+ * For a given state of the configuration space generator, the returned
+ * configurations do not depend on the number of threads used. They are not
+ * the same as the ones that would be returned by
+ * ccs_configuration_space_samples. Unique configurations are sampled
+ * sequentially, as with ccs_configuration_space_samples.
+ * @param[in] configuration_space
+ * @param[in] num_threads the number of threads to use, including the calling
+ *                        thread. If 0, the number of online processors is used
+ * @param[in] num_configurations the number of requested configurations
+ * @param[out] configurations an array of \p num_configurations that will
+ *                            contain the requested configurations
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p configuration_space is not a valid CCS
+ *                              configuration space
+ * @return -#CCS_INVALID_VALUE if \p configurations is NULL and \p
+ *                             num_configurations is greater than 0
+ * @return -#CCS_SAMPLING_UNSUCCESSFUL if no or not enough valid configurations
+ *                                     could be sampled. Configurations that
+ *                                     could be sampled will be returned
+ *                                     contiguously, and the rest will be NULL
+ * @return -#CCS_SAMPLING_EXHAUSTED if unique sampling is enabled and the
+ *                                  distinct configurations were exhausted.
+ *                                  Configurations that could be sampled will
+ *                                  be returned contiguously, and the rest
+ *                                  will be NULL
+ * @return -#CCS_OUT_OF_MEMORY if there was not enough memory to allocate new
+ *                             configurations. Configurations that could be
+ *                             allocated will be returned, and the rest will be
+ *                             NULL
+ */
+extern ccs_result_t
+ccs_configuration_space_samples_parallel(
+	ccs_configuration_space_t  configuration_space,
+	size_t                     num_threads,
+	size_t                     num_configurations,
+	ccs_configuration_t       *configurations);
+
 #ifdef __cplusplus
 }
 #endif
@@ -230,7 +230,8 @@ ccs_create_uniform_float_distribution(ccs_float_t         lower,
 
 /**
  * Create a new area proportional distribution of integer values. Roulette
- * distributions are unidimensional.
+ * distributions are unidimensional. Samples are drawn in constant time,
+ * independently of the number of areas.
  * @param[in] num_areas the number of areas
  * @param[in] areas an array of \p num_areas positive floating point values
  *                  representing the probability of a given area to be sampled.
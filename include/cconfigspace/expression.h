@@ -446,6 +446,40 @@ ccs_expression_eval(ccs_expression_t  expression,
                     ccs_datum_t      *values,
                     ccs_datum_t      *result_ret);
 
+/**
+ * Get the values of an expression in a given context, for a batch of rows of
+ * values for the context hyperparameters. Each node of the expression is
+ * evaluated for all the rows in turn.
+ * @param[in] expression
+ * @param[in] context the context to evaluate the expression into. Can be NULL
+ * @param[in] num_rows the number of rows to evaluate the expression for
+ * @param[in] values an array of \p num_rows rows of values, each with one
+ *                   value for each hyperparameter in \p context. Can be NULL
+ * @param[out] results an array of \p num_rows values that will contain the
+ *                     results of the evaluation of the expression for each
+ *                     row. Rows for which the evaluation would return
+ *                     -#CCS_INACTIVE_HYPERPARAMETER get #ccs_inactive
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p expression is not a valid CCS expression;
+ *                              or if \p context is NULL and \p expression
+ *                              must evaluate a variable
+ * @return -#CCS_INVALID_VALUE if \p results is NULL and \p num_rows is
+ *                             greater than 0; or if \p values is NULL and
+ *                             expression must evaluate a variable; or if an
+ *                             illegal arithmetic or comparison operation would
+ *                             have occurred for one of the rows; or if a non
+ *                             boolean value is used in a boolean operation for
+ *                             one of the rows
+ * @return -#CCS_OUT_OF_MEMORY if there was not enough memory to allocate
+ *                             temporary storage
+ */
+extern ccs_result_t
+ccs_expression_eval_batch(ccs_expression_t  expression,
+                          ccs_context_t     context,
+                          size_t            num_rows,
+                          ccs_datum_t      *values,
+                          ccs_datum_t      *results);
+
 /**
  * Evaluate the entry of a list at a given index, in a given context, provided a
  * list of values for the context hyperparameters.
@@ -526,6 +560,84 @@ ccs_expression_get_hyperparameters(ccs_expression_t      expression,
 extern ccs_result_t
 ccs_expression_check_context(ccs_expression_t expression,
                              ccs_context_t    context);
+
+/**
+ * Compile an expression for faster evaluation in a given context. Variables
+ * are resolved to their index in the context once, and subsequent evaluations
+ * of the expression in this context with ccs_expression_eval run the compiled
+ * program instead of walking the expression tree. Evaluations in other
+ * contexts, or in a context whose hyperparameters do not match anymore, are
+ * not affected. Compiling an expression again replaces the previous program.
+ * This function is not thread safe with respect to evaluations of \p
+ * expression.
+ * @param[in,out] expression
+ * @param[in] context the context to compile the expression for. Can be NULL
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p expression is not a valid CCS expression;
+ *                              or if expression depends on a hyperparameter and
+ *                              \p context is not a valid CCS context
+ * @return -#CCS_INVALID_VALUE if the expression depends on a hyperparameter and
+ *                             \p context is NULL
+ * @return -#CCS_INVALID_HYPERPARAMETER if \p context does not contain one of
+ *                                      the hyperparameters referenced by the
+ *                                      expression
+ * @return -#CCS_OUT_OF_MEMORY if there was not enough memory to allocate the
+ *                             program
+ */
+extern ccs_result_t
+ccs_expression_compile(ccs_expression_t expression,
+                       ccs_context_t    context);
+
+/**
+ * Parse an expression from its textual representation, following the CCS
+ * grammar: operators use the symbols, precedence and associativity defined in
+ * #ccs_expression_symbols, #ccs_expression_precedence and
+ * #ccs_expression_associativity, the right operand of IN is a list of values
+ * between brackets, and terminals match #ccs_terminal_regexp. Identifiers
+ * are resolved to the hyperparameters of the same name in \p context.
+ * @param[in] context the context used to resolve identifiers. Can be NULL if
+ *                    the expression does not reference any hyperparameter
+ * @param[in] expression_string the NULL terminated string to parse
+ * @param[out] expression_ret a pointer to the variable that will hold the
+ *                            newly created expression
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_VALUE if \p expression_string or \p expression_ret
+ *                             are NULL; or if \p expression_string is not a
+ *                             valid expression
+ * @return -#CCS_INVALID_OBJECT if \p expression_string references a
+ *                              hyperparameter and \p context is not a valid
+ *                              CCS context
+ * @return -#CCS_INVALID_NAME if \p context does not contain a hyperparameter
+ *                            named after an identifier of \p
+ *                            expression_string
+ * @return -#CCS_OUT_OF_MEMORY if there was not enough memory to allocate the
+ *                             new expressions
+ */
+extern ccs_result_t
+ccs_expression_parse(ccs_context_t     context,
+                     const char       *expression_string,
+                     ccs_expression_t *expression_ret);
+
+/**
+ * Get a simplified version of an expression. Subexpressions that do not
+ * depend on any hyperparameter are replaced by their value, neutral boolean
+ * operands and double negations are removed, and comparisons of a literal
+ * with a variable are rewritten with the variable on the left. The returned
+ * expression evaluates to the same value, or returns the same error, as \p
+ * expression in every context. It can be \p expression itself if no
+ * simplification applies. The returned expression must be released.
+ * @param[in] expression
+ * @param[out] expression_ret a pointer to the variable that will hold the
+ *                            simplified expression
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p expression is not a valid CCS expression
+ * @return -#CCS_INVALID_VALUE if \p expression_ret is NULL
+ * @return -#CCS_OUT_OF_MEMORY if there was not enough memory to allocate the
+ *                             new expressions
+ */
+extern ccs_result_t
+ccs_expression_simplify(ccs_expression_t  expression,
+                        ccs_expression_t *expression_ret);
 #ifdef __cplusplus
 }
 #endif
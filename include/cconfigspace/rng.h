@@ -13,6 +13,15 @@ extern "C" {
  * random number generators.
  */
 
+/**
+ * A counter based gsl random number generator type, Philox4x32-10 (see Salmon
+ * et al., "Parallel random numbers: as easy as 1, 2, 3"), that can be used
+ * with ccs_rng_create_with_type. The seed is used as the key of the
+ * generator. ccs_rng_uniform_fill generates its values by blocks, which is
+ * much faster than one value at a time.
+ */
+extern const gsl_rng_type *ccs_rng_philox4x32_10;
+
 /**
  * Create a new random number generator using the gsl default type (see
  * gsl_rng_default).
@@ -68,6 +77,53 @@ extern ccs_result_t
 ccs_rng_set_seed(ccs_rng_t         rng,
                  unsigned long int seed);
 
+/**
+ * Get the state of a random number generator, as a binary blob that can be
+ * given to ccs_rng_set_state to resume the random number generator, or a
+ * random number generator of the same type, exactly where it was. The blob
+ * contains the name of the gsl type of the random number generator followed
+ * by the gsl state. It is only portable between builds sharing the same
+ * architecture and gsl version.
+ * @param [in] rng
+ * @param [in] state_size the size of the \p state buffer, in bytes
+ * @param [out] state a buffer of \p state_size bytes that will contain the
+ *                    state, or NULL
+ * @param [out] state_size_ret a pointer to a variable that will contain the
+ *                             size of the state in bytes, or NULL
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p rng is not a valid CCS random number
+ *                              generator
+ * @return -#CCS_INVALID_VALUE if \p state is NULL and \p state_size is
+ *                             greater than 0; or if \p state is NULL and \p
+ *                             state_size_ret is NULL; or if \p state is not
+ *                             NULL and \p state_size is less than the size of
+ *                             the state
+ */
+extern ccs_result_t
+ccs_rng_get_state(ccs_rng_t  rng,
+                  size_t     state_size,
+                  void      *state,
+                  size_t    *state_size_ret);
+
+/**
+ * Restore the state of a random number generator from a binary blob returned
+ * by ccs_rng_get_state.
+ * @param [in,out] rng
+ * @param [in] state_size the size of the \p state buffer, in bytes
+ * @param [in] state the state to restore
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p rng is not a valid CCS random number
+ *                              generator
+ * @return -#CCS_INVALID_VALUE if \p state is NULL; or if \p state is not the
+ *                             state of a random number generator of the same
+ *                             type as \p rng; or if \p state is not a valid
+ *                             #ccs_rng_philox4x32_10 state
+ */
+extern ccs_result_t
+ccs_rng_set_state(ccs_rng_t   rng,
+                  size_t      state_size,
+                  const void *state);
+
 /**
  * Get a random integer from a random number generator. Integer is contained
  * between the value returned by #ccs_rng_min and #ccs_rng_max, both included.
@@ -98,6 +154,63 @@ extern ccs_result_t
 ccs_rng_uniform(ccs_rng_t    rng,
                 ccs_float_t *value_ret);
 
+/**
+ * Get random floating point values uniformly sampled in the interval [0.0,
+ * 1.0). The values are the ones that successive calls to ccs_rng_uniform
+ * would return.
+ * @param [in] rng
+ * @param [in] num_values the number of values to generate
+ * @param [out] values an array of \p num_values floating point values that
+ *                     will contain the returned values
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p rng is not a valid CCS random number
+ *                              generator
+ * @return -#CCS_INVALID_VALUE if \p values is NULL and \p num_values is
+ *                             greater than 0
+ */
+extern ccs_result_t
+ccs_rng_uniform_fill(ccs_rng_t    rng,
+                     size_t       num_values,
+                     ccs_float_t *values);
+
+/**
+ * Advance a random number generator, as if \p num_values values had been
+ * obtained from it with ccs_rng_get. For #ccs_rng_philox4x32_10 generators
+ * the cost does not depend on \p num_values.
+ * @param [in,out] rng
+ * @param [in] num_values the number of values to skip
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p rng is not a valid CCS random number
+ *                              generator
+ */
+extern ccs_result_t
+ccs_rng_jump(ccs_rng_t rng,
+             uint64_t  num_values);
+
+/**
+ * Create child random number generators of the same type as a parent random
+ * number generator, for instance to give one to each worker of a parallel
+ * computation. The seeds of the children are derived from two values obtained
+ * from the parent, so that they are reproducible given the state of the
+ * parent, and distinct from each other. #ccs_rng_philox4x32_10 children use
+ * their seed as key, and thus generate independent streams.
+ * @param [in,out] rng
+ * @param [in] num_children the number of children to create
+ * @param [out] children an array of \p num_children random number generators
+ *                       that will contain the new random number generators
+ * @return #CCS_SUCCESS on success
+ * @return -#CCS_INVALID_OBJECT if \p rng is not a valid CCS random number
+ *                              generator
+ * @return -#CCS_INVALID_VALUE if \p children is NULL and \p num_children is
+ *                             greater than 0
+ * @return -#CCS_OUT_OF_MEMORY if there was not enough memory to allocate the
+ *                             new random number generators
+ */
+extern ccs_result_t
+ccs_rng_split(ccs_rng_t  rng,
+              size_t     num_children,
+              ccs_rng_t *children);
+
 /**
  * Get the underlying gsl random number generator.
  * @param [in] rng
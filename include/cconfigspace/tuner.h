@@ -218,7 +218,9 @@ ccs_tuner_get_history(ccs_tuner_t       tuner,
 
 /**
  * Create a new random tuner. The random tuner should be viewed as a baseline
- * for evaluating tuners, and as a tool for developing interfaces.
+ * for evaluating tuners, and as a tool for developing interfaces. If the
+ * configuration space samples unique configurations, the configurations of
+ * the evaluations told to the tuner are excluded from sampling.
  * @param[in] name the name of the tuner
  * @param[in] configuration_space the configuration space to explore
  * @param[in] objective_space the objective space to potimize
@@ -121,28 +121,33 @@ _ccs_binding_hash(_ccs_binding_data_t *data,
 	return CCS_SUCCESS;
 }
 
+static inline int
+_ccs_binding_data_cmp(_ccs_binding_data_t *data,
+                      _ccs_binding_data_t *other_data) {
+	int cmp;
+	if (data == other_data)
+		return 0;
+	cmp = data->context < other_data->context ? -1 :
+	      data->context > other_data->context ?  1 : 0;
+	if (cmp)
+		return cmp;
+	cmp = data->num_values < other_data->num_values ? -1 :
+	      data->num_values > other_data->num_values ?  1 : 0;
+	if (cmp)
+		return cmp;
+	for (size_t i = 0; i < data->num_values; i++) {
+		if ( (cmp = _datum_cmp(data->values + i, other_data->values + i)) )
+			return cmp;
+	}
+	return 0;
+}
+
 static inline ccs_result_t
 _ccs_binding_cmp(_ccs_binding_data_t  *data,
                  ccs_binding_t         other_binding,
                  int                  *cmp_ret) {
 	CCS_CHECK_PTR(cmp_ret);
-	_ccs_binding_data_t *other_data = other_binding->data;
-	if (data == other_data) {
-		*cmp_ret = 0;
-		return CCS_SUCCESS;
-	}
-	*cmp_ret = data->context < other_data->context ? -1 :
-	           data->context > other_data->context ?  1 : 0;
-	if (*cmp_ret)
-		return CCS_SUCCESS;
-	*cmp_ret = data->num_values < other_data->num_values ? -1 :
-	           data->num_values > other_data->num_values ?  1 : 0;
-	if (*cmp_ret)
-		return CCS_SUCCESS;
-	for (size_t i = 0; i < data->num_values; i++) {
-		if ( (*cmp_ret = _datum_cmp(data->values + i, other_data->values + i)) )
-			return CCS_SUCCESS;
-	}
+	*cmp_ret = _ccs_binding_data_cmp(data, other_binding->data);
 	return CCS_SUCCESS;
 }
 
@@ -49,7 +49,15 @@ ccs_release_object(ccs_object_t object) {
 			utarray_free(obj->callbacks);
 		}
 		CCS_VALIDATE(obj->ops->del(object));
-		free(object);
+		if (obj->slab) {
+			_ccs_object_slab_t *slab = obj->slab;
+			slab->refcount -= 1;
+			if (slab->refcount == 0) {
+				CCS_VALIDATE(slab->del(slab));
+				free(slab);
+			}
+		} else
+			free(object);
 	}
 	return CCS_SUCCESS;
 }
@@ -69,11 +69,23 @@ struct _ccs_object_callback_s {
 };
 typedef struct _ccs_object_callback_s _ccs_object_callback_t;
 
+// Objects allocated together in a single block share a slab. The block is
+// freed, and the slab del callback called, once every object in the slab has
+// been destroyed.
+struct _ccs_object_slab_s;
+typedef struct _ccs_object_slab_s _ccs_object_slab_t;
+
+struct _ccs_object_slab_s {
+	int32_t        refcount;
+	ccs_result_t (*del)(_ccs_object_slab_t *slab);
+};
+
 struct _ccs_object_internal_s {
 	ccs_object_type_t              type;
 	int32_t                        refcount;
 	UT_array                      *callbacks;
 	_ccs_object_ops_t             *ops;
+	_ccs_object_slab_t            *slab;
 };
 
 typedef struct _ccs_object_internal_s _ccs_object_internal_t;
@@ -92,6 +104,16 @@ _ccs_object_init(_ccs_object_internal_t *o,
 	o->refcount = 1;
 	o->callbacks = NULL;
 	o->ops = ops;
+	o->slab = NULL;
+}
+
+static inline __attribute__((always_inline)) void
+_ccs_object_init_slab(_ccs_object_internal_t *o,
+                      ccs_object_type_t       t,
+                      _ccs_object_ops_t      *ops,
+                      _ccs_object_slab_t     *slab) {
+	_ccs_object_init(o, t, ops);
+	o->slab = slab;
 }
 
 #endif //_CONFIGSPACE_INTERNAL_H
@@ -32,6 +32,31 @@ static _ccs_configuration_ops_t _configuration_ops =
       &_ccs_configuration_hash,
       &_ccs_configuration_cmp };
 
+// Configurations allocated by ccs_create_configurations share the reference
+// to their configuration space, which is released with the slab.
+static ccs_result_t
+_ccs_configuration_slab_member_del(ccs_object_t object) {
+	(void)object;
+	return CCS_SUCCESS;
+}
+
+static _ccs_configuration_ops_t _configuration_slab_ops =
+    { {&_ccs_configuration_slab_member_del},
+      &_ccs_configuration_hash,
+      &_ccs_configuration_cmp };
+
+struct _ccs_configuration_slab_s {
+	_ccs_object_slab_t        slab;
+	ccs_configuration_space_t configuration_space;
+};
+typedef struct _ccs_configuration_slab_s _ccs_configuration_slab_t;
+
+static ccs_result_t
+_ccs_configuration_slab_del(_ccs_object_slab_t *slab) {
+	ccs_release_object(((_ccs_configuration_slab_t *)slab)->configuration_space);
+	return CCS_SUCCESS;
+}
+
 ccs_result_t
 ccs_create_configuration(ccs_configuration_space_t configuration_space,
                          size_t                    num_values,
@@ -75,6 +100,75 @@ errmem:
 	return err;
 }
 
+ccs_result_t
+ccs_create_configurations(ccs_configuration_space_t  configuration_space,
+                          size_t                     num_configurations,
+                          size_t                     num_values,
+                          ccs_datum_t               *values,
+                          void                      *user_data,
+                          ccs_configuration_t       *configurations) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	CCS_CHECK_ARY(num_configurations, configurations);
+	CCS_CHECK_ARY(num_values, values);
+	if (!num_configurations)
+		return CCS_SUCCESS;
+	ccs_result_t err;
+	size_t num;
+	CCS_VALIDATE(ccs_configuration_space_get_num_hyperparameters(configuration_space, &num));
+	if (values && num != num_values)
+		return -CCS_INVALID_VALUE;
+	if (num > (SIZE_MAX - sizeof(struct _ccs_configuration_s) -
+	           sizeof(struct _ccs_configuration_data_s)) / sizeof(ccs_datum_t))
+		return -CCS_OUT_OF_MEMORY;
+	size_t per_configuration = sizeof(struct _ccs_configuration_s) +
+	                           sizeof(struct _ccs_configuration_data_s) +
+	                           num * sizeof(ccs_datum_t);
+	if (num_configurations > (SIZE_MAX - sizeof(_ccs_configuration_slab_t)) /
+	                         per_configuration)
+		return -CCS_OUT_OF_MEMORY;
+	// The slab reference count is an int32_t
+	if (num_configurations > INT32_MAX)
+		return -CCS_INVALID_VALUE;
+	uintptr_t mem = (uintptr_t)calloc(1, sizeof(_ccs_configuration_slab_t) +
+	                                     num_configurations * per_configuration);
+	if (!mem)
+		return -CCS_OUT_OF_MEMORY;
+	_ccs_configuration_slab_t *slab = (_ccs_configuration_slab_t *)mem;
+	struct _ccs_configuration_s *configs =
+		(struct _ccs_configuration_s *)(mem + sizeof(_ccs_configuration_slab_t));
+	struct _ccs_configuration_data_s *datas =
+		(struct _ccs_configuration_data_s *)(configs + num_configurations);
+	ccs_datum_t *vals = (ccs_datum_t *)(datas + num_configurations);
+	if (values) {
+		memcpy(vals, values, num_configurations * num * sizeof(ccs_datum_t));
+		for (size_t i = 0; i < num_configurations * num; i++)
+			if (values[i].flags & CCS_FLAG_TRANSIENT)
+				CCS_VALIDATE_ERR_GOTO(err, ccs_configuration_space_validate_value(
+					configuration_space, i % num, values[i],
+					vals + i), errmem);
+	}
+	CCS_VALIDATE_ERR_GOTO(err, ccs_retain_object(configuration_space), errmem);
+	slab->slab.refcount = (int32_t)num_configurations;
+	slab->slab.del = &_ccs_configuration_slab_del;
+	slab->configuration_space = configuration_space;
+	for (size_t i = 0; i < num_configurations; i++) {
+		ccs_configuration_t config = configs + i;
+		_ccs_object_init_slab(&(config->obj), CCS_CONFIGURATION,
+		                      (_ccs_object_ops_t*)&_configuration_slab_ops,
+		                      &(slab->slab));
+		config->data = datas + i;
+		config->data->user_data = user_data;
+		config->data->num_values = num;
+		config->data->configuration_space = configuration_space;
+		config->data->values = vals + i * num;
+		configurations[i] = config;
+	}
+	return CCS_SUCCESS;
+errmem:
+	free((void*)mem);
+	return err;
+}
+
 ccs_result_t
 ccs_configuration_get_configuration_space(ccs_configuration_t        configuration,
                                           ccs_configuration_space_t *configuration_space_ret) {
@@ -0,0 +1,237 @@
+#include "cconfigspace_internal.h"
+#include "configuration_batch_internal.h"
+#include "configuration_internal.h"
+#include "hyperparameter_internal.h"
+#include <string.h>
+#include <math.h>
+
+static ccs_result_t
+_ccs_configuration_batch_del(ccs_object_t object) {
+	ccs_configuration_batch_t configuration_batch =
+		(ccs_configuration_batch_t)object;
+	ccs_release_object(configuration_batch->data->configuration_space);
+	return CCS_SUCCESS;
+}
+
+static _ccs_configuration_batch_ops_t _configuration_batch_ops =
+    { {&_ccs_configuration_batch_del} };
+
+static ccs_result_t
+_fill_column(_ccs_configuration_batch_column_t *column,
+             size_t                             index,
+             size_t                             num_configurations,
+             ccs_configuration_t               *configurations) {
+	for (size_t i = 0; i < num_configurations; i++) {
+		ccs_datum_t *value = configurations[i]->data->values + index;
+		if (value->type == CCS_INACTIVE) {
+			if (column->data_type == CCS_NUM_FLOAT)
+				column->values[i].f = NAN;
+			continue;
+		}
+		column->actives[i / 64] |= (uint64_t)1 << (i % 64);
+		if (column->categorical) {
+			size_t rank;
+			if (_ccs_categorical_hyperparameter_get_rank(
+					column->hyperparameter, value, &rank))
+				return -CCS_INVALID_CONFIGURATION;
+			column->values[i].i = (ccs_int_t)rank;
+		} else if (column->data_type == CCS_NUM_FLOAT &&
+		           value->type == CCS_FLOAT)
+			column->values[i].f = value->value.f;
+		else if (column->data_type == CCS_NUM_INTEGER &&
+		         value->type == CCS_INTEGER)
+			column->values[i].i = value->value.i;
+		else
+			return -CCS_INVALID_CONFIGURATION;
+	}
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_create_configuration_batch(
+		ccs_configuration_space_t  configuration_space,
+		size_t                     num_configurations,
+		ccs_configuration_t       *configurations,
+		void                      *user_data,
+		ccs_configuration_batch_t *configuration_batch_ret) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	CCS_CHECK_ARY(num_configurations, configurations);
+	CCS_CHECK_PTR(configuration_batch_ret);
+	for (size_t i = 0; i < num_configurations; i++) {
+		CCS_CHECK_OBJ(configurations[i], CCS_CONFIGURATION);
+		if (configurations[i]->data->configuration_space != configuration_space)
+			return -CCS_INVALID_CONFIGURATION;
+	}
+	ccs_result_t err;
+	size_t num_columns;
+	CCS_VALIDATE(ccs_configuration_space_get_num_hyperparameters(
+		configuration_space, &num_columns));
+	size_t header = sizeof(struct _ccs_configuration_batch_s) +
+	                sizeof(struct _ccs_configuration_batch_data_s);
+	if (num_configurations > (SIZE_MAX - sizeof(_ccs_configuration_batch_column_t)) /
+	                         (sizeof(ccs_numeric_t) + sizeof(uint64_t)))
+		return -CCS_OUT_OF_MEMORY;
+	size_t num_words = (num_configurations + 63) / 64;
+	size_t per_column = sizeof(_ccs_configuration_batch_column_t) +
+	                    num_configurations * sizeof(ccs_numeric_t) +
+	                    num_words * sizeof(uint64_t);
+	if (num_columns && num_columns > (SIZE_MAX - header) / per_column)
+		return -CCS_OUT_OF_MEMORY;
+	uintptr_t mem = (uintptr_t)calloc(1, header + num_columns * per_column);
+	if (!mem)
+		return -CCS_OUT_OF_MEMORY;
+	ccs_configuration_batch_t batch = (ccs_configuration_batch_t)mem;
+	_ccs_object_init(&(batch->obj), CCS_CONFIGURATION_BATCH,
+	                 (_ccs_object_ops_t *)&_configuration_batch_ops);
+	batch->data = (struct _ccs_configuration_batch_data_s *)(mem +
+		sizeof(struct _ccs_configuration_batch_s));
+	batch->data->user_data = user_data;
+	batch->data->configuration_space = configuration_space;
+	batch->data->num_configurations = num_configurations;
+	batch->data->num_columns = num_columns;
+	batch->data->columns = (_ccs_configuration_batch_column_t *)(mem +
+		sizeof(struct _ccs_configuration_batch_s) +
+		sizeof(struct _ccs_configuration_batch_data_s));
+	ccs_numeric_t *values = (ccs_numeric_t *)(batch->data->columns + num_columns);
+	uint64_t *actives = (uint64_t *)(values + num_columns * num_configurations);
+	for (size_t j = 0; j < num_columns; j++) {
+		_ccs_configuration_batch_column_t *column = batch->data->columns + j;
+		ccs_hyperparameter_type_t type;
+		CCS_VALIDATE_ERR_GOTO(err, ccs_configuration_space_get_hyperparameter(
+			configuration_space, j, &column->hyperparameter), errmem);
+		CCS_VALIDATE_ERR_GOTO(err, ccs_hyperparameter_get_type(
+			column->hyperparameter, &type), errmem);
+		if (type == CCS_HYPERPARAMETER_TYPE_NUMERICAL)
+			CCS_VALIDATE_ERR_GOTO(err,
+				ccs_numerical_hyperparameter_get_parameters(
+					column->hyperparameter, &column->data_type,
+					NULL, NULL, NULL), errmem);
+		else {
+			column->categorical = 1;
+			column->data_type = CCS_NUM_INTEGER;
+		}
+		column->values = values + j * num_configurations;
+		column->actives = actives + j * num_words;
+		CCS_VALIDATE_ERR_GOTO(err, _fill_column(column, j, num_configurations,
+		                                        configurations), errmem);
+	}
+	CCS_VALIDATE_ERR_GOTO(err, ccs_retain_object(configuration_space), errmem);
+	*configuration_batch_ret = batch;
+	return CCS_SUCCESS;
+errmem:
+	free((void *)mem);
+	return err;
+}
+
+ccs_result_t
+ccs_configuration_batch_get_configuration_space(
+		ccs_configuration_batch_t  configuration_batch,
+		ccs_configuration_space_t *configuration_space_ret) {
+	CCS_CHECK_OBJ(configuration_batch, CCS_CONFIGURATION_BATCH);
+	CCS_CHECK_PTR(configuration_space_ret);
+	*configuration_space_ret = configuration_batch->data->configuration_space;
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_configuration_batch_get_user_data(
+		ccs_configuration_batch_t   configuration_batch,
+		void                      **user_data_ret) {
+	CCS_CHECK_OBJ(configuration_batch, CCS_CONFIGURATION_BATCH);
+	CCS_CHECK_PTR(user_data_ret);
+	*user_data_ret = configuration_batch->data->user_data;
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_configuration_batch_get_num_configurations(
+		ccs_configuration_batch_t  configuration_batch,
+		size_t                    *num_configurations_ret) {
+	CCS_CHECK_OBJ(configuration_batch, CCS_CONFIGURATION_BATCH);
+	CCS_CHECK_PTR(num_configurations_ret);
+	*num_configurations_ret = configuration_batch->data->num_configurations;
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_configuration_batch_get_column(
+		ccs_configuration_batch_t   configuration_batch,
+		size_t                      index,
+		ccs_numeric_type_t         *data_type_ret,
+		ccs_numeric_t             **values_ret,
+		uint64_t                  **actives_ret) {
+	CCS_CHECK_OBJ(configuration_batch, CCS_CONFIGURATION_BATCH);
+	if (index >= configuration_batch->data->num_columns)
+		return -CCS_OUT_OF_BOUNDS;
+	_ccs_configuration_batch_column_t *column =
+		configuration_batch->data->columns + index;
+	if (data_type_ret)
+		*data_type_ret = column->data_type;
+	if (values_ret)
+		*values_ret = column->values;
+	if (actives_ret)
+		*actives_ret = column->actives;
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_configuration_batch_get_configurations(
+		ccs_configuration_batch_t  configuration_batch,
+		size_t                     num_configurations,
+		ccs_configuration_t       *configurations,
+		size_t                    *num_configurations_ret) {
+	CCS_CHECK_OBJ(configuration_batch, CCS_CONFIGURATION_BATCH);
+	CCS_CHECK_ARY(num_configurations, configurations);
+	if (!configurations && !num_configurations_ret)
+		return -CCS_INVALID_VALUE;
+	_ccs_configuration_batch_data_t *data = configuration_batch->data;
+	size_t num = data->num_configurations;
+	size_t num_columns = data->num_columns;
+	if (configurations && num) {
+		if (num_configurations < num)
+			return -CCS_INVALID_VALUE;
+		ccs_result_t err = CCS_SUCCESS;
+		ccs_datum_t *values = NULL;
+		if (num_columns) {
+			values = (ccs_datum_t *)malloc(
+				num * num_columns * sizeof(ccs_datum_t));
+			if (!values)
+				return -CCS_OUT_OF_MEMORY;
+		}
+		for (size_t j = 0; j < num_columns; j++) {
+			_ccs_configuration_batch_column_t *column = data->columns + j;
+			size_t num_values = column->categorical ?
+				_ccs_categorical_hyperparameter_get_num_values(
+					column->hyperparameter) : 0;
+			for (size_t i = 0; i < num; i++) {
+				ccs_datum_t *value = values + i * num_columns + j;
+				if (!((column->actives[i / 64] >> (i % 64)) & 1))
+					*value = ccs_inactive;
+				else if (column->categorical) {
+					ccs_int_t rank = column->values[i].i;
+					if (rank < 0 || (size_t)rank >= num_values) {
+						err = -CCS_INVALID_CONFIGURATION;
+						goto end;
+					}
+					*value = _ccs_categorical_hyperparameter_get_value(
+						column->hyperparameter, (size_t)rank);
+				} else if (column->data_type == CCS_NUM_FLOAT)
+					*value = ccs_float(column->values[i].f);
+				else
+					*value = ccs_int(column->values[i].i);
+			}
+		}
+		err = ccs_create_configurations(data->configuration_space, num,
+			num_columns, values, NULL, configurations);
+end:
+		if (values)
+			free(values);
+		CCS_VALIDATE(err);
+	}
+	if (configurations)
+		for (size_t i = num; i < num_configurations; i++)
+			configurations[i] = NULL;
+	if (num_configurations_ret)
+		*num_configurations_ret = num;
+	return CCS_SUCCESS;
+}
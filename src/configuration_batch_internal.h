@@ -0,0 +1,36 @@
+#ifndef _CONFIGURATION_BATCH_INTERNAL_H
+#define _CONFIGURATION_BATCH_INTERNAL_H
+
+struct _ccs_configuration_batch_data_s;
+typedef struct _ccs_configuration_batch_data_s _ccs_configuration_batch_data_t;
+
+struct _ccs_configuration_batch_ops_s {
+	_ccs_object_ops_t obj_ops;
+};
+typedef struct _ccs_configuration_batch_ops_s _ccs_configuration_batch_ops_t;
+
+struct _ccs_configuration_batch_s {
+	_ccs_object_internal_t           obj;
+	_ccs_configuration_batch_data_t *data;
+};
+
+// The column of a hyperparameter. categorical is set for categorical, ordinal
+// and discrete hyperparameters, whose values are stored by index.
+struct _ccs_configuration_batch_column_s {
+	ccs_hyperparameter_t  hyperparameter;
+	int                   categorical;
+	ccs_numeric_type_t    data_type;
+	ccs_numeric_t        *values;
+	uint64_t             *actives;
+};
+typedef struct _ccs_configuration_batch_column_s _ccs_configuration_batch_column_t;
+
+struct _ccs_configuration_batch_data_s {
+	void                              *user_data;
+	ccs_configuration_space_t          configuration_space;
+	size_t                             num_configurations;
+	size_t                             num_columns;
+	_ccs_configuration_batch_column_t *columns;
+};
+
+#endif //_CONFIGURATION_BATCH_INTERNAL_H
@@ -1,10 +1,31 @@
 #include "cconfigspace_internal.h"
 #include "configuration_space_internal.h"
 #include "configuration_internal.h"
+#include "expression_internal.h"
+#include "hyperparameter_internal.h"
+#include "distribution_internal.h"
+#include "rng_internal.h"
 #include "utlist.h"
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// The values of a sampled configuration follow its entry.
+struct _ccs_sampled_configuration_s {
+	_ccs_binding_data_t data;
+	UT_hash_handle      hh;
+};
 
-static ccs_result_t
-_generate_constraints(ccs_configuration_space_t configuration_space);
+static void
+_forget_sampled_configurations(_ccs_configuration_space_data_t *data) {
+	_ccs_sampled_configuration_t *entry, *tmp;
+	HASH_ITER(hh, data->sampled_configurations, entry, tmp) {
+		HASH_DELETE(hh, data->sampled_configurations, entry);
+		free(entry);
+	}
+	data->num_distinct_ok = 0;
+}
 
 static ccs_result_t
 _ccs_configuration_space_del(ccs_object_t object) {
@@ -32,6 +53,17 @@ _ccs_configuration_space_del(ccs_object_t object) {
 	utarray_free(configuration_space->data->hyperparameters);
 	utarray_free(configuration_space->data->forbidden_clauses);
 	utarray_free(configuration_space->data->sorted_indexes);
+	utarray_free(configuration_space->data->activation_plan);
+	utarray_free(configuration_space->data->forbidden_plan);
+	utarray_free(configuration_space->data->forbidden_requirements);
+	utarray_free(configuration_space->data->table_variables);
+	utarray_free(configuration_space->data->tables);
+	utarray_free(configuration_space->data->constraints_code);
+	utarray_free(configuration_space->data->restrictions);
+	utarray_free(configuration_space->data->restriction_variables);
+	utarray_free(configuration_space->data->restriction_steps);
+	utarray_free(configuration_space->data->restriction_cells);
+	utarray_free(configuration_space->data->restriction_masses);
 	_ccs_distribution_wrapper_t *dw, *tmp;
 	DL_FOREACH_SAFE(configuration_space->data->distribution_list, dw, tmp) {
 		DL_DELETE(configuration_space->data->distribution_list, dw);
@@ -39,6 +71,9 @@ _ccs_configuration_space_del(ccs_object_t object) {
 		free(dw);
 	}
 	ccs_release_object(configuration_space->data->rng);
+	if (configuration_space->data->sequence_data)
+		free(configuration_space->data->sequence_data);
+	_forget_sampled_configurations(configuration_space->data);
 	return CCS_SUCCESS;
 }
 
@@ -66,6 +101,69 @@ static UT_icd _size_t_icd = {
 	NULL
 };
 
+static const UT_icd _activation_step_icd = {
+	sizeof(_ccs_activation_step_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+static const UT_icd _forbidden_step_icd = {
+	sizeof(_ccs_forbidden_step_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+static const UT_icd _table_variable_icd = {
+	sizeof(_ccs_table_variable_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+static const UT_icd _uint64_icd = {
+	sizeof(uint64_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+static const UT_icd _instruction_icd = {
+	sizeof(_ccs_expression_instruction_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+static const UT_icd _restriction_icd = {
+	sizeof(_ccs_restriction_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+static const UT_icd _restriction_variable_icd = {
+	sizeof(_ccs_restriction_variable_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+static const UT_icd _interval_icd = {
+	sizeof(ccs_interval_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+static const UT_icd _float_icd = {
+	sizeof(ccs_float_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
 #undef  utarray_oom
 #define utarray_oom() { \
 	ccs_release_object(config_space->data->rng); \
@@ -106,7 +204,19 @@ ccs_create_configuration_space(const char                *name,
 	utarray_new(config_space->data->forbidden_clauses,
 	            &_forbidden_clauses_icd);
 	utarray_new(config_space->data->sorted_indexes, &_size_t_icd);
-	config_space->data->graph_ok = CCS_TRUE;
+	utarray_new(config_space->data->activation_plan, &_activation_step_icd);
+	utarray_new(config_space->data->forbidden_plan, &_forbidden_step_icd);
+	utarray_new(config_space->data->forbidden_requirements, &_size_t_icd);
+	utarray_new(config_space->data->table_variables,
+	            &_table_variable_icd);
+	utarray_new(config_space->data->tables, &_uint64_icd);
+	utarray_new(config_space->data->constraints_code, &_instruction_icd);
+	utarray_new(config_space->data->restrictions, &_restriction_icd);
+	utarray_new(config_space->data->restriction_variables,
+	            &_restriction_variable_icd);
+	utarray_new(config_space->data->restriction_steps, &_forbidden_step_icd);
+	utarray_new(config_space->data->restriction_cells, &_interval_icd);
+	utarray_new(config_space->data->restriction_masses, &_float_icd);
 	strcpy((char *)(config_space->data->name), name);
 	*configuration_space_ret = config_space;
 	return CCS_SUCCESS;
@@ -117,6 +227,28 @@ errarrays:
 		utarray_free(config_space->data->forbidden_clauses);
 	if (config_space->data->sorted_indexes)
 		utarray_free(config_space->data->sorted_indexes);
+	if (config_space->data->activation_plan)
+		utarray_free(config_space->data->activation_plan);
+	if (config_space->data->forbidden_plan)
+		utarray_free(config_space->data->forbidden_plan);
+	if (config_space->data->forbidden_requirements)
+		utarray_free(config_space->data->forbidden_requirements);
+	if (config_space->data->table_variables)
+		utarray_free(config_space->data->table_variables);
+	if (config_space->data->tables)
+		utarray_free(config_space->data->tables);
+	if (config_space->data->constraints_code)
+		utarray_free(config_space->data->constraints_code);
+	if (config_space->data->restrictions)
+		utarray_free(config_space->data->restrictions);
+	if (config_space->data->restriction_variables)
+		utarray_free(config_space->data->restriction_variables);
+	if (config_space->data->restriction_steps)
+		utarray_free(config_space->data->restriction_steps);
+	if (config_space->data->restriction_cells)
+		utarray_free(config_space->data->restriction_cells);
+	if (config_space->data->restriction_masses)
+		utarray_free(config_space->data->restriction_masses);
 errmem:
 	free((void *)mem);
 	return err;
@@ -144,6 +276,7 @@ ccs_configuration_space_set_rng(ccs_configuration_space_t configuration_space,
 	CCS_VALIDATE(ccs_retain_object(rng));
 	ccs_rng_t tmp = configuration_space->data->rng;
 	configuration_space->data->rng = rng;
+	configuration_space->data->sequence_dimension = 0;
 	CCS_VALIDATE(ccs_release_object(tmp));
 	return CCS_SUCCESS;
 }
@@ -157,6 +290,71 @@ ccs_configuration_space_get_rng(ccs_configuration_space_t  configuration_space,
 	return CCS_SUCCESS;
 }
 
+ccs_result_t
+ccs_configuration_space_set_lazy_sampling(
+		ccs_configuration_space_t configuration_space,
+		ccs_bool_t                lazy_sampling) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	configuration_space->data->lazy_sampling = lazy_sampling ? 1 : 0;
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_configuration_space_get_lazy_sampling(
+		ccs_configuration_space_t  configuration_space,
+		ccs_bool_t                *lazy_sampling_ret) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	CCS_CHECK_PTR(lazy_sampling_ret);
+	*lazy_sampling_ret =
+		configuration_space->data->lazy_sampling ? CCS_TRUE : CCS_FALSE;
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_configuration_space_set_sampling_method(
+		ccs_configuration_space_t configuration_space,
+		ccs_sampling_method_t     sampling_method) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	if (sampling_method < CCS_SAMPLING_RANDOM ||
+	    sampling_method >= CCS_SAMPLING_METHOD_MAX)
+		return -CCS_INVALID_VALUE;
+	configuration_space->data->sampling_method = sampling_method;
+	configuration_space->data->sequence_dimension = 0;
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_configuration_space_get_sampling_method(
+		ccs_configuration_space_t  configuration_space,
+		ccs_sampling_method_t     *sampling_method_ret) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	CCS_CHECK_PTR(sampling_method_ret);
+	*sampling_method_ret = configuration_space->data->sampling_method;
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_configuration_space_set_unique_sampling(
+		ccs_configuration_space_t configuration_space,
+		ccs_bool_t                unique_sampling) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	if (!unique_sampling)
+		_forget_sampled_configurations(configuration_space->data);
+	configuration_space->data->unique_sampling = unique_sampling ? 1 : 0;
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_configuration_space_get_unique_sampling(
+		ccs_configuration_space_t  configuration_space,
+		ccs_bool_t                *unique_sampling_ret) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	CCS_CHECK_PTR(unique_sampling_ret);
+	*unique_sampling_ret =
+		configuration_space->data->unique_sampling ? CCS_TRUE : CCS_FALSE;
+	return CCS_SUCCESS;
+}
+
 
 #undef  utarray_oom
 #define utarray_oom() { \
@@ -239,22 +437,41 @@ ccs_configuration_space_add_hyperparameter(ccs_configuration_space_t configurati
 	hyper_wrapper.distribution_index = 0;
 	hyper_wrapper.distribution = distrib_wrapper;
 	hyper_wrapper.condition = NULL;
+	hyper_wrapper.rank = utarray_len(configuration_space->data->sorted_indexes);
+	hyper_wrapper.mark = 0;
 	hyper_wrapper.parents = NULL;
 	hyper_wrapper.children = NULL;
+	hyper_wrapper.restriction = SIZE_MAX;
 	utarray_new(hyper_wrapper.parents, &_size_t_icd);
 	utarray_new(hyper_wrapper.children, &_size_t_icd);
 
 	utarray_push_back(hyperparameters, &hyper_wrapper);
+#undef  utarray_oom
+#define utarray_oom() { \
+	err = -CCS_OUT_OF_MEMORY; \
+	goto errorhyperparameters; \
+}
 	utarray_push_back(configuration_space->data->sorted_indexes, &index);
 
 	HASH_ADD_KEYPTR( hh_name, configuration_space->data->name_hash,
 	                 hyper_hash->name, sz_name, hyper_hash );
+#undef uthash_nonfatal_oom
+#define uthash_nonfatal_oom(elt) { \
+	err = -CCS_OUT_OF_MEMORY; \
+	goto errorname_hash; \
+}
 	HASH_ADD( hh_handle, configuration_space->data->handle_hash,
 	          hyperparameter, sizeof(ccs_hyperparameter_t), hyper_hash );
 	DL_APPEND( configuration_space->data->distribution_list, distrib_wrapper );
+	_forget_sampled_configurations(configuration_space->data);
+	configuration_space->data->restrictions_ok = 0;
 
 	return CCS_SUCCESS;
+errorname_hash:
+	HASH_DELETE(hh_name, configuration_space->data->name_hash, hyper_hash);
 errorutarray:
+	utarray_pop_back(configuration_space->data->sorted_indexes);
+errorhyperparameters:
 	utarray_pop_back(hyperparameters);
 errordistrib_wrapper:
 	if (hyper_hash)
@@ -392,6 +609,8 @@ ccs_configuration_space_set_distribution(ccs_configuration_space_t  configuratio
 	}
 
 	free((void *)mem);
+	configuration_space->data->num_distinct_ok = 0;
+	configuration_space->data->restrictions_ok = 0;
 	return CCS_SUCCESS;
 dwrappers:
 	for (size_t i = 0; i < to_add_count; i++) {
@@ -524,32 +743,293 @@ ccs_configuration_space_validate_value(ccs_configuration_space_t  configuration_
 	                                   index, value, value_ret);
 }
 
+// Largest number of entries of a constraint table
+#define CCS_TABLE_MAX_SIZE 4096
+
+#undef  utarray_oom
+#define utarray_oom() { \
+	err = -CCS_OUT_OF_MEMORY; \
+	goto end; \
+}
+// Tabulates the constraint expression compiled at offset in the constraints
+// code, if it only references categorical, ordinal or discrete
+// hyperparameters with few values, by running its program on every
+// combination of their values. Constraints that fail to evaluate on one of
+// the combinations are left untabulated, so that the error is reported.
+static ccs_result_t
+_tabulate_constraint(ccs_configuration_space_t  configuration_space,
+                     ccs_expression_t           expression,
+                     size_t                     offset,
+                     size_t                     stack_size,
+                     _ccs_constraint_table_t   *table_ret) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	ccs_result_t err = CCS_SUCCESS;
+	size_t num_variables, size = 1;
+	ccs_hyperparameter_t *hyperparameters = NULL;
+	_ccs_table_variable_t *variables = NULL;
+	ccs_datum_t *values = NULL;
+	ccs_datum_t *stack = NULL;
+	size_t *ranks = NULL;
+	uint64_t *bits = NULL;
+	_ccs_expression_instruction_t *code;
+	size_t num_words;
+	table_ret->num_variables = 0;
+	CCS_VALIDATE(ccs_expression_get_hyperparameters(expression, 0, NULL,
+	                                                &num_variables));
+	if (!num_variables)
+		return CCS_SUCCESS;
+	hyperparameters = (ccs_hyperparameter_t *)
+		alloca(num_variables * sizeof(ccs_hyperparameter_t));
+	variables = (_ccs_table_variable_t *)
+		alloca(num_variables * sizeof(_ccs_table_variable_t));
+	ranks = (size_t *)alloca(num_variables * sizeof(size_t));
+	CCS_VALIDATE(ccs_expression_get_hyperparameters(expression, num_variables,
+	                                                hyperparameters, NULL));
+	for (size_t i = 0; i < num_variables; i++) {
+		ccs_hyperparameter_type_t type;
+		CCS_VALIDATE(ccs_hyperparameter_get_type(hyperparameters[i], &type));
+		if (type != CCS_HYPERPARAMETER_TYPE_CATEGORICAL &&
+		    type != CCS_HYPERPARAMETER_TYPE_ORDINAL &&
+		    type != CCS_HYPERPARAMETER_TYPE_DISCRETE)
+			return CCS_SUCCESS;
+		size_t num_values = _ccs_categorical_hyperparameter_get_num_values(
+			hyperparameters[i]) + 1;
+		if (num_values > CCS_TABLE_MAX_SIZE / size)
+			return CCS_SUCCESS;
+		variables[i].hyperparameter = hyperparameters[i];
+		CCS_VALIDATE(ccs_context_get_hyperparameter_index(
+			(ccs_context_t)configuration_space, hyperparameters[i],
+			&variables[i].index));
+		variables[i].stride = size;
+		size *= num_values;
+	}
+	num_words = (size + 63) / 64;
+	values = (ccs_datum_t *)malloc(
+		(utarray_len(data->hyperparameters) + stack_size) * sizeof(ccs_datum_t) +
+		num_words * sizeof(uint64_t));
+	if (!values)
+		return -CCS_OUT_OF_MEMORY;
+	stack = values + utarray_len(data->hyperparameters);
+	bits = (uint64_t *)(stack + stack_size);
+	for (size_t i = 0; i < num_words; i++)
+		bits[i] = 0;
+	for (size_t i = 0; i < utarray_len(data->hyperparameters); i++)
+		values[i] = ccs_inactive;
+	code = (_ccs_expression_instruction_t *)
+		utarray_eltptr(data->constraints_code, offset);
+	for (size_t i = 0; i < num_variables; i++) {
+		ranks[i] = 0;
+		values[variables[i].index] = _ccs_categorical_hyperparameter_get_value(
+			variables[i].hyperparameter, 0);
+	}
+	for (size_t entry = 0; entry < size; entry++) {
+		ccs_datum_t result;
+		err = _ccs_expression_run(code, values, stack, &result);
+		if (err == -CCS_INACTIVE_HYPERPARAMETER)
+			err = CCS_SUCCESS;
+		else if (err) {
+			err = CCS_SUCCESS;
+			goto end;
+		} else if (result.type == CCS_BOOLEAN && result.value.i == CCS_TRUE)
+			bits[entry / 64] |= (uint64_t)1 << (entry % 64);
+		// Increment the ranks, the last rank of each variable is inactive
+		for (size_t i = 0; i < num_variables; i++) {
+			size_t num_values = _ccs_categorical_hyperparameter_get_num_values(
+				variables[i].hyperparameter);
+			if (ranks[i] < num_values) {
+				ranks[i]++;
+				values[variables[i].index] = ranks[i] < num_values ?
+					_ccs_categorical_hyperparameter_get_value(
+						variables[i].hyperparameter, ranks[i]) :
+					ccs_inactive;
+				break;
+			}
+			ranks[i] = 0;
+			values[variables[i].index] = _ccs_categorical_hyperparameter_get_value(
+				variables[i].hyperparameter, 0);
+		}
+	}
+	table_ret->variables = utarray_len(data->table_variables);
+	table_ret->bits = utarray_len(data->tables);
+	utarray_reserve(data->table_variables, num_variables);
+	utarray_reserve(data->tables, num_words);
+	for (size_t i = 0; i < num_variables; i++)
+		utarray_push_back(data->table_variables, variables + i);
+	for (size_t i = 0; i < num_words; i++)
+		utarray_push_back(data->tables, bits + i);
+	table_ret->num_variables = num_variables;
+end:
+	free(values);
+	return err;
+}
+
+// Looks values up in a constraint table. Returns 0 when one of the values is
+// not a possible value of its hyperparameter.
+static inline int
+_lookup_constraint_table(_ccs_configuration_space_data_t *data,
+                         const _ccs_constraint_table_t   *table,
+                         ccs_datum_t                     *values,
+                         ccs_bool_t                      *result) {
+	_ccs_table_variable_t *variables =
+		(_ccs_table_variable_t *)utarray_eltptr(
+			data->table_variables, table->variables);
+	uint64_t *bits = (uint64_t *)utarray_eltptr(data->tables, table->bits);
+	size_t entry = 0;
+	for (size_t i = 0; i < table->num_variables; i++) {
+		size_t rank;
+		if (values[variables[i].index].type == CCS_INACTIVE)
+			rank = _ccs_categorical_hyperparameter_get_num_values(
+				variables[i].hyperparameter);
+		else if (_ccs_categorical_hyperparameter_get_rank(
+				variables[i].hyperparameter, values + variables[i].index,
+				&rank))
+			return 0;
+		entry += rank * variables[i].stride;
+	}
+	*result = (bits[entry / 64] >> (entry % 64)) & 1 ? CCS_TRUE : CCS_FALSE;
+	return 1;
+}
+
+// The conditions are compiled, in the topological order of the
+// hyperparameters, into a single constraints code buffer, followed by the
+// forbidden clauses. The activation plan lists the conditioned hyperparameters
+// in that order, with the offset of their condition program, and the forbidden
+// plan the forbidden clauses in the order they are tested. The plans are
+// rebuilt lazily after conditions are added, and must be up to date before
+// sampling threads are started. Forbidden clauses are appended as they are
+// added, and the forbidden plan keeps its order and statistics across
+// rebuilds.
+static ccs_result_t
+_compile_forbidden_clause(ccs_configuration_space_t  configuration_space,
+                          _ccs_forbidden_step_t     *step) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	size_t stack_size;
+	step->offset = utarray_len(data->constraints_code);
+	CCS_VALIDATE(_ccs_expression_compile(
+		*(ccs_expression_t *)utarray_eltptr(data->forbidden_clauses,
+		                                    step->clause),
+		(ccs_context_t)configuration_space, data->constraints_code,
+		&stack_size));
+	step->cost = utarray_len(data->constraints_code) - step->offset;
+	if (stack_size > data->constraints_stack_size)
+		data->constraints_stack_size = stack_size;
+	step->required = utarray_len(data->forbidden_requirements);
+	CCS_VALIDATE(_ccs_expression_get_required_indexes(
+		*(ccs_expression_t *)utarray_eltptr(data->forbidden_clauses,
+		                                    step->clause),
+		(ccs_context_t)configuration_space, data->forbidden_requirements));
+	step->num_required = utarray_len(data->forbidden_requirements) -
+	                     step->required;
+	CCS_VALIDATE(_tabulate_constraint(configuration_space,
+		*(ccs_expression_t *)utarray_eltptr(data->forbidden_clauses,
+		                                    step->clause),
+		step->offset, stack_size, &step->table));
+	if (step->table.num_variables)
+		step->cost = step->table.num_variables;
+	return CCS_SUCCESS;
+}
+
+#undef  utarray_oom
+#define utarray_oom() { \
+	err = -CCS_OUT_OF_MEMORY; \
+	goto errplan; \
+}
 static ccs_result_t
-_set_actives(ccs_configuration_space_t configuration_space,
-             ccs_configuration_t       configuration) {
+_generate_constraints(ccs_configuration_space_t configuration_space) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	if (data->constraints_ok)
+		return CCS_SUCCESS;
+	ccs_result_t err;
+	UT_array *array = data->hyperparameters;
 	size_t *p_index = NULL;
-	UT_array *indexes = configuration_space->data->sorted_indexes;
-	UT_array *array = configuration_space->data->hyperparameters;
-	ccs_datum_t *values = configuration->data->values;
-	while ( (p_index = (size_t *)utarray_next(indexes, p_index)) ) {
-		_ccs_hyperparameter_wrapper_cs_t *wrapper = NULL;
-		wrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, *p_index);
+	_ccs_forbidden_step_t *p_step = NULL;
+	utarray_clear(data->activation_plan);
+	utarray_clear(data->constraints_code);
+	utarray_clear(data->forbidden_requirements);
+	utarray_clear(data->table_variables);
+	utarray_clear(data->tables);
+	data->constraints_stack_size = 0;
+	data->restrictions_ok = 0;
+	while ( (p_index = (size_t *)utarray_next(data->sorted_indexes, p_index)) ) {
+		_ccs_hyperparameter_wrapper_cs_t *wrapper =
+			(_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, *p_index);
 		if (!wrapper->condition)
 			continue;
-		ccs_datum_t result;
-		ccs_result_t err;
-		err = ccs_expression_eval(wrapper->condition,
-		                          (ccs_context_t)configuration_space,
-		                          values, &result);
-		if (err) {
-			if (err != -CCS_INACTIVE_HYPERPARAMETER)
-				return err;
-                        values[*p_index] = ccs_inactive;
-		} else if (!(result.type == CCS_BOOLEAN && result.value.i == CCS_TRUE))
-			values[*p_index] = ccs_inactive;
+		_ccs_activation_step_t step;
+		size_t stack_size;
+		step.index = *p_index;
+		step.offset = utarray_len(data->constraints_code);
+		CCS_VALIDATE_ERR_GOTO(err, _ccs_expression_compile(wrapper->condition,
+			(ccs_context_t)configuration_space, data->constraints_code,
+			&stack_size), errplan);
+		if (stack_size > data->constraints_stack_size)
+			data->constraints_stack_size = stack_size;
+		CCS_VALIDATE_ERR_GOTO(err, _tabulate_constraint(configuration_space,
+			wrapper->condition, step.offset, stack_size, &step.table),
+			errplan);
+		utarray_push_back(data->activation_plan, &step);
+	}
+	while ( (p_step = (_ccs_forbidden_step_t *)
+	           utarray_next(data->forbidden_plan, p_step)) )
+		CCS_VALIDATE_ERR_GOTO(err, _compile_forbidden_clause(
+			configuration_space, p_step), errplan);
+	data->constraints_ok = 1;
+	return CCS_SUCCESS;
+errplan:
+	utarray_clear(data->activation_plan);
+	utarray_clear(data->constraints_code);
+	utarray_clear(data->forbidden_requirements);
+	utarray_clear(data->table_variables);
+	utarray_clear(data->tables);
+	return err;
+}
+
+// Evaluates the condition of an activation step on values. stack must hold
+// constraints_stack_size values.
+static inline ccs_result_t
+_test_activation(_ccs_configuration_space_data_t *data,
+                 const _ccs_activation_step_t    *step,
+                 ccs_datum_t                     *values,
+                 ccs_datum_t                     *stack,
+                 ccs_bool_t                      *active) {
+	ccs_datum_t result;
+	ccs_result_t err;
+	if (step->table.num_variables &&
+	    _lookup_constraint_table(data, &step->table, values, active))
+		return CCS_SUCCESS;
+	err = _ccs_expression_run(
+		(_ccs_expression_instruction_t *)utarray_eltptr(
+			data->constraints_code, step->offset),
+		values, stack, &result);
+	if (err) {
+		if (err != -CCS_INACTIVE_HYPERPARAMETER)
+			return err;
+		*active = CCS_FALSE;
+	} else
+		*active = (result.type == CCS_BOOLEAN && result.value.i == CCS_TRUE) ?
+		          CCS_TRUE : CCS_FALSE;
+	return CCS_SUCCESS;
+}
+
+static ccs_result_t
+_set_actives(ccs_configuration_space_t  configuration_space,
+             ccs_datum_t               *values) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	size_t num_steps = utarray_len(data->activation_plan);
+	_ccs_activation_step_t *steps =
+		(_ccs_activation_step_t *)utarray_front(data->activation_plan);
+	ccs_datum_t *stack = (ccs_datum_t *)alloca(
+		data->constraints_stack_size * sizeof(ccs_datum_t));
+	for (size_t i = 0; i < num_steps; i++) {
+		ccs_bool_t active;
+		CCS_VALIDATE(_test_activation(data, steps + i, values, stack, &active));
+		if (!active)
+			values[steps[i].index] = ccs_inactive;
 	}
 	return CCS_SUCCESS;
 }
+#undef  utarray_oom
+#define utarray_oom() exit(-1)
 
 ccs_result_t
 ccs_configuration_space_get_default_configuration(ccs_configuration_space_t  configuration_space,
@@ -558,6 +1038,7 @@ ccs_configuration_space_get_default_configuration(ccs_configuration_space_t  con
 	CCS_CHECK_PTR(configuration_ret);
 	ccs_result_t err;
 	ccs_configuration_t config;
+	CCS_VALIDATE(_generate_constraints(configuration_space));
 	CCS_VALIDATE(ccs_create_configuration(configuration_space, 0, NULL, NULL, &config));
 	UT_array *array = configuration_space->data->hyperparameters;
 	_ccs_hyperparameter_wrapper_cs_t *wrapper = NULL;
@@ -565,7 +1046,7 @@ ccs_configuration_space_get_default_configuration(ccs_configuration_space_t  con
 	while ( (wrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_next(array, wrapper)) )
 		CCS_VALIDATE_ERR_GOTO(err, ccs_hyperparameter_get_default_value(
 		    wrapper->hyperparameter, values++), errc);
-	CCS_VALIDATE_ERR_GOTO(err, _set_actives(configuration_space, config), errc);
+	CCS_VALIDATE_ERR_GOTO(err, _set_actives(configuration_space, config->data->values), errc);
 	*configuration_ret = config;
 	return CCS_SUCCESS;
 errc:
@@ -573,28 +1054,101 @@ errc:
 	return err;
 }
 
+// Forbidden clauses are tested by decreasing ratio of their estimated
+// rejection rate to their cost, which minimizes the expected cost of finding
+// a rejecting clause. The order is updated periodically from the statistics
+// gathered while sampling, unless it was frozen.
+#define CCS_FORBIDDEN_REORDER_PERIOD 1024
+
+static int
+_forbidden_step_cmp(const void *a, const void *b) {
+	const _ccs_forbidden_step_t *sa = (const _ccs_forbidden_step_t *)a;
+	const _ccs_forbidden_step_t *sb = (const _ccs_forbidden_step_t *)b;
+	double ra = (double)(sa->hits + 1) /
+	            ((double)(sa->evaluations + 2) * (double)sa->cost);
+	double rb = (double)(sb->hits + 1) /
+	            ((double)(sb->evaluations + 2) * (double)sb->cost);
+	if (ra > rb)
+		return -1;
+	if (ra < rb)
+		return 1;
+	return sa->clause < sb->clause ? -1 : sa->clause > sb->clause ? 1 : 0;
+}
+
+static inline void
+_reorder_forbidden(ccs_configuration_space_t configuration_space) {
+	UT_array *plan = configuration_space->data->forbidden_plan;
+	if (utarray_len(plan))
+		utarray_sort(plan, &_forbidden_step_cmp);
+}
+
+// Evaluates the forbidden clause of a forbidden step on values. stack must
+// hold constraints_stack_size values.
+static inline ccs_result_t
+_test_forbidden_step(_ccs_configuration_space_data_t *data,
+                     const _ccs_forbidden_step_t     *step,
+                     ccs_datum_t                     *values,
+                     ccs_datum_t                     *stack,
+                     ccs_bool_t                      *rejected) {
+	ccs_datum_t result;
+	ccs_result_t err;
+	if (step->table.num_variables &&
+	    _lookup_constraint_table(data, &step->table, values, rejected))
+		return CCS_SUCCESS;
+	err = _ccs_expression_run(
+		(_ccs_expression_instruction_t *)utarray_eltptr(
+			data->constraints_code, step->offset),
+		values, stack, &result);
+	if (err) {
+		if (err != -CCS_INACTIVE_HYPERPARAMETER)
+			return err;
+		*rejected = CCS_FALSE;
+	} else
+		*rejected = (result.type == CCS_BOOLEAN && result.value.i == CCS_TRUE) ?
+		            CCS_TRUE : CCS_FALSE;
+	return CCS_SUCCESS;
+}
+
+// Statistics are only recorded when record is set, which must not be the case
+// when several threads test configurations concurrently.
 static ccs_result_t
 _test_forbidden(ccs_configuration_space_t  configuration_space,
                 ccs_datum_t               *values,
+                int                        record,
 		ccs_bool_t                *is_valid) {
-	ccs_result_t err;
-	UT_array *array = configuration_space->data->forbidden_clauses;
-	ccs_expression_t *p_expression = NULL;
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	size_t num_clauses = utarray_len(data->forbidden_plan);
+	_ccs_forbidden_step_t *steps =
+		(_ccs_forbidden_step_t *)utarray_front(data->forbidden_plan);
+	size_t *requirements =
+		(size_t *)utarray_front(data->forbidden_requirements);
+	ccs_datum_t *stack = (ccs_datum_t *)alloca(
+		data->constraints_stack_size * sizeof(ccs_datum_t));
+	record = record && !data->forbidden_frozen;
 	*is_valid = CCS_FALSE;
-	while ( (p_expression = (ccs_expression_t *)
-	               utarray_next(array, p_expression)) ) {
-		ccs_datum_t result;
-		err = ccs_expression_eval(*p_expression,
-		                          (ccs_context_t)configuration_space,
-		                          values, &result);
-		if (err == -CCS_INACTIVE_HYPERPARAMETER)
+	for (size_t i = 0; i < num_clauses; i++) {
+		ccs_bool_t rejected;
+		size_t *required = requirements + steps[i].required;
+		size_t j;
+		for (j = 0; j < steps[i].num_required; j++)
+			if (values[required[j]].type == CCS_INACTIVE)
+				break;
+		if (j < steps[i].num_required)
 			continue;
-		else if (err)
-			return err;
-		if (result.type == CCS_BOOLEAN && result.value.i == CCS_TRUE)
-			return CCS_SUCCESS;
+		if (record)
+			steps[i].evaluations++;
+		CCS_VALIDATE(_test_forbidden_step(data, steps + i, values, stack,
+		                                  &rejected));
+		if (!rejected)
+			continue;
+		if (record)
+			steps[i].hits++;
+		goto end;
 	}
 	*is_valid = CCS_TRUE;
+end:
+	if (record && ++data->forbidden_tests % CCS_FORBIDDEN_REORDER_PERIOD == 0)
+		_reorder_forbidden(configuration_space);
 	return CCS_SUCCESS;
 }
 
@@ -602,29 +1156,28 @@ static inline ccs_result_t
 _check_configuration(ccs_configuration_space_t  configuration_space,
                      size_t                     num_values,
                      ccs_datum_t               *values) {
-	UT_array *indexes = configuration_space->data->sorted_indexes;
-	UT_array *array = configuration_space->data->hyperparameters;
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	UT_array *indexes = data->sorted_indexes;
+	UT_array *array = data->hyperparameters;
 	if (num_values != utarray_len(array))
 		return -CCS_INVALID_CONFIGURATION;
+	CCS_VALIDATE(_generate_constraints(configuration_space));
+	size_t num_steps = utarray_len(data->activation_plan);
+	_ccs_activation_step_t *steps =
+		(_ccs_activation_step_t *)utarray_front(data->activation_plan);
+	ccs_datum_t *stack = (ccs_datum_t *)alloca(
+		data->constraints_stack_size * sizeof(ccs_datum_t));
+	// The plan follows the order of sorted_indexes
+	size_t step = 0;
 	size_t *p_index = NULL;
 	while ( (p_index = (size_t *)utarray_next(indexes, p_index)) ) {
 		ccs_bool_t active = CCS_TRUE;
 		_ccs_hyperparameter_wrapper_cs_t *wrapper = NULL;
 		wrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, *p_index);
-		if (wrapper->condition) {
-			ccs_datum_t result;
-			ccs_result_t err;
-			err = ccs_expression_eval(
-				wrapper->condition,
-				(ccs_context_t)configuration_space,
-				values, &result);
-			if (err) {
-				if (err != -CCS_INACTIVE_HYPERPARAMETER)
-					return err;
-                                active = CCS_FALSE;
-			} else if (!(result.type == CCS_BOOLEAN && result.value.i == CCS_TRUE)) {
-				active = CCS_FALSE;
-			}
+		if (step < num_steps && steps[step].index == *p_index) {
+			CCS_VALIDATE(_test_activation(data, steps + step, values,
+			                              stack, &active));
+			step++;
 		}
 		if (active != (values[*p_index].type == CCS_INACTIVE ? CCS_FALSE : CCS_TRUE))
 			return -CCS_INVALID_CONFIGURATION;
@@ -637,7 +1190,7 @@ _check_configuration(ccs_configuration_space_t  configuration_space,
 		}
 	}
 	ccs_bool_t valid;
-	CCS_VALIDATE(_test_forbidden(configuration_space, values, &valid));
+	CCS_VALIDATE(_test_forbidden(configuration_space, values, 0, &valid));
 	if (!valid)
 		return -CCS_INVALID_CONFIGURATION;
 	return CCS_SUCCESS;
@@ -650,8 +1203,6 @@ ccs_configuration_space_check_configuration(ccs_configuration_space_t configurat
 	CCS_CHECK_OBJ(configuration, CCS_CONFIGURATION);
 	if (configuration->data->configuration_space != configuration_space)
 		return -CCS_INVALID_CONFIGURATION;
-	if (!configuration_space->data->graph_ok)
-		CCS_VALIDATE(_generate_constraints(configuration_space));
 	return _check_configuration(configuration_space,
 	                            configuration->data->num_values,
 	                            configuration->data->values);
@@ -663,329 +1214,2235 @@ ccs_configuration_space_check_configuration_values(ccs_configuration_space_t  co
                                                    ccs_datum_t               *values) {
 	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
 	CCS_CHECK_ARY(num_values, values);
-	if (!configuration_space->data->graph_ok)
-		CCS_VALIDATE(_generate_constraints(configuration_space));
 	return _check_configuration(configuration_space, num_values, values);
 }
 
-
+// Rows are checked hyperparameter by hyperparameter, so that the values of a
+// hyperparameter are checked in a single call, and the constraints are only
+// generated once. Rows which reason is not CCS_CONFIGURATION_VALID on entry
+// are skipped.
 static ccs_result_t
-_sample(ccs_configuration_space_t  configuration_space,
-        ccs_configuration_t        config,
-        ccs_bool_t                *found) {
-	ccs_result_t err;
-	ccs_rng_t rng = configuration_space->data->rng;
-	UT_array *array = configuration_space->data->hyperparameters;
-	_ccs_distribution_wrapper_t *dwrapper = NULL;
-	_ccs_hyperparameter_wrapper_cs_t *hwrapper = NULL;
-	ccs_datum_t *values = config->data->values;
-
-	size_t num_hyperparameters = utarray_len(array);
-	ccs_datum_t *p_values;
-	ccs_hyperparameter_t *hps;
-	uintptr_t mem;
-	mem = (uintptr_t) malloc(num_hyperparameters * (sizeof(ccs_datum_t) + sizeof(ccs_hyperparameter_t)));
+_check_configurations(ccs_configuration_space_t     configuration_space,
+                      size_t                        num_configurations,
+                      ccs_datum_t                 **rows,
+                      ccs_configuration_validity_t *reasons) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	UT_array *array = data->hyperparameters;
+	ccs_result_t err = CCS_SUCCESS;
+	CCS_VALIDATE(_generate_constraints(configuration_space));
+	size_t num_steps = utarray_len(data->activation_plan);
+	_ccs_activation_step_t *steps =
+		(_ccs_activation_step_t *)utarray_front(data->activation_plan);
+	ccs_datum_t *stack = (ccs_datum_t *)alloca(
+		data->constraints_stack_size * sizeof(ccs_datum_t));
+	uintptr_t mem = (uintptr_t)malloc(num_configurations *
+		(sizeof(ccs_datum_t) + sizeof(size_t) + sizeof(ccs_bool_t)));
 	if (!mem)
 		return -CCS_OUT_OF_MEMORY;
-
-	p_values = (ccs_datum_t *)mem;
-	hps = (ccs_hyperparameter_t *)(mem + num_hyperparameters*sizeof(ccs_datum_t));
-	DL_FOREACH(configuration_space->data->distribution_list, dwrapper) {
-		for (size_t i = 0; i < dwrapper->dimension; i++) {
-			size_t hindex = dwrapper->hyperparameter_indexes[i];
-			hwrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, hindex);
-			hps[i] = hwrapper->hyperparameter;
-		}
-		CCS_VALIDATE_ERR_GOTO(err, ccs_distribution_hyperparameters_sample(
-			dwrapper->distribution, rng, hps, p_values), memory);
-		for (size_t i = 0; i < dwrapper->dimension; i++) {
-			size_t hindex = dwrapper->hyperparameter_indexes[i];
-			values[hindex] = p_values[i];
+	ccs_datum_t *column = (ccs_datum_t *)mem;
+	size_t *column_rows = (size_t *)(column + num_configurations);
+	ccs_bool_t *results = (ccs_bool_t *)(column_rows + num_configurations);
+	// The plan follows the order of sorted_indexes
+	size_t step = 0;
+	size_t *p_index = NULL;
+	while ( (p_index = (size_t *)utarray_next(data->sorted_indexes, p_index)) ) {
+		size_t index = *p_index;
+		_ccs_hyperparameter_wrapper_cs_t *wrapper =
+			(_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, index);
+		_ccs_activation_step_t *activation = NULL;
+		if (step < num_steps && steps[step].index == index)
+			activation = steps + step++;
+		size_t count = 0;
+		for (size_t i = 0; i < num_configurations; i++) {
+			if (reasons[i] != CCS_CONFIGURATION_VALID)
+				continue;
+			ccs_bool_t active = CCS_TRUE;
+			if (activation)
+				CCS_VALIDATE_ERR_GOTO(err, _test_activation(data,
+					activation, rows[i], stack, &active), end);
+			if (active != (rows[i][index].type == CCS_INACTIVE ?
+			               CCS_FALSE : CCS_TRUE))
+				reasons[i] = CCS_CONFIGURATION_INVALID_ACTIVATION;
+			else if (active) {
+				column[count] = rows[i][index];
+				column_rows[count++] = i;
+			}
 		}
+		if (!count)
+			continue;
+		CCS_VALIDATE_ERR_GOTO(err, ccs_hyperparameter_check_values(
+			wrapper->hyperparameter, count, column, results), end);
+		for (size_t i = 0; i < count; i++)
+			if (!results[i])
+				reasons[column_rows[i]] = CCS_CONFIGURATION_INVALID_VALUE;
 	}
-	CCS_VALIDATE_ERR_GOTO(err, _set_actives(configuration_space, config), memory);
-	CCS_VALIDATE_ERR_GOTO(err, _test_forbidden(configuration_space, config->data->values, found), memory);
-	free((void *)mem);
-	return CCS_SUCCESS;
-memory:
+	for (size_t i = 0; i < num_configurations; i++) {
+		ccs_bool_t valid;
+		if (reasons[i] != CCS_CONFIGURATION_VALID)
+			continue;
+		CCS_VALIDATE_ERR_GOTO(err, _test_forbidden(configuration_space,
+			rows[i], 0, &valid), end);
+		if (!valid)
+			reasons[i] = CCS_CONFIGURATION_FORBIDDEN;
+	}
+end:
 	free((void *)mem);
 	return err;
 }
 
-//static ccs_result_t
-//_sample(ccs_configuration_space_t  configuration_space,
-//        ccs_configuration_t        config,
-//        ccs_bool_t                *found) {
-//	ccs_rng_t rng = configuration_space->data->rng;
-//	UT_array *array = configuration_space->data->hyperparameters;
-//	_ccs_hyperparameter_wrapper_cs_t *wrapper = NULL;
-//	ccs_datum_t *values = config->data->values;
-//	while ( (wrapper = (_ccs_hyperparameter_wrapper_cs_t *)
-//	                       utarray_next(array, wrapper)) ) {
-//		CCS_VALIDATE(ccs_hyperparameter_sample(wrapper->hyperparameter,
-//		    wrapper->distribution->distribution, rng, values++));
-//	}
-//	CCS_VALIDATE(_set_actives(configuration_space, config));
-//	CCS_VALIDATE(_test_forbidden(configuration_space, config->data->values, found));
-//	return CCS_SUCCESS;
-//}
-
 ccs_result_t
-ccs_configuration_space_sample(ccs_configuration_space_t  configuration_space,
-                               ccs_configuration_t       *configuration_ret) {
+ccs_configuration_space_check_configurations(
+		ccs_configuration_space_t     configuration_space,
+		size_t                        num_configurations,
+		ccs_configuration_t          *configurations,
+		ccs_bool_t                   *valids_ret,
+		ccs_configuration_validity_t *reasons_ret) {
 	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
-	CCS_CHECK_PTR(configuration_ret);
-	ccs_result_t err;
-	ccs_configuration_t config;
-	if (!configuration_space->data->graph_ok)
-		CCS_VALIDATE(_generate_constraints(configuration_space));
-	CCS_VALIDATE(ccs_create_configuration(configuration_space, 0, NULL, NULL, &config));
-	ccs_bool_t found;
-	int counter = 0;
-	do {
-		CCS_VALIDATE_ERR_GOTO(err, _sample(configuration_space, config, &found), errc);
-		counter++;
-	} while (!found && counter < 100);
-	if (!found) {
-		err = -CCS_SAMPLING_UNSUCCESSFUL;
-		goto errc;
+	CCS_CHECK_ARY(num_configurations, configurations);
+	CCS_CHECK_ARY(num_configurations, valids_ret);
+	for (size_t i = 0; i < num_configurations; i++)
+		CCS_CHECK_OBJ(configurations[i], CCS_CONFIGURATION);
+	if (!num_configurations)
+		return CCS_SUCCESS;
+	size_t num_hyperparameters =
+		utarray_len(configuration_space->data->hyperparameters);
+	ccs_datum_t **rows = (ccs_datum_t **)malloc(num_configurations *
+		(sizeof(ccs_datum_t *) +
+		 (reasons_ret ? 0 : sizeof(ccs_configuration_validity_t))));
+	if (!rows)
+		return -CCS_OUT_OF_MEMORY;
+	ccs_configuration_validity_t *reasons = reasons_ret ? reasons_ret :
+		(ccs_configuration_validity_t *)(rows + num_configurations);
+	for (size_t i = 0; i < num_configurations; i++) {
+		_ccs_configuration_data_t *config_data = configurations[i]->data;
+		rows[i] = config_data->values;
+		reasons[i] =
+			(config_data->configuration_space != configuration_space ||
+			 config_data->num_values != num_hyperparameters) ?
+			CCS_CONFIGURATION_INVALID_SPACE : CCS_CONFIGURATION_VALID;
 	}
-	*configuration_ret = config;
-	return CCS_SUCCESS;
-errc:
-	ccs_release_object(config);
+	ccs_result_t err = _check_configurations(configuration_space,
+		num_configurations, rows, reasons);
+	if (err == CCS_SUCCESS)
+		for (size_t i = 0; i < num_configurations; i++)
+			valids_ret[i] = reasons[i] == CCS_CONFIGURATION_VALID ?
+			                CCS_TRUE : CCS_FALSE;
+	free(rows);
 	return err;
 }
 
 ccs_result_t
-ccs_configuration_space_samples(ccs_configuration_space_t  configuration_space,
-                                size_t                     num_configurations,
-                                ccs_configuration_t       *configurations) {
+ccs_configuration_space_check_configurations_values(
+		ccs_configuration_space_t     configuration_space,
+		size_t                        num_configurations,
+		size_t                        num_values,
+		ccs_datum_t                  *values,
+		ccs_bool_t                   *valids_ret,
+		ccs_configuration_validity_t *reasons_ret) {
 	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
-	CCS_CHECK_ARY(num_configurations, configurations);
+	CCS_CHECK_ARY(num_configurations * num_values, values);
+	CCS_CHECK_ARY(num_configurations, valids_ret);
 	if (!num_configurations)
 		return CCS_SUCCESS;
-	ccs_result_t err;
-	if (!configuration_space->data->graph_ok)
-		CCS_VALIDATE(_generate_constraints(configuration_space));
-	size_t     counter = 0;
-	size_t     count = 0;
-	ccs_bool_t found;
-	ccs_configuration_t config = NULL;
-	// Naive implementation
-	//See below for more efficient ideas...
-	for (size_t i = 0; i < num_configurations; i++)
-		configurations[i] = NULL;
-	while (count < num_configurations && counter < 100 * num_configurations) {
-		if (!config)
-			CCS_VALIDATE(ccs_create_configuration(configuration_space, 0, NULL, NULL, &config));
-		CCS_VALIDATE_ERR_GOTO(err, _sample(configuration_space, config, &found), errc);
-		counter++;
-		if (found) {
-			configurations[count++] = config;
-			config = NULL;
-		}
+	ccs_configuration_validity_t reason =
+		num_values != utarray_len(configuration_space->data->hyperparameters) ?
+		CCS_CONFIGURATION_INVALID_SPACE : CCS_CONFIGURATION_VALID;
+	ccs_datum_t **rows = (ccs_datum_t **)malloc(num_configurations *
+		(sizeof(ccs_datum_t *) +
+		 (reasons_ret ? 0 : sizeof(ccs_configuration_validity_t))));
+	if (!rows)
+		return -CCS_OUT_OF_MEMORY;
+	ccs_configuration_validity_t *reasons = reasons_ret ? reasons_ret :
+		(ccs_configuration_validity_t *)(rows + num_configurations);
+	for (size_t i = 0; i < num_configurations; i++) {
+		rows[i] = values + i * num_values;
+		reasons[i] = reason;
 	}
-	if (count < num_configurations)
-		return -CCS_SAMPLING_UNSUCCESSFUL;
-	return CCS_SUCCESS;
-errc:
-	ccs_release_object(config);
+	ccs_result_t err = _check_configurations(configuration_space,
+		num_configurations, rows, reasons);
+	if (err == CCS_SUCCESS)
+		for (size_t i = 0; i < num_configurations; i++)
+			valids_ret[i] = reasons[i] == CCS_CONFIGURATION_VALID ?
+			                CCS_TRUE : CCS_FALSE;
+	free(rows);
 	return err;
 }
-//	UT_array *array = configuration_space->data->hyperparameters;
-//	size_t num_hyper = utarray_len(array);
-//	ccs_datum_t *values = (ccs_datum_t *)calloc(1, sizeof(ccs_datum_t)*num_configurations*num_hyper);
-//	ccs_datum_t *p_values = values;
-//	ccs_rng_t rng = configuration_space->data->rng;
-//	_ccs_hyperparameter_wrapper_cs_t *wrapper = NULL;
-//	while ( (wrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_next(array, wrapper)) ) {
-//		err = ccs_hyperparameter_samples(wrapper->hyperparameter,
-//		                                 wrapper->distribution->distribution,
-//						 rng, num_configurations, p_values);
-//		if (CCS_UNLIKELY(err)) {
-//			free(values);
-//			return err;
-//		}
-//		p_values += num_configurations;
-//	}
-//	size_t i;
-//	for(i = 0; i < num_configurations; i++) {
-//		err = ccs_create_configuration(configuration_space, 0, NULL, NULL, configurations + i);
-//		if (CCS_UNLIKELY(err)) {
-//			free(values);
-//			for(size_t j = 0; j < i; j++)
-//				ccs_release_object(configurations + j);
-//			return err;
-//		}
-//	}
-//	for(i = 0; i < num_configurations; i++) {
-//		for(size_t j = 0; j < num_hyper; j++)
-//			configurations[i]->data->values[j] =
-//				values[j*num_configurations + i];
-//
-//		err = _set_actives(configuration_space, configurations[i]);
-//		if (err) {
-//			free(values);
-//			for(size_t j = 0; j < num_configurations; j++)
-//				ccs_release_object(configurations + j);
-//			return err;
-//		}
-//	}
-//	free(values);
-//	return CCS_SUCCESS;
 
-static int _size_t_sort(const void *a, const void *b) {
-	const size_t sa = *(const size_t *)a;
-	const size_t sb = *(const size_t *)b;
-	return sa < sb ? -1 : sa > sb ? 1 : 0;
+// The sampled configurations hash set is keyed by the binding data of the
+// configurations, and compares them like configurations are compared.
+#undef  HASH_KEYCMP
+#define HASH_KEYCMP(a, b, n) _ccs_binding_data_cmp( \
+	(_ccs_binding_data_t *)(a), (_ccs_binding_data_t *)(b))
+#undef  uthash_nonfatal_oom
+#define uthash_nonfatal_oom(elt) { \
+	free(elt); \
+	return -CCS_OUT_OF_MEMORY; \
 }
-
-static void _uniq_size_t_array(UT_array *array) {
-	size_t count = utarray_len(array);
-	if (count == 0)
-		return;
-	utarray_sort(array, &_size_t_sort);
-	size_t real_count = 0;
-	size_t *p = (size_t *)utarray_front(array);
-	size_t *p2 = p;
-	real_count++;
-	while ( (p = (size_t *)utarray_next(array, p)) ) {
-		if (*p != *p2) {
-			p2 = (size_t *)utarray_next(array, p2);
-			*p2 = *p;
-			real_count++;
-		}
+// Adds the configuration with the given values to the sampled configurations.
+// is_new is set to CCS_FALSE if it was already there.
+static ccs_result_t
+_add_sampled_configuration(ccs_configuration_space_t  configuration_space,
+                           ccs_datum_t               *values,
+                           ccs_bool_t                *is_new) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	_ccs_binding_data_t key = { NULL, (ccs_context_t)configuration_space,
+		utarray_len(data->hyperparameters), values };
+	_ccs_sampled_configuration_t *entry;
+	ccs_hash_t hash;
+	CCS_VALIDATE(_ccs_binding_hash(&key, &hash));
+	HASH_FIND_BYHASHVALUE(hh, data->sampled_configurations, &key,
+	                      sizeof(_ccs_binding_data_t), hash, entry);
+	if (entry) {
+		*is_new = CCS_FALSE;
+		return CCS_SUCCESS;
 	}
-	utarray_resize(array, real_count);
+	entry = (_ccs_sampled_configuration_t *)malloc(
+		sizeof(_ccs_sampled_configuration_t) +
+		key.num_values * sizeof(ccs_datum_t));
+	if (!entry)
+		return -CCS_OUT_OF_MEMORY;
+	entry->data = key;
+	entry->data.values = (ccs_datum_t *)(entry + 1);
+	memcpy(entry->data.values, values, key.num_values * sizeof(ccs_datum_t));
+	HASH_ADD_KEYPTR_BYHASHVALUE(hh, data->sampled_configurations,
+		&entry->data, sizeof(_ccs_binding_data_t), hash, entry);
+	*is_new = CCS_TRUE;
+	return CCS_SUCCESS;
 }
+#undef  HASH_KEYCMP
+#define HASH_KEYCMP(a, b, n) uthash_memcmp(a, b, n)
 
-struct _hyper_list_s;
-struct _hyper_list_s {
-	size_t in_edges;
-	size_t index;
-	struct _hyper_list_s *next;
-	struct _hyper_list_s *prev;
-};
+// Largest number of combinations of values enumerated to count the distinct
+// configurations of a configuration space
+#define CCS_DISTINCT_MAX_COMBINATIONS 65536
 
-#undef  utarray_oom
-#define utarray_oom() { \
-	free((void *)list); \
-	return -CCS_OUT_OF_MEMORY; \
-}
+// Checks that a hyperparameter is sampled from its default distribution: the
+// whole domain of the hyperparameter can then be sampled.
 static ccs_result_t
-_topological_sort(ccs_configuration_space_t configuration_space) {
-	utarray_clear(configuration_space->data->sorted_indexes);
-	UT_array *array = configuration_space->data->hyperparameters;
-	size_t count = utarray_len(array);
+_has_default_distribution(_ccs_hyperparameter_wrapper_cs_t *hwrapper,
+                          ccs_bool_t                       *default_ret) {
+	ccs_result_t err = CCS_SUCCESS;
+	ccs_distribution_t distribution = hwrapper->distribution->distribution;
+	ccs_distribution_t default_distribution;
+	ccs_distribution_type_t type;
+	ccs_numeric_t lower, upper, quantization;
+	ccs_numeric_t default_lower, default_upper, default_quantization;
+	ccs_scale_type_t scale, default_scale;
+	*default_ret = CCS_FALSE;
+	if (hwrapper->distribution->dimension != 1)
+		return CCS_SUCCESS;
+	CCS_VALIDATE(ccs_distribution_get_type(distribution, &type));
+	if (type != CCS_UNIFORM)
+		return CCS_SUCCESS;
+	CCS_VALIDATE(ccs_uniform_distribution_get_parameters(
+		distribution, &lower, &upper, &scale, &quantization));
+	CCS_VALIDATE(ccs_hyperparameter_get_default_distribution(
+		hwrapper->hyperparameter, &default_distribution));
+	CCS_VALIDATE_ERR_GOTO(err, ccs_uniform_distribution_get_parameters(
+		default_distribution, &default_lower, &default_upper,
+		&default_scale, &default_quantization), end);
+	*default_ret = (lower.i == default_lower.i &&
+	                upper.i == default_upper.i &&
+	                scale == default_scale &&
+	                quantization.i == default_quantization.i) ?
+	               CCS_TRUE : CCS_FALSE;
+end:
+	ccs_release_object(default_distribution);
+	return err;
+}
 
-	struct _hyper_list_s *list = (struct _hyper_list_s *)calloc(1,
-		sizeof(struct _hyper_list_s) * count);
-	if (!list)
+// Counts the distinct valid configurations of configuration spaces with few
+// combinations of categorical, ordinal, discrete or integer numerical values,
+// by testing every combination. Combinations where an inactive hyperparameter
+// does not take its first value duplicate another one, and are skipped. The
+// count is SIZE_MAX for other configuration spaces, and when a hyperparameter
+// is not sampled from its default distribution, as it may then only take
+// some of its values.
+static ccs_result_t
+_count_distinct(ccs_configuration_space_t configuration_space) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	if (data->num_distinct_ok)
+		return CCS_SUCCESS;
+	ccs_result_t err = CCS_SUCCESS;
+	UT_array *array = data->hyperparameters;
+	size_t num_hyperparameters = utarray_len(array);
+	size_t combinations = 1;
+	size_t count = 0;
+	// The empty configuration is the only one
+	if (!num_hyperparameters) {
+		data->num_distinct = 1;
+		data->num_distinct_ok = 1;
+		return CCS_SUCCESS;
+	}
+	uintptr_t mem = (uintptr_t)malloc(num_hyperparameters * (
+		2 * sizeof(ccs_datum_t) + 2 * sizeof(size_t) + 2 * sizeof(ccs_int_t)));
+	if (!mem)
 		return -CCS_OUT_OF_MEMORY;
-	struct _hyper_list_s *queue = NULL;
+	ccs_datum_t *combination = (ccs_datum_t *)mem;
+	ccs_datum_t *values = combination + num_hyperparameters;
+	size_t *sizes = (size_t *)(values + num_hyperparameters);
+	size_t *ranks = sizes + num_hyperparameters;
+	ccs_int_t *lowers = (ccs_int_t *)(ranks + num_hyperparameters);
+	ccs_int_t *steps = lowers + num_hyperparameters;
+	data->num_distinct = SIZE_MAX;
+	for (size_t i = 0; i < num_hyperparameters; i++) {
+		_ccs_hyperparameter_wrapper_cs_t *hwrapper =
+			(_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, i);
+		ccs_hyperparameter_t hyperparameter = hwrapper->hyperparameter;
+		ccs_hyperparameter_type_t type;
+		ccs_bool_t default_distribution;
+		CCS_VALIDATE_ERR_GOTO(err, ccs_hyperparameter_get_type(
+			hyperparameter, &type), end);
+		if (type == CCS_HYPERPARAMETER_TYPE_CATEGORICAL ||
+		    type == CCS_HYPERPARAMETER_TYPE_ORDINAL ||
+		    type == CCS_HYPERPARAMETER_TYPE_DISCRETE) {
+			sizes[i] = _ccs_categorical_hyperparameter_get_num_values(
+				hyperparameter);
+			steps[i] = 0;
+			combination[i] = _ccs_categorical_hyperparameter_get_value(
+				hyperparameter, 0);
+		} else if (type == CCS_HYPERPARAMETER_TYPE_NUMERICAL) {
+			ccs_numeric_type_t data_type;
+			ccs_numeric_t lower, upper, quantization;
+			CCS_VALIDATE_ERR_GOTO(err,
+				ccs_numerical_hyperparameter_get_parameters(
+					hyperparameter, &data_type, &lower, &upper,
+					&quantization), end);
+			if (data_type != CCS_NUM_INTEGER)
+				goto end;
+			lowers[i] = lower.i;
+			steps[i] = quantization.i ? quantization.i : 1;
+			// Unsigned arithmetic, the span may not fit in a ccs_int_t
+			sizes[i] = (size_t)(((uint64_t)upper.i - (uint64_t)lower.i - 1) /
+			                    (uint64_t)steps[i] + 1);
+			combination[i] = ccs_int(lower.i);
+		} else
+			goto end;
+		CCS_VALIDATE_ERR_GOTO(err, _has_default_distribution(
+			hwrapper, &default_distribution), end);
+		if (!default_distribution)
+			goto end;
+		if (sizes[i] > CCS_DISTINCT_MAX_COMBINATIONS / combinations)
+			goto end;
+		combinations *= sizes[i];
+		ranks[i] = 0;
+	}
+	for (size_t c = 0; c < combinations; c++) {
+		size_t i;
+		ccs_bool_t valid;
+		memcpy(values, combination, num_hyperparameters * sizeof(ccs_datum_t));
+		CCS_VALIDATE_ERR_GOTO(err, _set_actives(configuration_space, values),
+		                      end);
+		for (i = 0; i < num_hyperparameters; i++)
+			if (values[i].type == CCS_INACTIVE && ranks[i])
+				break;
+		if (i == num_hyperparameters) {
+			CCS_VALIDATE_ERR_GOTO(err, _test_forbidden(
+				configuration_space, values, 0, &valid), end);
+			if (valid)
+				count++;
+		}
+		for (i = 0; i < num_hyperparameters; i++) {
+			ccs_hyperparameter_t hyperparameter =
+				((_ccs_hyperparameter_wrapper_cs_t *)
+					utarray_eltptr(array, i))->hyperparameter;
+			if (++ranks[i] == sizes[i])
+				ranks[i] = 0;
+			if (steps[i])
+				combination[i] = ccs_int(
+					lowers[i] + (ccs_int_t)ranks[i] * steps[i]);
+			else
+				combination[i] = _ccs_categorical_hyperparameter_get_value(
+					hyperparameter, ranks[i]);
+			if (ranks[i])
+				break;
+		}
+	}
+	data->num_distinct = count;
+end:
+	free((void *)mem);
+	if (err == CCS_SUCCESS)
+		data->num_distinct_ok = 1;
+	return err;
+}
 
-	_ccs_hyperparameter_wrapper_cs_t *wrapper = NULL;
-	size_t index = 0;
-	while ( (wrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_next(array, wrapper)) ) {
-		size_t in_edges = utarray_len(wrapper->parents);
-		list[index].in_edges = in_edges;
-		list[index].index = index;
-		if (in_edges == 0)
-			DL_APPEND(queue, list + index);
-		index++;
-	}
-	size_t processed = 0;
-	while(queue) {
-		struct _hyper_list_s *e = queue;
-		DL_DELETE(queue, queue);
-		wrapper = (_ccs_hyperparameter_wrapper_cs_t *)
-			utarray_eltptr(array, e->index);
-		size_t *child = NULL;
-		while ( (child = (size_t *)utarray_next(wrapper->children, child)) ) {
-			list[*child].in_edges--;
-			if (list[*child].in_edges == 0) {
-				DL_APPEND(queue, list + *child);
-			}
+static inline int
+_sampling_exhausted(_ccs_configuration_space_data_t *data) {
+	return data->unique_sampling &&
+	       HASH_COUNT(data->sampled_configurations) >= data->num_distinct;
+}
+
+ccs_result_t
+ccs_configuration_space_exclude_configurations(
+		ccs_configuration_space_t  configuration_space,
+		size_t                     num_configurations,
+		ccs_configuration_t       *configurations) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	CCS_CHECK_ARY(num_configurations, configurations);
+	size_t num_hyperparameters =
+		utarray_len(configuration_space->data->hyperparameters);
+	ccs_result_t err = CCS_SUCCESS;
+	for (size_t i = 0; i < num_configurations; i++) {
+		CCS_CHECK_OBJ(configurations[i], CCS_CONFIGURATION);
+		if (configurations[i]->data->configuration_space != configuration_space)
+			return -CCS_INVALID_CONFIGURATION;
+	}
+	if (!num_configurations || !num_hyperparameters)
+		return CCS_SUCCESS;
+	ccs_datum_t *values = (ccs_datum_t *)malloc(
+		num_hyperparameters * sizeof(ccs_datum_t));
+	if (!values)
+		return -CCS_OUT_OF_MEMORY;
+	for (size_t i = 0; i < num_configurations; i++) {
+		ccs_bool_t is_new;
+		err = _check_configuration(configuration_space,
+		                           configurations[i]->data->num_values,
+		                           configurations[i]->data->values);
+		if (err == -CCS_INVALID_CONFIGURATION) {
+			err = CCS_SUCCESS;
+			continue;
 		}
-		utarray_push_back(configuration_space->data->sorted_indexes, &(e->index));
-		processed++;
-	};
-	free(list);
-	if (processed < count)
-		return -CCS_INVALID_GRAPH;
+		if (err != CCS_SUCCESS)
+			goto end;
+		// Use the values owned by the hyperparameters
+		for (size_t j = 0; j < num_hyperparameters; j++) {
+			values[j] = configurations[i]->data->values[j];
+			if (values[j].type != CCS_INACTIVE)
+				CCS_VALIDATE_ERR_GOTO(err, ccs_context_validate_value(
+					(ccs_context_t)configuration_space, j, values[j],
+					values + j), end);
+		}
+		CCS_VALIDATE_ERR_GOTO(err, _add_sampled_configuration(
+			configuration_space, values, &is_new), end);
+	}
+end:
+	free(values);
+	return err;
+}
+
+
+// Forbidden clauses that only reference unconditional hyperparameters sampled
+// from their own distribution are enforced while sampling them: these
+// hyperparameters are sampled from their distribution restricted to the
+// values, or combinations of values, that the clauses allow. As their values
+// are independent of the other hyperparameters, this samples from the same
+// distribution as rejecting whole configurations, without the rejections.
+// Rejecting configurations on a conditional hyperparameter also favors the
+// parent values that deactivate it, so those clauses, and clauses over
+// several hyperparameters that are not all categorical, ordinal or discrete,
+// are left to the forbidden clauses test.
+
+static inline int
+_is_ranked_type(ccs_hyperparameter_type_t type) {
+	return type == CCS_HYPERPARAMETER_TYPE_CATEGORICAL ||
+	       type == CCS_HYPERPARAMETER_TYPE_ORDINAL ||
+	       type == CCS_HYPERPARAMETER_TYPE_DISCRETE;
+}
+
+static inline size_t
+_find_group(size_t *groups, size_t index) {
+	while (groups[index] != index) {
+		groups[index] = groups[groups[index]];
+		index = groups[index];
+	}
+	return index;
+}
+
+static const UT_icd _datum_icd = {
+	sizeof(ccs_datum_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+// Gets the value of a numerical literal, possibly negated.
+static ccs_result_t
+_numerical_constant(ccs_expression_t  expression,
+                    ccs_datum_t      *value_ret) {
+	ccs_expression_type_t type;
+	CCS_VALIDATE(ccs_expression_get_type(expression, &type));
+	if (type == CCS_POSITIVE || type == CCS_NEGATIVE) {
+		ccs_expression_t node;
+		CCS_VALIDATE(ccs_expression_get_nodes(expression, 1, &node, NULL));
+		CCS_VALIDATE(_numerical_constant(node, value_ret));
+		if (type == CCS_NEGATIVE) {
+			if (value_ret->type == CCS_FLOAT)
+				value_ret->value.f = -value_ret->value.f;
+			else if (value_ret->value.i == INT64_MIN)
+				return -CCS_INVALID_EXPRESSION;
+			else
+				value_ret->value.i = -value_ret->value.i;
+		}
+		return CCS_SUCCESS;
+	}
+	if (type != CCS_LITERAL)
+		return -CCS_INVALID_EXPRESSION;
+	CCS_VALIDATE(ccs_literal_get_value(expression, value_ret));
+	if (value_ret->type != CCS_INTEGER && value_ret->type != CCS_FLOAT)
+		return -CCS_INVALID_EXPRESSION;
 	return CCS_SUCCESS;
 }
 
 #undef  utarray_oom
 #define utarray_oom() { \
 	err = -CCS_OUT_OF_MEMORY; \
-	goto errmem; \
+	goto end; \
+}
+// Collects in points the numerical literals a forbidden clause over a single
+// numerical hyperparameter compares it to. The clause is constant between
+// these literals if it only combines such comparisons with boolean
+// operators, which is checked: other clauses return -CCS_INVALID_EXPRESSION.
+static ccs_result_t
+_collect_breakpoints(ccs_expression_t  expression,
+                     UT_array         *points) {
+	ccs_result_t err = CCS_SUCCESS;
+	ccs_expression_type_t type, types[2];
+	ccs_expression_t nodes[2];
+	ccs_expression_t *list = NULL;
+	ccs_datum_t value;
+	size_t num_nodes;
+	CCS_VALIDATE(ccs_expression_get_type(expression, &type));
+	CCS_VALIDATE(ccs_expression_get_num_nodes(expression, &num_nodes));
+	switch (type) {
+	case CCS_OR:
+	case CCS_AND:
+	case CCS_NOT:
+		CCS_VALIDATE(ccs_expression_get_nodes(expression, 2, nodes, NULL));
+		for (size_t i = 0; i < num_nodes; i++)
+			CCS_VALIDATE(_collect_breakpoints(nodes[i], points));
+		return CCS_SUCCESS;
+	case CCS_EQUAL:
+	case CCS_NOT_EQUAL:
+	case CCS_LESS:
+	case CCS_GREATER:
+	case CCS_LESS_OR_EQUAL:
+	case CCS_GREATER_OR_EQUAL:
+	case CCS_IN:
+		break;
+	default:
+		return -CCS_INVALID_EXPRESSION;
+	}
+	CCS_VALIDATE(ccs_expression_get_nodes(expression, 2, nodes, NULL));
+	CCS_VALIDATE(ccs_expression_get_type(nodes[0], types));
+	CCS_VALIDATE(ccs_expression_get_type(nodes[1], types + 1));
+	if (type != CCS_IN) {
+		if (types[0] != CCS_VARIABLE && types[1] != CCS_VARIABLE)
+			return -CCS_INVALID_EXPRESSION;
+		CCS_VALIDATE(_numerical_constant(
+			types[0] == CCS_VARIABLE ? nodes[1] : nodes[0], &value));
+		utarray_push_back(points, &value);
+		return CCS_SUCCESS;
+	}
+	if (types[0] != CCS_VARIABLE || types[1] != CCS_LIST)
+		return -CCS_INVALID_EXPRESSION;
+	CCS_VALIDATE(ccs_expression_get_num_nodes(nodes[1], &num_nodes));
+	if (!num_nodes)
+		return CCS_SUCCESS;
+	list = (ccs_expression_t *)malloc(num_nodes * sizeof(ccs_expression_t));
+	if (!list)
+		return -CCS_OUT_OF_MEMORY;
+	CCS_VALIDATE_ERR_GOTO(err, ccs_expression_get_nodes(nodes[1], num_nodes,
+		list, NULL), end);
+	for (size_t i = 0; i < num_nodes; i++) {
+		CCS_VALIDATE_ERR_GOTO(err, _numerical_constant(list[i], &value), end);
+		utarray_push_back(points, &value);
+	}
+end:
+	free(list);
+	return err;
+}
+
+static int
+_float_cmp(const void *a, const void *b) {
+	ccs_float_t fa = *(const ccs_float_t *)a;
+	ccs_float_t fb = *(const ccs_float_t *)b;
+	return fa < fb ? -1 : fa > fb ? 1 : 0;
+}
+
+static int
+_int_cmp(const void *a, const void *b) {
+	ccs_int_t ia = *(const ccs_int_t *)a;
+	ccs_int_t ib = *(const ccs_int_t *)b;
+	return ia < ib ? -1 : ia > ib ? 1 : 0;
+}
+
+// Tests whether one of the num_steps steps rejects values.
+static inline ccs_result_t
+_test_restriction_steps(_ccs_configuration_space_data_t *data,
+                        const _ccs_forbidden_step_t     *steps,
+                        size_t                           num_steps,
+                        ccs_datum_t                     *values,
+                        ccs_datum_t                     *stack,
+                        ccs_bool_t                      *rejected) {
+	*rejected = CCS_FALSE;
+	for (size_t i = 0; i < num_steps && !*rejected; i++)
+		CCS_VALIDATE(_test_forbidden_step(data, steps + i, values, stack,
+		                                  rejected));
+	return CCS_SUCCESS;
+}
+
+// Splits the sampling interval of the numerical hyperparameter at index at the
+// literals its num_steps steps compare it to, into these literals and the
+// intervals between them, over which the steps are constant. The unions of
+// consecutive cells that the steps allow are appended to the restriction
+// cells, and their number returned in num_cells_ret. values holds a
+// configuration where the other hyperparameters are inactive.
+static ccs_result_t
+_restrict_numerical(ccs_configuration_space_t    configuration_space,
+                    size_t                       index,
+                    const _ccs_forbidden_step_t *steps,
+                    size_t                       num_steps,
+                    ccs_datum_t                 *values,
+                    ccs_datum_t                 *stack,
+                    size_t                      *num_cells_ret) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	_ccs_hyperparameter_wrapper_cs_t *wrapper =
+		(_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(
+			data->hyperparameters, index);
+	ccs_result_t err = CCS_SUCCESS;
+	ccs_interval_t interval, merged;
+	UT_array *points = NULL;
+	ccs_numeric_t *bounds = NULL;
+	ccs_interval_t *cells = NULL;
+	size_t num_bounds = 0, num_cells = 0, num_points;
+	int open = 0;
+	*num_cells_ret = 0;
+	CCS_VALIDATE(ccs_hyperparameter_sampling_interval(wrapper->hyperparameter,
+	                                                  &interval));
+	utarray_new(points, &_datum_icd);
+	for (size_t i = 0; i < num_steps; i++)
+		CCS_VALIDATE_ERR_GOTO(err, _collect_breakpoints(
+			*(ccs_expression_t *)utarray_eltptr(data->forbidden_clauses,
+			                                    steps[i].clause),
+			points), end);
+	num_points = utarray_len(points);
+	bounds = (ccs_numeric_t *)malloc(2 * num_points * sizeof(ccs_numeric_t) +
+		(4 * num_points + 3) * sizeof(ccs_interval_t));
+	if (!bounds) {
+		err = -CCS_OUT_OF_MEMORY;
+		goto end;
+	}
+	cells = (ccs_interval_t *)(bounds + 2 * num_points);
+	// The cells are the bounds, and the intervals between them, in
+	// increasing order. Float bounds are the literals inside the interval.
+	// Integer bounds are the closest integers to the literals.
+	if (interval.type == CCS_NUM_FLOAT) {
+		for (size_t i = 0; i < num_points; i++) {
+			ccs_datum_t *p = (ccs_datum_t *)utarray_eltptr(points, i);
+			ccs_float_t f = p->type == CCS_FLOAT ?
+				p->value.f : (ccs_float_t)p->value.i;
+			if (f > interval.lower.f && f < interval.upper.f)
+				bounds[num_bounds++].f = f;
+		}
+		qsort(bounds, num_bounds, sizeof(ccs_numeric_t), &_float_cmp);
+		ccs_interval_t cell = interval;
+		if (interval.lower_included) {
+			cell.upper = interval.lower;
+			cell.upper_included = CCS_TRUE;
+			cells[num_cells++] = cell;
+		}
+		cell.lower_included = CCS_FALSE;
+		for (size_t i = 0; i < num_bounds; i++) {
+			if (i && bounds[i].f == bounds[i - 1].f)
+				continue;
+			cell.upper = bounds[i];
+			cell.upper_included = CCS_FALSE;
+			cells[num_cells++] = cell;
+			cell.lower = cell.upper = bounds[i];
+			cell.lower_included = cell.upper_included = CCS_TRUE;
+			cells[num_cells++] = cell;
+			cell.lower_included = CCS_FALSE;
+		}
+		cell.upper = interval.upper;
+		cell.upper_included = CCS_FALSE;
+		cells[num_cells++] = cell;
+		if (interval.upper_included) {
+			cell.lower = cell.upper = interval.upper;
+			cell.lower_included = cell.upper_included = CCS_TRUE;
+			cells[num_cells++] = cell;
+		}
+	} else {
+		ccs_int_t lower = interval.lower.i + !interval.lower_included;
+		ccs_int_t upper = interval.upper.i - !interval.upper_included;
+		for (size_t i = 0; i < num_points; i++) {
+			ccs_datum_t *p = (ccs_datum_t *)utarray_eltptr(points, i);
+			if (p->type == CCS_INTEGER) {
+				if (p->value.i >= lower && p->value.i <= upper)
+					bounds[num_bounds++].i = p->value.i;
+			} else if (p->value.f >= (ccs_float_t)lower &&
+			           p->value.f <= (ccs_float_t)upper) {
+				bounds[num_bounds++].i = (ccs_int_t)floor(p->value.f);
+				bounds[num_bounds++].i = (ccs_int_t)ceil(p->value.f);
+			}
+		}
+		qsort(bounds, num_bounds, sizeof(ccs_numeric_t), &_int_cmp);
+		ccs_interval_t cell = interval;
+		cell.lower_included = cell.upper_included = CCS_TRUE;
+		cell.lower.i = lower;
+		for (size_t i = 0; i < num_bounds; i++) {
+			if (bounds[i].i < cell.lower.i)
+				continue;
+			if (bounds[i].i > cell.lower.i) {
+				cell.upper.i = bounds[i].i - 1;
+				cells[num_cells++] = cell;
+			}
+			cell.lower = cell.upper = bounds[i];
+			cells[num_cells++] = cell;
+			if (bounds[i].i == upper)
+				break;
+			cell.lower.i = bounds[i].i + 1;
+		}
+		if (cell.lower.i <= upper && (!num_cells ||
+		    cells[num_cells - 1].upper.i < upper)) {
+			cell.upper.i = upper;
+			cells[num_cells++] = cell;
+		}
+	}
+	// Test each cell on a value inside it, and merge the consecutive cells
+	// the steps allow.
+	for (size_t i = 0; i < num_cells; i++) {
+		ccs_bool_t rejected;
+		if (cells[i].type == CCS_NUM_FLOAT) {
+			ccs_float_t f = cells[i].lower.f +
+				(cells[i].upper.f - cells[i].lower.f) * 0.5;
+			if (!cells[i].lower_included &&
+			    (f <= cells[i].lower.f || f >= cells[i].upper.f))
+				continue;
+			values[index] = ccs_float(f);
+		} else
+			values[index] = ccs_int(cells[i].lower.i);
+		CCS_VALIDATE_ERR_GOTO(err, _test_restriction_steps(data, steps,
+			num_steps, values, stack, &rejected), end);
+		if (!rejected) {
+			if (open) {
+				merged.upper = cells[i].upper;
+				merged.upper_included = cells[i].upper_included;
+			} else
+				merged = cells[i];
+			open = 1;
+		} else if (open) {
+			utarray_push_back(data->restriction_cells, &merged);
+			(*num_cells_ret)++;
+			open = 0;
+		}
+	}
+	if (open) {
+		utarray_push_back(data->restriction_cells, &merged);
+		(*num_cells_ret)++;
+	}
+end:
+	values[index] = ccs_inactive;
+	if (points)
+		utarray_free(points);
+	free(bounds);
+	return err;
+}
+
+// Appends the variables of the categorical, ordinal or discrete
+// hyperparameters at the num_members indexes in members to the restriction
+// variables, with one cell per value rank, and the cumulative masses of
+// their combinations to the restriction masses. num_combinations_ret
+// receives the number of combinations.
+static ccs_result_t
+_restrict_ranked(ccs_configuration_space_t    configuration_space,
+                 size_t                       num_members,
+                 const size_t                *members,
+                 const _ccs_forbidden_step_t *steps,
+                 size_t                       num_steps,
+                 ccs_datum_t                 *values,
+                 ccs_datum_t                 *stack,
+                 size_t                      *num_combinations_ret) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	ccs_result_t err = CCS_SUCCESS;
+	_ccs_restriction_variable_t *variables;
+	size_t first = utarray_len(data->restriction_variables);
+	size_t num_combinations = 1, num_cells = 0;
+	ccs_float_t *cell_masses = NULL;
+	size_t *ranks = NULL;
+	ccs_float_t mass = 0.0;
+	for (size_t i = 0; i < num_members; i++) {
+		_ccs_hyperparameter_wrapper_cs_t *wrapper =
+			(_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(
+				data->hyperparameters, members[i]);
+		_ccs_restriction_variable_t variable;
+		variable.index = members[i];
+		variable.cells = utarray_len(data->restriction_cells);
+		variable.num_cells = _ccs_categorical_hyperparameter_get_num_values(
+			wrapper->hyperparameter);
+		variable.stride = 0;
+		for (size_t r = 0; r < variable.num_cells; r++) {
+			ccs_interval_t cell;
+			cell.type = CCS_NUM_INTEGER;
+			cell.lower = cell.upper = CCSI((ccs_int_t)r);
+			cell.lower_included = cell.upper_included = CCS_TRUE;
+			utarray_push_back(data->restriction_cells, &cell);
+		}
+		utarray_push_back(data->restriction_variables, &variable);
+		num_combinations *= variable.num_cells;
+		num_cells += variable.num_cells;
+	}
+	cell_masses = (ccs_float_t *)malloc(num_cells * sizeof(ccs_float_t) +
+	                                    num_members * sizeof(size_t));
+	if (!cell_masses)
+		return -CCS_OUT_OF_MEMORY;
+	ranks = (size_t *)(cell_masses + num_cells);
+	variables = (_ccs_restriction_variable_t *)utarray_eltptr(
+		data->restriction_variables, first);
+	for (size_t i = num_members, stride = 1; i > 0; i--) {
+		variables[i - 1].stride = stride;
+		stride *= variables[i - 1].num_cells;
+	}
+	for (size_t i = 0, k = 0; i < num_members; i++) {
+		_ccs_hyperparameter_wrapper_cs_t *wrapper =
+			(_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(
+				data->hyperparameters, variables[i].index);
+		for (size_t r = 0; r < variables[i].num_cells; r++, k++)
+			CCS_VALIDATE_ERR_GOTO(err, _ccs_distribution_interval_mass(
+				wrapper->distribution->distribution,
+				(ccs_interval_t *)utarray_eltptr(data->restriction_cells,
+				                                 variables[i].cells + r),
+				cell_masses + k), end);
+		ranks[i] = 0;
+	}
+	utarray_push_back(data->restriction_masses, &mass);
+	for (size_t c = 0; c < num_combinations; c++) {
+		ccs_float_t m = 1.0;
+		ccs_bool_t rejected;
+		for (size_t i = 0, k = 0; i < num_members; i++) {
+			_ccs_hyperparameter_wrapper_cs_t *wrapper =
+				(_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(
+					data->hyperparameters, variables[i].index);
+			values[variables[i].index] =
+				_ccs_categorical_hyperparameter_get_value(
+					wrapper->hyperparameter, ranks[i]);
+			m *= cell_masses[k + ranks[i]];
+			k += variables[i].num_cells;
+		}
+		CCS_VALIDATE_ERR_GOTO(err, _test_restriction_steps(data, steps,
+			num_steps, values, stack, &rejected), end);
+		if (!rejected)
+			mass += m;
+		utarray_push_back(data->restriction_masses, &mass);
+		for (size_t i = num_members; i > 0; i--) {
+			if (++ranks[i - 1] < variables[i - 1].num_cells)
+				break;
+			ranks[i - 1] = 0;
+		}
+	}
+	*num_combinations_ret = num_combinations;
+end:
+	for (size_t i = 0; i < num_members; i++)
+		values[members[i]] = ccs_inactive;
+	free(cell_masses);
+	return err;
 }
+
+// Builds the restrictions of the hyperparameters. Clauses over several
+// categorical, ordinal or discrete hyperparameters group them, unless their
+// group would have more than CCS_TABLE_MAX_SIZE combinations of values. A
+// restriction is then built for each group, from the clauses that only
+// reference its hyperparameters.
 static ccs_result_t
-_recompute_graph(ccs_configuration_space_t configuration_space) {
+_generate_restrictions(ccs_configuration_space_t configuration_space) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	if (data->restrictions_ok)
+		return CCS_SUCCESS;
+	ccs_result_t err = CCS_SUCCESS;
+	UT_array *array = data->hyperparameters;
+	size_t num_hyperparameters = utarray_len(array);
+	size_t num_steps = utarray_len(data->forbidden_plan);
+	_ccs_forbidden_step_t *steps =
+		(_ccs_forbidden_step_t *)utarray_front(data->forbidden_plan);
 	_ccs_hyperparameter_wrapper_cs_t *wrapper = NULL;
-	UT_array *array = configuration_space->data->hyperparameters;
-	while ( (wrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_next(array, wrapper)) ) {
-		utarray_clear(wrapper->parents);
-		utarray_clear(wrapper->children);
+	size_t num_references = 0;
+	uintptr_t mem;
+	ccs_datum_t *values, *stack;
+	size_t *offsets, *references, *groups, *sizes, *members;
+	ccs_hyperparameter_t *hyperparameters;
+	int *kinds;
+
+	utarray_clear(data->restrictions);
+	utarray_clear(data->restriction_variables);
+	utarray_clear(data->restriction_steps);
+	utarray_clear(data->restriction_cells);
+	utarray_clear(data->restriction_masses);
+	while ( (wrapper = (_ccs_hyperparameter_wrapper_cs_t *)
+	           utarray_next(array, wrapper)) )
+		wrapper->restriction = SIZE_MAX;
+	for (size_t i = 0; i < num_steps; i++) {
+		size_t count;
+		CCS_VALIDATE(ccs_expression_get_hyperparameters(
+			*(ccs_expression_t *)utarray_eltptr(data->forbidden_clauses,
+			                                    steps[i].clause),
+			0, NULL, &count));
+		num_references += count;
 	}
-	wrapper = NULL;
-	intptr_t mem = 0;
-	ccs_result_t err;
-	for (size_t index = 0; index < utarray_len(array); index++) {
-		wrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, (unsigned int)index);
-		if (!wrapper->condition)
+	mem = (uintptr_t)malloc(
+		(num_hyperparameters + data->constraints_stack_size) *
+			sizeof(ccs_datum_t) +
+		(num_steps + 1 + num_references + 3 * num_hyperparameters) *
+			sizeof(size_t) +
+		num_references * sizeof(ccs_hyperparameter_t) +
+		num_hyperparameters * sizeof(int));
+	if (!mem)
+		return -CCS_OUT_OF_MEMORY;
+	values = (ccs_datum_t *)mem;
+	stack = values + num_hyperparameters;
+	offsets = (size_t *)(stack + data->constraints_stack_size);
+	references = offsets + num_steps + 1;
+	groups = references + num_references;
+	sizes = groups + num_hyperparameters;
+	members = sizes + num_hyperparameters;
+	hyperparameters = (ccs_hyperparameter_t *)(members + num_hyperparameters);
+	kinds = (int *)(hyperparameters + num_references);
+
+	// Hyperparameters that can be restricted: 1 for categorical, ordinal
+	// and discrete ones, 2 for numerical ones.
+	for (size_t i = 0; i < num_hyperparameters; i++) {
+		ccs_hyperparameter_type_t type;
+		ccs_numeric_type_t data_type;
+		ccs_interval_t interval;
+		wrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, i);
+		values[i] = ccs_inactive;
+		groups[i] = i;
+		sizes[i] = 1;
+		kinds[i] = 0;
+		if (wrapper->condition || wrapper->distribution->dimension != 1)
 			continue;
+		CCS_VALIDATE_ERR_GOTO(err, ccs_hyperparameter_get_type(
+			wrapper->hyperparameter, &type), end);
+		CCS_VALIDATE_ERR_GOTO(err, ccs_distribution_get_data_types(
+			wrapper->distribution->distribution, &data_type), end);
+		CCS_VALIDATE_ERR_GOTO(err, ccs_hyperparameter_sampling_interval(
+			wrapper->hyperparameter, &interval), end);
+		if (interval.type != data_type)
+			continue;
+		if (_is_ranked_type(type)) {
+			kinds[i] = 1;
+			sizes[i] = _ccs_categorical_hyperparameter_get_num_values(
+				wrapper->hyperparameter);
+		} else if (type == CCS_HYPERPARAMETER_TYPE_NUMERICAL)
+			kinds[i] = 2;
+	}
+
+	offsets[0] = 0;
+	for (size_t i = 0; i < num_steps; i++) {
 		size_t count;
-		CCS_VALIDATE_ERR_GOTO(err, ccs_expression_get_hyperparameters(wrapper->condition, 0, NULL, &count), errmem);
-		if (count == 0)
+		CCS_VALIDATE_ERR_GOTO(err, ccs_expression_get_hyperparameters(
+			*(ccs_expression_t *)utarray_eltptr(data->forbidden_clauses,
+			                                    steps[i].clause),
+			num_references - offsets[i], hyperparameters + offsets[i],
+			&count), end);
+		CCS_VALIDATE_ERR_GOTO(err,
+			ccs_configuration_space_get_hyperparameter_indexes(
+				configuration_space, count, hyperparameters + offsets[i],
+				references + offsets[i]), end);
+		offsets[i + 1] = offsets[i] + count;
+	}
+
+	// Group the hyperparameters of clauses over several categorical,
+	// ordinal or discrete hyperparameters.
+	for (size_t i = 0; i < num_steps; i++) {
+		size_t *refs = references + offsets[i];
+		size_t count = offsets[i + 1] - offsets[i];
+		size_t size = 1, j, k;
+		if (count < 2)
 			continue;
-		ccs_hyperparameter_t *parents = NULL;
-		size_t               *parents_index = NULL;
-		_ccs_hyperparameter_wrapper_cs_t *parent_wrapper = NULL;
-		intptr_t oldmem = mem;
-		mem = (intptr_t)realloc((void *)oldmem, count *
-			(sizeof(ccs_hyperparameter_t) + sizeof(size_t)));
-		if (!mem) {
-			mem = oldmem;
-			err = -CCS_OUT_OF_MEMORY;
-			goto errmem;
+		for (j = 0; j < count; j++) {
+			size_t group;
+			if (kinds[refs[j]] != 1)
+				break;
+			group = _find_group(groups, refs[j]);
+			for (k = 0; k < j; k++)
+				if (_find_group(groups, refs[k]) == group)
+					break;
+			if (k < j)
+				continue;
+			if (sizes[group] > CCS_TABLE_MAX_SIZE / size)
+				break;
+			size *= sizes[group];
 		}
-		parents = (ccs_hyperparameter_t *)mem;
-		parents_index = (size_t *)(mem + count * sizeof(ccs_hyperparameter_t));
-		CCS_VALIDATE_ERR_GOTO(err, ccs_expression_get_hyperparameters(
-		    wrapper->condition, count, parents, NULL), errmem);
-		CCS_VALIDATE_ERR_GOTO(err, ccs_configuration_space_get_hyperparameter_indexes(
-		    configuration_space, count, parents, parents_index), errmem);
-		for (size_t i = 0; i < count; i++) {
-			utarray_push_back(wrapper->parents, parents_index + i);
-			parent_wrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, parents_index[i]);
-			utarray_push_back(parent_wrapper->children, &index);
+		if (j < count)
+			continue;
+		for (j = 1; j < count; j++)
+			groups[_find_group(groups, refs[j])] =
+				_find_group(groups, refs[0]);
+		sizes[_find_group(groups, refs[0])] = size;
+	}
+
+	for (size_t g = 0; g < num_hyperparameters; g++) {
+		_ccs_restriction_t restriction;
+		size_t num_members = 0;
+		if (!kinds[g] || _find_group(groups, g) != g)
+			continue;
+		restriction.variables = utarray_len(data->restriction_variables);
+		restriction.num_variables = 0;
+		restriction.steps = utarray_len(data->restriction_steps);
+		restriction.num_steps = 0;
+		restriction.masses = utarray_len(data->restriction_masses);
+		restriction.num_combinations = 0;
+		for (size_t i = 0; i < num_steps; i++) {
+			size_t j;
+			for (j = offsets[i]; j < offsets[i + 1]; j++)
+				if (!kinds[references[j]] ||
+				    _find_group(groups, references[j]) != g)
+					break;
+			if (j < offsets[i + 1] || offsets[i] == offsets[i + 1])
+				continue;
+			utarray_push_back(data->restriction_steps, steps + i);
+			restriction.num_steps++;
 		}
+		if (!restriction.num_steps)
+			continue;
+		for (size_t i = 0; i < num_hyperparameters; i++)
+			if (kinds[i] && _find_group(groups, i) == g)
+				members[num_members++] = i;
+		size_t cells = utarray_len(data->restriction_cells);
+		_ccs_forbidden_step_t *rsteps =
+			(_ccs_forbidden_step_t *)utarray_eltptr(
+				data->restriction_steps, restriction.steps);
+		if (kinds[g] == 1)
+			err = _restrict_ranked(configuration_space, num_members,
+				members, rsteps, restriction.num_steps, values, stack,
+				&restriction.num_combinations);
+		else {
+			_ccs_restriction_variable_t variable = { g, cells, 0, 1 };
+			ccs_float_t mass = 0.0;
+			err = _restrict_numerical(configuration_space, g, rsteps,
+				restriction.num_steps, values, stack, &variable.num_cells);
+			if (!err) {
+				utarray_push_back(data->restriction_variables, &variable);
+				utarray_push_back(data->restriction_masses, &mass);
+				for (size_t c = 0; !err && c < variable.num_cells; c++) {
+					ccs_float_t m;
+					err = _ccs_distribution_interval_mass(
+						((_ccs_hyperparameter_wrapper_cs_t *)
+							utarray_eltptr(array, g))->distribution->distribution,
+						(ccs_interval_t *)utarray_eltptr(
+							data->restriction_cells, cells + c), &m);
+					mass += m;
+					utarray_push_back(data->restriction_masses, &mass);
+				}
+				restriction.num_combinations = variable.num_cells;
+			}
+		}
+		if (err == -CCS_OUT_OF_MEMORY)
+			goto end;
+		// Restrictions that failed or leave no mass are dropped, and a
+		// single hyperparameter then has its rejected values redrawn.
+		if (err || !restriction.num_combinations ||
+		    *(ccs_float_t *)utarray_back(data->restriction_masses) <= 0.0) {
+			err = CCS_SUCCESS;
+			utarray_resize(data->restriction_variables, restriction.variables);
+			utarray_resize(data->restriction_cells, cells);
+			utarray_resize(data->restriction_masses, restriction.masses);
+			restriction.num_combinations = 0;
+			if (num_members > 1) {
+				utarray_resize(data->restriction_steps, restriction.steps);
+				continue;
+			}
+			_ccs_restriction_variable_t variable = { g, cells, 0, 1 };
+			utarray_push_back(data->restriction_variables, &variable);
+		}
+		restriction.num_variables = num_members;
+		for (size_t i = 0; i < num_members; i++)
+			((_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(
+				array, members[i]))->restriction =
+				utarray_len(data->restrictions);
+		utarray_push_back(data->restrictions, &restriction);
+	}
+	data->restrictions_ok = 1;
+end:
+	free((void *)mem);
+	return err;
+}
+
+#undef  utarray_oom
+#define utarray_oom() exit(-1)
+
+// Samples the hyperparameters of a restriction for the num_configurations rows
+// of values, by inverting the cumulative masses of the combinations of cells,
+// one variable after the other: each variable picks its cell, among the
+// combinations left by the previous variables, with its own coordinate, taken
+// from the design in uniforms if it is not NULL, with a stride of the number
+// of hyperparameters, or drawn at random. The position of the coordinate in
+// the mass of the chosen cell is then mapped through the distribution of the
+// hyperparameter truncated to the cell.
+static ccs_result_t
+_sample_restriction(ccs_configuration_space_t  configuration_space,
+                    ccs_rng_t                  rng,
+                    const _ccs_restriction_t  *restriction,
+                    size_t                     num_configurations,
+                    ccs_datum_t               *values,
+                    const ccs_float_t         *uniforms) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	size_t num_hyperparameters = utarray_len(data->hyperparameters);
+	size_t num_variables = restriction->num_variables;
+	_ccs_restriction_variable_t *variables =
+		(_ccs_restriction_variable_t *)utarray_eltptr(
+			data->restriction_variables, restriction->variables);
+	ccs_float_t *masses = (ccs_float_t *)utarray_eltptr(
+		data->restriction_masses, restriction->masses);
+	size_t num_uniforms = num_configurations * num_variables;
+	size_t max_cells = 0;
+	ccs_result_t err = CCS_SUCCESS;
+	for (size_t i = 0; i < num_variables; i++)
+		if (variables[i].num_cells > max_cells)
+			max_cells = variables[i].num_cells;
+	uintptr_t mem = (uintptr_t)malloc(
+		num_configurations * sizeof(ccs_datum_t) +
+		(num_uniforms + num_configurations) * sizeof(ccs_float_t) +
+		(num_uniforms + num_configurations + max_cells + 1) * sizeof(size_t));
+	if (!mem)
+		return -CCS_OUT_OF_MEMORY;
+	ccs_datum_t *results = (ccs_datum_t *)mem;
+	ccs_float_t *us = (ccs_float_t *)(results + num_configurations);
+	ccs_float_t *cell_us = us + num_uniforms;
+	size_t *cells = (size_t *)(cell_us + num_configurations);
+	size_t *order = cells + num_uniforms;
+	size_t *offsets = order + num_configurations;
+
+	if (uniforms) {
+		for (size_t j = 0; j < num_configurations; j++)
+			for (size_t i = 0; i < num_variables; i++)
+				us[j*num_variables + i] =
+					uniforms[j*num_hyperparameters + variables[i].index];
+	} else
+		CCS_VALIDATE_ERR_GOTO(err, ccs_rng_uniform_fill(rng, num_uniforms, us),
+		                      end);
+	for (size_t j = 0; j < num_configurations; j++) {
+		size_t start = 0, end = restriction->num_combinations;
+		for (size_t i = 0; i < num_variables; i++) {
+			size_t stride = variables[i].stride;
+			ccs_float_t *u = us + j*num_variables + i;
+			ccs_float_t target = masses[start] +
+				*u * (masses[end] - masses[start]);
+			size_t lo = 0, hi = variables[i].num_cells - 1;
+			// Last cell starting at or before target, skipping the
+			// empty cells rounding may land on.
+			while (lo < hi) {
+				size_t mid = lo + (hi - lo + 1) / 2;
+				if (masses[start + mid*stride] <= target)
+					lo = mid;
+				else
+					hi = mid - 1;
+			}
+			while (lo && masses[start + (lo + 1)*stride] <=
+			             masses[start + lo*stride])
+				lo--;
+			ccs_float_t lower = masses[start + lo*stride];
+			ccs_float_t upper = masses[start + (lo + 1)*stride];
+			*u = upper > lower ? (target - lower) / (upper - lower) : 0.0;
+			if (*u < 0.0)
+				*u = 0.0;
+			else if (*u >= 1.0)
+				*u = nextafter(1.0, 0.0);
+			cells[j*num_variables + i] = lo;
+			start += lo * stride;
+			end = start + stride;
+		}
+	}
+	for (size_t i = 0; i < num_variables; i++) {
+		_ccs_hyperparameter_wrapper_cs_t *wrapper =
+			(_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(
+				data->hyperparameters, variables[i].index);
+		ccs_interval_t *intervals = (ccs_interval_t *)utarray_eltptr(
+			data->restriction_cells, variables[i].cells);
+		size_t num_cells = variables[i].num_cells;
+		// Sort the rows by cell
+		for (size_t c = 0; c <= num_cells; c++)
+			offsets[c] = 0;
+		for (size_t j = 0; j < num_configurations; j++)
+			offsets[cells[j*num_variables + i] + 1]++;
+		for (size_t c = 0; c < num_cells; c++)
+			offsets[c + 1] += offsets[c];
+		for (size_t j = 0; j < num_configurations; j++)
+			order[offsets[cells[j*num_variables + i]]++] = j;
+		for (size_t c = 0, first = 0; c < num_cells; first = offsets[c++]) {
+			size_t count = offsets[c] - first;
+			if (!count)
+				continue;
+			if (intervals[c].type == CCS_NUM_INTEGER &&
+			    intervals[c].lower.i == intervals[c].upper.i) {
+				CCS_VALIDATE_ERR_GOTO(err, ccs_hyperparameter_convert_samples(
+					wrapper->hyperparameter, CCS_FALSE, 1,
+					&intervals[c].lower, results), end);
+				for (size_t k = 0; k < count; k++)
+					values[order[first + k]*num_hyperparameters +
+					       variables[i].index] = results[0];
+				continue;
+			}
+			for (size_t k = 0; k < count; k++)
+				cell_us[k] = us[order[first + k]*num_variables + i];
+			CCS_VALIDATE_ERR_GOTO(err,
+				_ccs_distribution_hyperparameter_truncated_quantiles(
+					wrapper->distribution->distribution, rng,
+					wrapper->hyperparameter, intervals + c, count, cell_us,
+					results), end);
+			for (size_t k = 0; k < count; k++)
+				values[order[first + k]*num_hyperparameters +
+				       variables[i].index] = results[k];
+		}
+	}
+end:
+	free((void *)mem);
+	return err;
+}
+
+// Values of a hyperparameter whose support could not be restricted are
+// redrawn on the rows where the steps of its restriction reject them, until
+// they pass or 100 rounds have been done. Rows that still fail are rejected
+// by the forbidden clauses test. This is not done for design based sampling
+// methods, as the new values would be random draws: rejected design points are
+// replaced by further design points. rows lists the num_rows sampled rows, and
+// is overwritten.
+static ccs_result_t
+_resample_forbidden(ccs_configuration_space_t         configuration_space,
+                    ccs_rng_t                         rng,
+                    _ccs_distribution_wrapper_t      *dwrapper,
+                    _ccs_hyperparameter_wrapper_cs_t *hwrapper,
+                    const _ccs_restriction_t         *restriction,
+                    size_t                            num_rows,
+                    size_t                           *rows,
+                    ccs_datum_t                      *values,
+                    ccs_datum_t                      *scratch) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	size_t num_hyperparameters = utarray_len(data->hyperparameters);
+	size_t hindex = dwrapper->hyperparameter_indexes[0];
+	_ccs_forbidden_step_t *steps = (_ccs_forbidden_step_t *)utarray_eltptr(
+		data->restriction_steps, restriction->steps);
+	ccs_datum_t *stack = (ccs_datum_t *)alloca(
+		data->constraints_stack_size * sizeof(ccs_datum_t));
+	for (int round = 0; num_rows && round < 100; round++) {
+		size_t num_rejected = 0;
+		for (size_t j = 0; j < num_rows; j++) {
+			ccs_bool_t rejected;
+			CCS_VALIDATE(_test_restriction_steps(data, steps,
+				restriction->num_steps,
+				values + rows[j] * num_hyperparameters, stack, &rejected));
+			if (rejected)
+				rows[num_rejected++] = rows[j];
+		}
+		num_rows = num_rejected;
+		if (!num_rows)
+			break;
+		CCS_VALIDATE(ccs_distribution_hyperparameters_samples(
+			dwrapper->distribution, rng, &hwrapper->hyperparameter,
+			num_rows, scratch));
+		for (size_t j = 0; j < num_rows; j++)
+			values[rows[j] * num_hyperparameters + hindex] = scratch[j];
+	}
+	return CCS_SUCCESS;
+}
+
+// Initial direction numbers of the second to twenty-first coordinates of the
+// Sobol sequence, from Joe and Kuo, "Constructing Sobol sequences with better
+// two-dimensional projections". The following coordinates use odd initial
+// direction numbers from a fixed pseudo random sequence.
+static const uint32_t _sobol_initial_numbers[][7] = {
+	{1},
+	{1, 3},
+	{1, 3, 1},
+	{1, 1, 1},
+	{1, 1, 3, 3},
+	{1, 3, 5, 13},
+	{1, 1, 5, 5, 17},
+	{1, 1, 5, 5, 5},
+	{1, 1, 7, 11, 19},
+	{1, 1, 5, 1, 1},
+	{1, 1, 1, 3, 11},
+	{1, 3, 5, 5, 31},
+	{1, 3, 3, 9, 7, 49},
+	{1, 1, 1, 15, 21, 21},
+	{1, 3, 1, 13, 27, 49},
+	{1, 1, 1, 15, 7, 5},
+	{1, 3, 1, 15, 13, 25},
+	{1, 1, 5, 5, 19, 61},
+	{1, 3, 7, 11, 23, 15, 103},
+	{1, 3, 7, 13, 13, 15, 69}
+};
+#define CCS_SOBOL_NUM_INITIAL_NUMBERS \
+	(sizeof(_sobol_initial_numbers)/sizeof(_sobol_initial_numbers[0]))
+
+// a * b modulo the polynomial p of degree, over GF(2)
+static inline uint64_t
+_gf2_mul_mod(uint64_t a, uint64_t b, uint64_t p, unsigned degree) {
+	uint64_t r = 0;
+	for (unsigned i = 0; i < degree; i++) {
+		if ((b >> i) & 1)
+			r ^= a;
+		a <<= 1;
+		if ((a >> degree) & 1)
+			a ^= p;
+	}
+	return r;
+}
+
+// x^e modulo the polynomial p of degree, over GF(2)
+static uint64_t
+_gf2_pow_x(uint64_t e, uint64_t p, unsigned degree) {
+	uint64_t r = 1;
+	uint64_t b = (degree > 1) ? 2 : 2 ^ p;
+	for (; e; e >>= 1) {
+		if (e & 1)
+			r = _gf2_mul_mod(r, b, p, degree);
+		b = _gf2_mul_mod(b, b, p, degree);
+	}
+	return r;
+}
+
+// p is primitive iff x has order 2^degree - 1 modulo p
+static int
+_gf2_is_primitive(uint64_t p, unsigned degree) {
+	uint64_t order = (UINT64_C(1) << degree) - 1;
+	uint64_t n = order;
+	if (_gf2_pow_x(order, p, degree) != 1)
+		return 0;
+	for (uint64_t q = 2; q * q <= n; q++) {
+		if (n % q)
+			continue;
+		while (!(n % q))
+			n /= q;
+		if (_gf2_pow_x(order / q, p, degree) == 1)
+			return 0;
+	}
+	if (n > 1 && _gf2_pow_x(order / n, p, degree) == 1)
+		return 0;
+	return 1;
+}
+
+// Direction numbers of the dimension first coordinates of the Sobol
+// sequence. The primitive polynomials are enumerated by increasing degree,
+// as in the tables of Joe and Kuo.
+static void
+_sobol_directions(size_t dimension, uint32_t *directions) {
+	uint64_t p = 1;
+	unsigned degree = 0;
+	uint32_t lcg = 1;
+	for (unsigned k = 0; k < CCS_SOBOL_BITS; k++)
+		directions[k] = UINT32_C(1) << (CCS_SOBOL_BITS - 1 - k);
+	for (size_t d = 1; d < dimension; d++) {
+		uint32_t *v = directions + d * CCS_SOBOL_BITS;
+		do {
+			p += 2;
+			if (p >> (degree + 1)) {
+				degree++;
+				p = (UINT64_C(1) << degree) | 1;
+			}
+		} while (!_gf2_is_primitive(p, degree));
+		for (unsigned k = 0; k < degree; k++) {
+			uint32_t m;
+			if (d <= CCS_SOBOL_NUM_INITIAL_NUMBERS)
+				m = _sobol_initial_numbers[d - 1][k];
+			else {
+				lcg = lcg * UINT32_C(1664525) + UINT32_C(1013904223);
+				m = ((lcg >> 8) & ((UINT32_C(1) << k) - 1)) << 1 | 1;
+			}
+			v[k] = m << (CCS_SOBOL_BITS - 1 - k);
+		}
+		for (unsigned k = degree; k < CCS_SOBOL_BITS; k++) {
+			v[k] = v[k - degree] ^ (v[k - degree] >> degree);
+			for (unsigned j = 1; j < degree; j++)
+				if ((p >> (degree - j)) & 1)
+					v[k] ^= v[k - j];
+		}
+	}
+}
+
+// Restart the low discrepancy sequence of the configuration space: draw new
+// random shifts, and compute the bases or direction numbers.
+static ccs_result_t
+_restart_sequence(ccs_configuration_space_t configuration_space,
+                  ccs_rng_t                 rng) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	size_t dimension = utarray_len(data->hyperparameters);
+	gsl_rng *grng;
+	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
+	uint32_t *sequence_data = (uint32_t *)realloc(data->sequence_data,
+		dimension * (CCS_SOBOL_BITS + 1) * sizeof(uint32_t));
+	if (!sequence_data)
+		return -CCS_OUT_OF_MEMORY;
+	data->sequence_data = sequence_data;
+	for (size_t i = 0; i < dimension; i++)
+		sequence_data[i] = (uint32_t)(gsl_rng_uniform(grng) * 4294967296.0);
+	if (data->sampling_method == CCS_SAMPLING_SOBOL)
+		_sobol_directions(dimension, sequence_data + dimension);
+	else {
+		uint32_t *bases = sequence_data + dimension;
+		uint32_t n = 2;
+		for (size_t i = 0; i < dimension; n++) {
+			uint32_t q = 2;
+			while (q * q <= n && n % q)
+				q++;
+			if (q * q > n)
+				bases[i++] = n;
+		}
+	}
+	data->sequence_index = 0;
+	data->sequence_dimension = dimension;
+	return CCS_SUCCESS;
+}
+
+// A sliced Latin hypercube design of num_slices * num_strata points, whose
+// slices of num_strata points are Latin hypercube designs themselves. Each
+// coordinate interval is split into num_strata coarse strata, each split into
+// num_slices fine strata. Each slice has one point per coarse stratum, and in
+// slice s the point of coarse stratum c is in fine stratum
+// (s + offsets[c]) % num_slices of c, offsets holding num_strata random
+// offsets per coordinate: each fine stratum gets a single point of the whole
+// design. strata holds num_strata indexes.
+struct _ccs_lhs_slices_s {
+	size_t    num_slices;
+	size_t    num_strata;
+	size_t    slice;
+	uint32_t *offsets;
+	size_t   *strata;
+};
+typedef struct _ccs_lhs_slices_s _ccs_lhs_slices_t;
+
+// Draw num_configurations points of the unit hypercube of the sampling
+// method of the configuration space into uniforms, with a stride of the
+// number of hyperparameters. If slices is not NULL, the points of a Latin
+// hypercube design are taken from its current slice, which must have at least
+// num_configurations points.
+static ccs_result_t
+_sample_design(ccs_configuration_space_t  configuration_space,
+               ccs_rng_t                  rng,
+               const _ccs_lhs_slices_t   *slices,
+               size_t                     num_configurations,
+               ccs_float_t               *uniforms) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	size_t dimension = utarray_len(data->hyperparameters);
+	gsl_rng *grng;
+	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
+	if (data->sampling_method == CCS_SAMPLING_LATIN_HYPERCUBE && slices) {
+		size_t num_strata = slices->num_strata;
+		size_t num_slices = slices->num_slices;
+		ccs_float_t scale = 1.0 / ((ccs_float_t)num_strata * num_slices);
+		for (size_t i = 0; i < dimension; i++) {
+			const uint32_t *offsets = slices->offsets + i * num_strata;
+			// The coarse strata of the points are the start of a random
+			// permutation of the strata
+			for (size_t c = 0; c < num_strata; c++)
+				slices->strata[c] = c;
+			for (size_t j = 0; j < num_configurations; j++) {
+				size_t k = j + gsl_rng_uniform_int(grng, num_strata - j);
+				size_t c = slices->strata[k];
+				slices->strata[k] = slices->strata[j];
+				slices->strata[j] = c;
+				size_t f = c * num_slices +
+					(slices->slice + offsets[c]) % num_slices;
+				uniforms[j*dimension + i] =
+					(f + gsl_rng_uniform(grng)) * scale;
+			}
+		}
+		return CCS_SUCCESS;
+	}
+	if (data->sampling_method == CCS_SAMPLING_LATIN_HYPERCUBE) {
+		// One random permutation of the strata per coordinate, and a
+		// random position within each stratum
+		for (size_t i = 0; i < dimension; i++) {
+			for (size_t j = 0; j < num_configurations; j++)
+				uniforms[j*dimension + i] = j;
+			for (size_t j = num_configurations - 1; j > 0; j--) {
+				size_t k = gsl_rng_uniform_int(grng, j + 1);
+				ccs_float_t t = uniforms[j*dimension + i];
+				uniforms[j*dimension + i] = uniforms[k*dimension + i];
+				uniforms[k*dimension + i] = t;
+			}
+			for (size_t j = 0; j < num_configurations; j++)
+				uniforms[j*dimension + i] =
+					(uniforms[j*dimension + i] + gsl_rng_uniform(grng)) /
+					num_configurations;
+		}
+		return CCS_SUCCESS;
+	}
+	if (data->sequence_dimension != dimension)
+		CCS_VALIDATE(_restart_sequence(configuration_space, rng));
+	const uint32_t *shifts = data->sequence_data;
+	for (size_t j = 0; j < num_configurations; j++) {
+		uint32_t index = (uint32_t)data->sequence_index++;
+		ccs_float_t *point = uniforms + j*dimension;
+		if (data->sampling_method == CCS_SAMPLING_SOBOL) {
+			const uint32_t *directions = shifts + dimension;
+			for (size_t i = 0; i < dimension; i++) {
+				uint32_t x = shifts[i];
+				unsigned k = 0;
+				for (uint32_t n = index; n; n >>= 1, k++)
+					if (n & 1)
+						x ^= directions[i*CCS_SOBOL_BITS + k];
+				point[i] = x * (1.0 / 4294967296.0);
+			}
+		} else {
+			const uint32_t *bases = shifts + dimension;
+			for (size_t i = 0; i < dimension; i++) {
+				// Radical inverse of the index in base b
+				ccs_float_t x = 0.0;
+				ccs_float_t f = 1.0 / bases[i];
+				for (uint32_t n = index; n; n /= bases[i], f /= bases[i])
+					x += (n % bases[i]) * f;
+				x += shifts[i] * (1.0 / 4294967296.0);
+				point[i] = x < 1.0 ? x : x - 1.0;
+			}
+		}
+	}
+	return CCS_SUCCESS;
+}
+
+// Sample num_configurations rows of values, stored contiguously in values with
+// a stride of the number of hyperparameters. Each distribution is sampled once
+// for the whole batch, and the results are scattered into the rows. scratch
+// must hold num_configurations * num_hyperparameters values, hps
+// num_hyperparameters hyperparameters, and rows num_configurations indexes.
+// If uniforms is not NULL, it holds the points of a design, with a stride of
+// the number of hyperparameters, that are mapped through the distributions
+// instead of sampling them, followed by room for as many coordinates.
+static ccs_result_t
+_sample_values(ccs_configuration_space_t  configuration_space,
+               ccs_rng_t                  rng,
+               size_t                     num_configurations,
+               ccs_datum_t               *values,
+               ccs_datum_t               *scratch,
+               ccs_hyperparameter_t      *hps,
+               size_t                    *rows,
+               ccs_float_t               *uniforms) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	UT_array *array = data->hyperparameters;
+	size_t num_hyperparameters = utarray_len(array);
+	_ccs_distribution_wrapper_t *dwrapper = NULL;
+	_ccs_hyperparameter_wrapper_cs_t *hwrapper = NULL;
+	_ccs_restriction_t *restriction = NULL;
+	DL_FOREACH(data->distribution_list, dwrapper) {
+		size_t dim = dwrapper->dimension;
+		for (size_t i = 0; i < dim; i++) {
+			size_t hindex = dwrapper->hyperparameter_indexes[i];
+			hwrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, hindex);
+			hps[i] = hwrapper->hyperparameter;
+		}
+		restriction = NULL;
+		if (dim == 1 && hwrapper->restriction != SIZE_MAX) {
+			restriction = (_ccs_restriction_t *)utarray_eltptr(
+				data->restrictions, hwrapper->restriction);
+			if (restriction->num_combinations)
+				continue;
+		}
+		if (uniforms) {
+			ccs_float_t *coordinates =
+				uniforms + num_configurations * num_hyperparameters;
+			for (size_t i = 0; i < dim; i++) {
+				size_t hindex = dwrapper->hyperparameter_indexes[i];
+				for (size_t j = 0; j < num_configurations; j++)
+					coordinates[j*dim + i] =
+						uniforms[j*num_hyperparameters + hindex];
+			}
+			CCS_VALIDATE(_ccs_distribution_hyperparameters_quantiles(
+				dwrapper->distribution, rng, hps, num_configurations,
+				coordinates, scratch));
+		} else
+			CCS_VALIDATE(ccs_distribution_hyperparameters_samples(
+				dwrapper->distribution, rng, hps, num_configurations,
+				scratch));
+		for (size_t i = 0; i < dim; i++) {
+			size_t hindex = dwrapper->hyperparameter_indexes[i];
+			for (size_t j = 0; j < num_configurations; j++)
+				values[j*num_hyperparameters + hindex] = scratch[j*dim + i];
+		}
+		if (!uniforms && restriction) {
+			for (size_t j = 0; j < num_configurations; j++)
+				rows[j] = j;
+			CCS_VALIDATE(_resample_forbidden(configuration_space, rng,
+				dwrapper, hwrapper, restriction, num_configurations, rows,
+				values, scratch));
+		}
+	}
+	restriction = NULL;
+	while ( (restriction = (_ccs_restriction_t *)
+	           utarray_next(data->restrictions, restriction)) )
+		if (restriction->num_combinations)
+			CCS_VALIDATE(_sample_restriction(configuration_space, rng,
+				restriction, num_configurations, values, uniforms));
+	return CCS_SUCCESS;
+}
+
+// Lazy version of _sample_values followed by _set_actives: hyperparameters
+// are visited in topological order, and a hyperparameter is only sampled for
+// the rows where its condition holds. Distributions over several
+// hyperparameters are sampled for every row when their first hyperparameter
+// is visited, as the conditions of the others can depend on it. sampled must
+// hold num_hyperparameters flags.
+static ccs_result_t
+_sample_values_lazy(ccs_configuration_space_t  configuration_space,
+                    ccs_rng_t                  rng,
+                    size_t                     num_configurations,
+                    ccs_datum_t               *values,
+                    ccs_datum_t               *scratch,
+                    ccs_hyperparameter_t      *hps,
+                    size_t                    *rows,
+                    char                      *sampled) {
+	_ccs_configuration_space_data_t *data = configuration_space->data;
+	UT_array *array = data->hyperparameters;
+	size_t num_hyperparameters = utarray_len(array);
+	size_t num_steps = utarray_len(data->activation_plan);
+	_ccs_activation_step_t *steps =
+		(_ccs_activation_step_t *)utarray_front(data->activation_plan);
+	ccs_datum_t *stack = (ccs_datum_t *)alloca(
+		data->constraints_stack_size * sizeof(ccs_datum_t));
+	size_t step = 0;
+	size_t *p_index = NULL;
+	_ccs_restriction_t *restriction = NULL;
+	memset(sampled, 0, num_hyperparameters);
+	// Restricted hyperparameters are unconditional, and can be sampled
+	// first.
+	while ( (restriction = (_ccs_restriction_t *)
+	           utarray_next(data->restrictions, restriction)) )
+		if (restriction->num_combinations)
+			CCS_VALIDATE(_sample_restriction(configuration_space, rng,
+				restriction, num_configurations, values, NULL));
+	while ( (p_index = (size_t *)utarray_next(data->sorted_indexes, p_index)) ) {
+		size_t hindex = *p_index;
+		_ccs_hyperparameter_wrapper_cs_t *hwrapper =
+			(_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, hindex);
+		_ccs_distribution_wrapper_t *dwrapper = hwrapper->distribution;
+		size_t dim = dwrapper->dimension;
+		size_t num_rows = 0;
+		restriction = NULL;
+		if (hwrapper->restriction != SIZE_MAX) {
+			restriction = (_ccs_restriction_t *)utarray_eltptr(
+				data->restrictions, hwrapper->restriction);
+			if (restriction->num_combinations)
+				continue;
+		}
+		if (dim > 1 && !sampled[hindex]) {
+			for (size_t i = 0; i < dim; i++) {
+				hwrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(
+					array, dwrapper->hyperparameter_indexes[i]);
+				hps[i] = hwrapper->hyperparameter;
+				sampled[dwrapper->hyperparameter_indexes[i]] = 1;
+			}
+			CCS_VALIDATE(ccs_distribution_hyperparameters_samples(
+				dwrapper->distribution, rng, hps, num_configurations,
+				scratch));
+			for (size_t i = 0; i < dim; i++)
+				for (size_t j = 0; j < num_configurations; j++)
+					values[j*num_hyperparameters +
+					       dwrapper->hyperparameter_indexes[i]] =
+						scratch[j*dim + i];
+			hwrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(
+				array, hindex);
+		}
+		for (size_t j = 0; j < num_configurations; j++) {
+			ccs_datum_t *row = values + j * num_hyperparameters;
+			ccs_bool_t active = CCS_TRUE;
+			if (step < num_steps && steps[step].index == hindex)
+				CCS_VALIDATE(_test_activation(data, steps + step, row,
+				                              stack, &active));
+			if (active)
+				rows[num_rows++] = j;
+			else
+				row[hindex] = ccs_inactive;
+		}
+		if (step < num_steps && steps[step].index == hindex)
+			step++;
+		if (dim > 1 || !num_rows)
+			continue;
+		CCS_VALIDATE(ccs_distribution_hyperparameters_samples(
+			dwrapper->distribution, rng, &hwrapper->hyperparameter,
+			num_rows, scratch));
+		for (size_t j = 0; j < num_rows; j++)
+			values[rows[j] * num_hyperparameters + hindex] = scratch[j];
+		if (restriction)
+			CCS_VALIDATE(_resample_forbidden(configuration_space, rng,
+				dwrapper, hwrapper, restriction, num_rows, rows, values,
+				scratch));
+	}
+	return CCS_SUCCESS;
+}
+
+// Sample num_configurations candidate rows with the given method and set the
+// inactive hyperparameters, lazily or not depending on the configuration
+// space. The requirements on the buffers are those of _sample_values_lazy,
+// and, for methods other than random sampling, uniforms must hold 2 *
+// num_configurations * num_hyperparameters coordinates. slices is passed to
+// _sample_design.
+static ccs_result_t
+_sample_candidates(ccs_configuration_space_t  configuration_space,
+                   ccs_rng_t                  rng,
+                   ccs_sampling_method_t      method,
+                   const _ccs_lhs_slices_t   *slices,
+                   size_t                     num_configurations,
+                   ccs_datum_t               *values,
+                   ccs_datum_t               *scratch,
+                   ccs_hyperparameter_t      *hps,
+                   size_t                    *rows,
+                   char                      *sampled,
+                   ccs_float_t               *uniforms) {
+	size_t num_hyperparameters =
+		utarray_len(configuration_space->data->hyperparameters);
+	if (method == CCS_SAMPLING_RANDOM) {
+		if (configuration_space->data->lazy_sampling)
+			return _sample_values_lazy(configuration_space, rng,
+				num_configurations, values, scratch, hps, rows,
+				sampled);
+		uniforms = NULL;
+	} else
+		CCS_VALIDATE(_sample_design(configuration_space, rng, slices,
+		                            num_configurations, uniforms));
+	CCS_VALIDATE(_sample_values(configuration_space, rng, num_configurations,
+	                            values, scratch, hps, rows, uniforms));
+	for (size_t j = 0; j < num_configurations; j++)
+		CCS_VALIDATE(_set_actives(configuration_space,
+		                          values + j * num_hyperparameters));
+	return CCS_SUCCESS;
+}
+
+static ccs_result_t
+_sample(ccs_configuration_space_t  configuration_space,
+        ccs_configuration_t        config,
+        ccs_bool_t                *found) {
+	ccs_result_t err;
+	UT_array *array = configuration_space->data->hyperparameters;
+	ccs_datum_t *values = config->data->values;
+
+	size_t num_hyperparameters = utarray_len(array);
+	ccs_datum_t *p_values;
+	ccs_hyperparameter_t *hps;
+	size_t *rows;
+	uintptr_t mem;
+	ccs_float_t *uniforms;
+	mem = (uintptr_t) malloc(num_hyperparameters * (sizeof(ccs_datum_t) + 2 * sizeof(ccs_float_t) + sizeof(ccs_hyperparameter_t) + 1) + sizeof(size_t));
+	if (!mem)
+		return -CCS_OUT_OF_MEMORY;
+
+	p_values = (ccs_datum_t *)mem;
+	uniforms = (ccs_float_t *)(p_values + num_hyperparameters);
+	hps = (ccs_hyperparameter_t *)(uniforms + 2 * num_hyperparameters);
+	rows = (size_t *)(hps + num_hyperparameters);
+	CCS_VALIDATE_ERR_GOTO(err, _sample_candidates(configuration_space,
+		configuration_space->data->rng,
+		configuration_space->data->sampling_method, NULL, 1, values, p_values,
+		hps, rows, (char *)(rows + 1), uniforms), memory);
+	CCS_VALIDATE_ERR_GOTO(err, _test_forbidden(configuration_space, values, 1, found), memory);
+	if (*found && configuration_space->data->unique_sampling)
+		CCS_VALIDATE_ERR_GOTO(err, _add_sampled_configuration(
+			configuration_space, values, found), memory);
+	free((void *)mem);
+	return CCS_SUCCESS;
+memory:
+	free((void *)mem);
+	return err;
+}
+
+ccs_result_t
+ccs_configuration_space_sample(ccs_configuration_space_t  configuration_space,
+                               ccs_configuration_t       *configuration_ret) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	CCS_CHECK_PTR(configuration_ret);
+	ccs_result_t err;
+	ccs_configuration_t config;
+	CCS_VALIDATE(_generate_constraints(configuration_space));
+	CCS_VALIDATE(_generate_restrictions(configuration_space));
+	if (configuration_space->data->unique_sampling) {
+		CCS_VALIDATE(_count_distinct(configuration_space));
+		if (_sampling_exhausted(configuration_space->data))
+			return -CCS_SAMPLING_EXHAUSTED;
+	}
+	CCS_VALIDATE(ccs_create_configuration(configuration_space, 0, NULL, NULL, &config));
+	ccs_bool_t found;
+	int counter = 0;
+	do {
+		CCS_VALIDATE_ERR_GOTO(err, _sample(configuration_space, config, &found), errc);
+		counter++;
+	} while (!found && counter < 100);
+	if (!found) {
+		err = -CCS_SAMPLING_UNSUCCESSFUL;
+		goto errc;
+	}
+	*configuration_ret = config;
+	return CCS_SUCCESS;
+errc:
+	ccs_release_object(config);
+	return err;
+}
+
+// Sample up to num_configurations valid rows of values into values, with a
+// stride of the number of hyperparameters. Candidates are drawn in batches
+// into candidates, and rejected rows are resampled in further rounds, for at
+// most 100 * num_configurations attempts, or until the distinct
+// configurations are exhausted when sampling unique configurations.
+// candidates and scratch must hold num_configurations * num_hyperparameters
+// values each, and hps num_hyperparameters hyperparameters. record tells
+// whether forbidden clauses statistics are recorded. The first batch of a
+// Latin hypercube design is taken from slices if it is not NULL, the
+// following ones are new designs over the rows to replace.
+static ccs_result_t
+_sample_rows(ccs_configuration_space_t  configuration_space,
+             ccs_rng_t                  rng,
+             ccs_sampling_method_t      method,
+             const _ccs_lhs_slices_t   *slices,
+             size_t                     num_configurations,
+             ccs_datum_t               *values,
+             ccs_datum_t               *candidates,
+             ccs_datum_t               *scratch,
+             ccs_hyperparameter_t      *hps,
+             int                        record,
+             size_t                    *count_ret) {
+	ccs_result_t err = CCS_SUCCESS;
+	size_t num_hyperparameters =
+		utarray_len(configuration_space->data->hyperparameters);
+	size_t counter = 0;
+	size_t count = 0;
+	size_t num_uniforms = method == CCS_SAMPLING_RANDOM ?
+		0 : 2 * num_configurations * num_hyperparameters;
+	ccs_float_t *uniforms = (ccs_float_t *)malloc(
+		num_uniforms * sizeof(ccs_float_t) +
+		num_configurations * sizeof(size_t) + num_hyperparameters);
+	if (!uniforms)
+		return -CCS_OUT_OF_MEMORY;
+	size_t *rows = (size_t *)(uniforms + num_uniforms);
+	while (count < num_configurations && counter < 100 * num_configurations &&
+	       !_sampling_exhausted(configuration_space->data)) {
+		size_t batch = num_configurations - count;
+		CCS_VALIDATE_ERR_GOTO(err, _sample_candidates(configuration_space,
+			rng, method, counter ? NULL : slices, batch, candidates,
+			scratch, hps, rows, (char *)(rows + num_configurations),
+			uniforms), end);
+		counter += batch;
+		for (size_t j = 0; j < batch; j++) {
+			ccs_datum_t *row = candidates + j * num_hyperparameters;
+			ccs_bool_t found;
+			CCS_VALIDATE_ERR_GOTO(err, _test_forbidden(configuration_space,
+				row, record, &found), end);
+			if (found && configuration_space->data->unique_sampling)
+				CCS_VALIDATE_ERR_GOTO(err, _add_sampled_configuration(
+					configuration_space, row, &found), end);
+			if (!found)
+				continue;
+			memcpy(values + count * num_hyperparameters, row,
+			       num_hyperparameters * sizeof(ccs_datum_t));
+			count++;
+		}
+	}
+	*count_ret = count;
+end:
+	free(uniforms);
+	return err;
+}
+
+// Requests are sampled by windows of at most CCS_SAMPLES_WINDOW_SIZE rows, so
+// the scratch memory does not grow with the number of configurations. Latin
+// hypercube designs of requests spanning several windows are sliced Latin
+// hypercube designs, with one slice per window.
+#define CCS_SAMPLES_WINDOW_SIZE 4096
+
+ccs_result_t
+ccs_configuration_space_samples(ccs_configuration_space_t  configuration_space,
+                                size_t                     num_configurations,
+                                ccs_configuration_t       *configurations) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	CCS_CHECK_ARY(num_configurations, configurations);
+	if (!num_configurations)
+		return CCS_SUCCESS;
+	ccs_result_t err;
+	for (size_t i = 0; i < num_configurations; i++)
+		configurations[i] = NULL;
+	CCS_VALIDATE(_generate_constraints(configuration_space));
+	CCS_VALIDATE(_generate_restrictions(configuration_space));
+	if (configuration_space->data->unique_sampling)
+		CCS_VALIDATE(_count_distinct(configuration_space));
+
+	size_t num_hyperparameters =
+		utarray_len(configuration_space->data->hyperparameters);
+	size_t window = num_configurations < CCS_SAMPLES_WINDOW_SIZE ?
+		num_configurations : CCS_SAMPLES_WINDOW_SIZE;
+	size_t sz = window * num_hyperparameters;
+	size_t num_slices = (num_configurations - 1) / window + 1;
+	ccs_datum_t *values;
+	ccs_hyperparameter_t *hps;
+	_ccs_lhs_slices_t slices;
+	_ccs_lhs_slices_t *p_slices = NULL;
+	size_t total = 0;
+	uintptr_t mem;
+	if (configuration_space->data->sampling_method ==
+	        CCS_SAMPLING_LATIN_HYPERCUBE &&
+	    num_slices > 1 && num_slices <= UINT32_MAX)
+		p_slices = &slices;
+	mem = (uintptr_t) malloc(3 * sz * sizeof(ccs_datum_t) +
+	                         num_hyperparameters * sizeof(ccs_hyperparameter_t) +
+	                         (p_slices ? window * sizeof(size_t) +
+	                                     sz * sizeof(uint32_t) : 0));
+	if (!mem)
+		return -CCS_OUT_OF_MEMORY;
+	values = (ccs_datum_t *)mem;
+	hps = (ccs_hyperparameter_t *)(values + 3 * sz);
+	if (p_slices) {
+		gsl_rng *grng;
+		CCS_VALIDATE_ERR_GOTO(err, ccs_rng_get_gsl_rng(
+			configuration_space->data->rng, &grng), memory);
+		slices.num_slices = num_slices;
+		slices.num_strata = window;
+		slices.slice = 0;
+		slices.strata = (size_t *)(hps + num_hyperparameters);
+		slices.offsets = (uint32_t *)(slices.strata + window);
+		for (size_t i = 0; i < sz; i++)
+			slices.offsets[i] = (uint32_t)gsl_rng_uniform_int(grng,
+				num_slices);
+	}
+	while (total < num_configurations) {
+		size_t num = num_configurations - total;
+		size_t count;
+		if (num > window)
+			num = window;
+		CCS_VALIDATE_ERR_GOTO(err, _sample_rows(configuration_space,
+			configuration_space->data->rng,
+			configuration_space->data->sampling_method, p_slices, num,
+			values, values + sz, values + 2 * sz, hps, 1, &count), memory);
+		if (p_slices)
+			slices.slice++;
+		CCS_VALIDATE_ERR_GOTO(err, ccs_create_configurations(
+			configuration_space, count, num_hyperparameters, values,
+			NULL, configurations + total), memory);
+		total += count;
+		if (count < num)
+			break;
+	}
+	free((void *)mem);
+	if (total < num_configurations)
+		return _sampling_exhausted(configuration_space->data) ?
+			-CCS_SAMPLING_EXHAUSTED : -CCS_SAMPLING_UNSUCCESSFUL;
+	return CCS_SUCCESS;
+memory:
+	free((void *)mem);
+	for (size_t i = 0; i < total; i++) {
+		ccs_release_object(configurations[i]);
+		configurations[i] = NULL;
+	}
+	return err;
+}
+
+// Parallel sampling splits the request into fixed size chunks. Each chunk is
+// sampled with a generator seeded from a single draw of the configuration
+// space generator and the chunk index, so the result does not depend on which
+// thread samples which chunk, nor on the number of threads.
+#define CCS_SAMPLES_CHUNK_SIZE 256
+
+struct _ccs_samples_parallel_s {
+	ccs_configuration_space_t  configuration_space;
+	const gsl_rng_type        *rng_type;
+	unsigned long int          seed;
+	size_t                     num_configurations;
+	size_t                     num_chunks;
+	ccs_datum_t               *values;
+	size_t                    *counts;
+	pthread_mutex_t            mutex;
+	size_t                     next_chunk;
+	ccs_result_t               err;
+};
+typedef struct _ccs_samples_parallel_s _ccs_samples_parallel_t;
+
+static void *
+_samples_parallel_worker(void *arg) {
+	_ccs_samples_parallel_t *ctx = (_ccs_samples_parallel_t *)arg;
+	ccs_configuration_space_t configuration_space = ctx->configuration_space;
+	size_t num_hyperparameters =
+		utarray_len(configuration_space->data->hyperparameters);
+	size_t sz = CCS_SAMPLES_CHUNK_SIZE * num_hyperparameters;
+	ccs_result_t err;
+	ccs_rng_t rng = NULL;
+	uintptr_t mem;
+	mem = (uintptr_t) malloc(2 * sz * sizeof(ccs_datum_t) +
+	                         num_hyperparameters * sizeof(ccs_hyperparameter_t));
+	if (!mem) {
+		err = -CCS_OUT_OF_MEMORY;
+		goto end;
+	}
+	CCS_VALIDATE_ERR_GOTO(err, ccs_rng_create_with_type(ctx->rng_type, &rng), end);
+	while (1) {
+		size_t chunk;
+		pthread_mutex_lock(&ctx->mutex);
+		chunk = ctx->next_chunk++;
+		if (ctx->err)
+			chunk = ctx->num_chunks;
+		pthread_mutex_unlock(&ctx->mutex);
+		if (chunk >= ctx->num_chunks)
+			break;
+		size_t start = chunk * CCS_SAMPLES_CHUNK_SIZE;
+		size_t num = ctx->num_configurations - start;
+		if (num > CCS_SAMPLES_CHUNK_SIZE)
+			num = CCS_SAMPLES_CHUNK_SIZE;
+		CCS_VALIDATE_ERR_GOTO(err, ccs_rng_set_seed(rng,
+			_ccs_rng_derive_seed(ctx->seed, chunk)), end);
+		CCS_VALIDATE_ERR_GOTO(err, _sample_rows(configuration_space, rng,
+			CCS_SAMPLING_RANDOM, NULL, num,
+			ctx->values + start * num_hyperparameters,
+			(ccs_datum_t *)mem, (ccs_datum_t *)mem + sz,
+			(ccs_hyperparameter_t *)((ccs_datum_t *)mem + 2 * sz),
+			0, ctx->counts + chunk), end);
 	}
-	wrapper = NULL;
-	while ( (wrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_next(array, wrapper)) ) {
-		_uniq_size_t_array(wrapper->parents);
-		_uniq_size_t_array(wrapper->children);
-        }
 	err = CCS_SUCCESS;
-errmem:
+end:
+	if (rng)
+		ccs_release_object(rng);
 	if (mem)
 		free((void *)mem);
+	if (err) {
+		pthread_mutex_lock(&ctx->mutex);
+		if (!ctx->err)
+			ctx->err = err;
+		pthread_mutex_unlock(&ctx->mutex);
+	}
+	return NULL;
+}
+
+ccs_result_t
+ccs_configuration_space_samples_parallel(
+		ccs_configuration_space_t  configuration_space,
+		size_t                     num_threads,
+		size_t                     num_configurations,
+		ccs_configuration_t       *configurations) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	CCS_CHECK_ARY(num_configurations, configurations);
+	if (!num_configurations)
+		return CCS_SUCCESS;
+	// Unique configurations are sampled sequentially
+	if (configuration_space->data->unique_sampling)
+		return ccs_configuration_space_samples(configuration_space,
+			num_configurations, configurations);
+	ccs_result_t err;
+	for (size_t i = 0; i < num_configurations; i++)
+		configurations[i] = NULL;
+	CCS_VALIDATE(_generate_constraints(configuration_space));
+	CCS_VALIDATE(_generate_restrictions(configuration_space));
+
+	_ccs_samples_parallel_t ctx;
+	ctx.configuration_space = configuration_space;
+	ctx.num_configurations = num_configurations;
+	ctx.num_chunks = (num_configurations + CCS_SAMPLES_CHUNK_SIZE - 1) /
+	                 CCS_SAMPLES_CHUNK_SIZE;
+	ctx.next_chunk = 0;
+	ctx.err = CCS_SUCCESS;
+	CCS_VALIDATE(ccs_rng_get_type(configuration_space->data->rng, &ctx.rng_type));
+	CCS_VALIDATE(ccs_rng_get(configuration_space->data->rng, &ctx.seed));
+
+	if (!num_threads) {
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+		num_threads = n > 0 ? (size_t)n : 1;
+	}
+	if (num_threads > ctx.num_chunks)
+		num_threads = ctx.num_chunks;
+
+	size_t num_hyperparameters =
+		utarray_len(configuration_space->data->hyperparameters);
+	uintptr_t mem;
+	mem = (uintptr_t) malloc(num_configurations * num_hyperparameters * sizeof(ccs_datum_t) +
+	                         ctx.num_chunks * sizeof(size_t) +
+	                         num_threads * sizeof(pthread_t));
+	if (!mem)
+		return -CCS_OUT_OF_MEMORY;
+	ctx.values = (ccs_datum_t *)mem;
+	ctx.counts = (size_t *)(ctx.values + num_configurations * num_hyperparameters);
+	pthread_t *threads = (pthread_t *)(ctx.counts + ctx.num_chunks);
+	if (pthread_mutex_init(&ctx.mutex, NULL)) {
+		free((void *)mem);
+		return -CCS_OUT_OF_MEMORY;
+	}
+
+	size_t num_started = 0;
+	for (; num_started < num_threads - 1; num_started++)
+		if (pthread_create(threads + num_started, NULL,
+		                   &_samples_parallel_worker, &ctx))
+			break;
+	_samples_parallel_worker(&ctx);
+	for (size_t i = 0; i < num_started; i++)
+		pthread_join(threads[i], NULL);
+	pthread_mutex_destroy(&ctx.mutex);
+
+	size_t count;
+	count = 0;
+	CCS_VALIDATE_ERR_GOTO(err, ctx.err, memory);
+	for (size_t i = 0; i < ctx.num_chunks; i++) {
+		if (count != i * CCS_SAMPLES_CHUNK_SIZE)
+			memmove(ctx.values + count * num_hyperparameters,
+			        ctx.values + i * CCS_SAMPLES_CHUNK_SIZE * num_hyperparameters,
+			        ctx.counts[i] * num_hyperparameters * sizeof(ccs_datum_t));
+		count += ctx.counts[i];
+	}
+	CCS_VALIDATE_ERR_GOTO(err, ccs_create_configurations(configuration_space,
+		count, num_hyperparameters, ctx.values, NULL, configurations), memory);
+	free((void *)mem);
+	if (count < num_configurations)
+		return -CCS_SAMPLING_UNSUCCESSFUL;
+	return CCS_SUCCESS;
+memory:
+	free((void *)mem);
 	return err;
 }
+
+static int _size_t_sort(const void *a, const void *b) {
+	const size_t sa = *(const size_t *)a;
+	const size_t sb = *(const size_t *)b;
+	return sa < sb ? -1 : sa > sb ? 1 : 0;
+}
+
+#define CCS_MARK_FORWARD  1
+#define CCS_MARK_BACKWARD 2
+#define CCS_MARK_PARENT   4
+
+// Add the edges from parents to the hyperparameter at index, maintaining the
+// topological order of the hyperparameters (Pearce and Kelly dynamic
+// topological sort). Only the hyperparameters ranked between the
+// hyperparameter and its highest ranked parent are visited, and cycles are
+// detected while visiting the descendants of the hyperparameter.
 #undef  utarray_oom
 #define utarray_oom() { \
-	exit(-1); \
+	err = -CCS_OUT_OF_MEMORY; \
+	goto end; \
 }
-
 static ccs_result_t
-_generate_constraints(ccs_configuration_space_t configuration_space) {
-	CCS_VALIDATE(_recompute_graph(configuration_space));
-	CCS_VALIDATE(_topological_sort(configuration_space));
-	configuration_space->data->graph_ok = CCS_TRUE;
-	return CCS_SUCCESS;
+_add_edges(ccs_configuration_space_t  configuration_space,
+           size_t                     index,
+           size_t                     num_parents,
+           size_t                    *parents) {
+	ccs_result_t err = CCS_SUCCESS;
+	UT_array *array = configuration_space->data->hyperparameters;
+	size_t *sorted = (size_t *)utarray_front(configuration_space->data->sorted_indexes);
+	_ccs_hyperparameter_wrapper_cs_t *wrapper, *w;
+	UT_array *forward = NULL;
+	UT_array *backward = NULL;
+	UT_array *stack = NULL;
+	size_t *mem = NULL;
+	size_t *p_index;
+
+	wrapper = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, index);
+	size_t lower = wrapper->rank;
+	size_t upper = lower;
+	for (size_t i = 0; i < num_parents; i++) {
+		if (parents[i] == index)
+			return -CCS_INVALID_GRAPH;
+		w = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, parents[i]);
+		if (w->rank > upper)
+			upper = w->rank;
+	}
+
+	if (upper > lower) {
+		utarray_new(forward, &_size_t_icd);
+		utarray_new(backward, &_size_t_icd);
+		utarray_new(stack, &_size_t_icd);
+		for (size_t i = 0; i < num_parents; i++) {
+			w = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, parents[i]);
+			w->mark |= CCS_MARK_PARENT;
+		}
+
+		wrapper->mark |= CCS_MARK_FORWARD;
+		utarray_push_back(forward, &index);
+		utarray_push_back(stack, &index);
+		while (utarray_len(stack)) {
+			size_t n = *(size_t *)utarray_back(stack);
+			utarray_pop_back(stack);
+			w = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, n);
+			p_index = NULL;
+			while ( (p_index = (size_t *)utarray_next(w->children, p_index)) ) {
+				_ccs_hyperparameter_wrapper_cs_t *c =
+					(_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, *p_index);
+				if (c->mark & CCS_MARK_PARENT) {
+					err = -CCS_INVALID_GRAPH;
+					goto end;
+				}
+				if (c->rank > upper || (c->mark & CCS_MARK_FORWARD))
+					continue;
+				c->mark |= CCS_MARK_FORWARD;
+				utarray_push_back(forward, p_index);
+				utarray_push_back(stack, p_index);
+			}
+		}
+
+		for (size_t i = 0; i < num_parents; i++) {
+			w = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, parents[i]);
+			if (w->rank < lower || (w->mark & CCS_MARK_BACKWARD))
+				continue;
+			w->mark |= CCS_MARK_BACKWARD;
+			utarray_push_back(backward, parents + i);
+			utarray_push_back(stack, parents + i);
+		}
+		while (utarray_len(stack)) {
+			size_t n = *(size_t *)utarray_back(stack);
+			utarray_pop_back(stack);
+			w = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, n);
+			p_index = NULL;
+			while ( (p_index = (size_t *)utarray_next(w->parents, p_index)) ) {
+				_ccs_hyperparameter_wrapper_cs_t *pw =
+					(_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, *p_index);
+				if (pw->rank < lower || (pw->mark & CCS_MARK_BACKWARD))
+					continue;
+				pw->mark |= CCS_MARK_BACKWARD;
+				utarray_push_back(backward, p_index);
+				utarray_push_back(stack, p_index);
+			}
+		}
+
+		// The ancestors of the parents are moved before the descendants
+		// of the hyperparameter, in the ranks they occupy together.
+		size_t num_forward = utarray_len(forward);
+		size_t num_backward = utarray_len(backward);
+		size_t total = num_forward + num_backward;
+		mem = (size_t *)malloc(2 * total * sizeof(size_t));
+		if (!mem) {
+			err = -CCS_OUT_OF_MEMORY;
+			goto end;
+		}
+		size_t *ranks = mem;
+		size_t *nodes = mem + total;
+		for (size_t i = 0; i < num_backward; i++)
+			ranks[i] = ((_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array,
+				*(size_t *)utarray_eltptr(backward, i)))->rank;
+		for (size_t i = 0; i < num_forward; i++)
+			ranks[num_backward + i] = ((_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array,
+				*(size_t *)utarray_eltptr(forward, i)))->rank;
+		qsort(ranks, num_backward, sizeof(size_t), &_size_t_sort);
+		qsort(ranks + num_backward, num_forward, sizeof(size_t), &_size_t_sort);
+		for (size_t i = 0; i < total; i++)
+			nodes[i] = sorted[ranks[i]];
+		qsort(ranks, total, sizeof(size_t), &_size_t_sort);
+		for (size_t i = 0; i < total; i++) {
+			sorted[ranks[i]] = nodes[i];
+			((_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, nodes[i]))->rank = ranks[i];
+		}
+	}
+
+	utarray_reserve(wrapper->parents, num_parents);
+	for (size_t i = 0; i < num_parents; i++) {
+		w = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, parents[i]);
+		utarray_reserve(w->children, 1);
+	}
+	for (size_t i = 0; i < num_parents; i++) {
+		w = (_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, parents[i]);
+		utarray_push_back(wrapper->parents, parents + i);
+		utarray_push_back(w->children, &index);
+	}
+end:
+	if (forward) {
+		p_index = NULL;
+		while ( (p_index = (size_t *)utarray_next(forward, p_index)) )
+			((_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, *p_index))->mark = 0;
+		utarray_free(forward);
+	}
+	if (backward) {
+		p_index = NULL;
+		while ( (p_index = (size_t *)utarray_next(backward, p_index)) )
+			((_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, *p_index))->mark = 0;
+		utarray_free(backward);
+	}
+	if (stack) {
+		for (size_t i = 0; i < num_parents; i++)
+			((_ccs_hyperparameter_wrapper_cs_t *)utarray_eltptr(array, parents[i]))->mark = 0;
+		utarray_free(stack);
+	}
+	if (mem)
+		free(mem);
+	return err;
+}
+#undef  utarray_oom
+#define utarray_oom() { \
+	exit(-1); \
 }
 
 ccs_result_t
@@ -1002,15 +3459,33 @@ ccs_configuration_space_set_condition(ccs_configuration_space_t configuration_sp
 	if (wrapper->condition)
 		return -CCS_INVALID_HYPERPARAMETER;
 	ccs_result_t err;
-	CCS_VALIDATE(ccs_retain_object(expression));
+	size_t count;
+	CCS_VALIDATE(ccs_expression_get_hyperparameters(expression, 0, NULL, &count));
+	ccs_hyperparameter_t *parents = NULL;
+	size_t               *parents_index = NULL;
+	uintptr_t mem = 0;
+	if (count) {
+		mem = (uintptr_t)malloc(count *
+			(sizeof(ccs_hyperparameter_t) + sizeof(size_t)));
+		if (!mem)
+			return -CCS_OUT_OF_MEMORY;
+		parents = (ccs_hyperparameter_t *)mem;
+		parents_index = (size_t *)(mem + count * sizeof(ccs_hyperparameter_t));
+		CCS_VALIDATE_ERR_GOTO(err, ccs_expression_get_hyperparameters(
+		    expression, count, parents, NULL), errmem);
+		CCS_VALIDATE_ERR_GOTO(err, ccs_configuration_space_get_hyperparameter_indexes(
+		    configuration_space, count, parents, parents_index), errmem);
+	}
+	configuration_space->data->constraints_ok = 0;
+	_forget_sampled_configurations(configuration_space->data);
+	CCS_VALIDATE_ERR_GOTO(err, _add_edges(configuration_space,
+	    hyperparameter_index, count, parents_index), errmem);
+	CCS_VALIDATE_ERR_GOTO(err, ccs_retain_object(expression), errmem);
 	wrapper->condition = expression;
-	// Recompute the whole graph for now
-	configuration_space->data->graph_ok = CCS_FALSE;
-	CCS_VALIDATE_ERR_GOTO(err, _generate_constraints(configuration_space), erre);
-	return CCS_SUCCESS;
-erre:
-	ccs_release_object(expression);
-	wrapper->condition = NULL;
+	err = CCS_SUCCESS;
+errmem:
+	if (mem)
+		free((void *)mem);
 	return err;
 }
 
@@ -1080,9 +3555,26 @@ ccs_configuration_space_add_forbidden_clause(ccs_configuration_space_t configura
 		return err;
 	if (!err && d.type == CCS_BOOLEAN && d.value.i == CCS_TRUE)
 		return -CCS_INVALID_CONFIGURATION;
+	_ccs_forbidden_step_t step = { 0, 0, 0, 0, 0, { 0, 0, 0 }, 0, 0 };
+	step.clause = utarray_len(configuration_space->data->forbidden_clauses);
 	CCS_VALIDATE(ccs_retain_object(expression));
 	utarray_push_back(configuration_space->data->forbidden_clauses, &expression);
+	_forget_sampled_configurations(configuration_space->data);
+	configuration_space->data->restrictions_ok = 0;
+	if (configuration_space->data->constraints_ok) {
+		configuration_space->data->constraints_ok = 0;
+		CCS_VALIDATE_ERR_GOTO(err, _compile_forbidden_clause(
+			configuration_space, &step), errclause);
+		configuration_space->data->constraints_ok = 1;
+	}
+	utarray_push_back(configuration_space->data->forbidden_plan, &step);
 	return CCS_SUCCESS;
+errclause:
+	// The partially compiled constraints are rebuilt from the forbidden
+	// plan on next use, as constraints_ok is unset.
+	utarray_pop_back(configuration_space->data->forbidden_clauses);
+	ccs_release_object(expression);
+	return err;
 }
 #undef  utarray_oom
 #define utarray_oom() exit(-1)
@@ -1099,6 +3591,17 @@ ccs_configuration_space_add_forbidden_clauses(ccs_configuration_space_t  configu
 	return CCS_SUCCESS;
 }
 
+ccs_result_t
+ccs_configuration_space_freeze_forbidden_clauses_order(
+		ccs_configuration_space_t configuration_space,
+		ccs_bool_t                freeze) {
+	CCS_CHECK_OBJ(configuration_space, CCS_CONFIGURATION_SPACE);
+	if (freeze && !configuration_space->data->forbidden_frozen)
+		_reorder_forbidden(configuration_space);
+	configuration_space->data->forbidden_frozen = freeze ? 1 : 0;
+	return CCS_SUCCESS;
+}
+
 ccs_result_t
 ccs_configuration_space_get_forbidden_clause(ccs_configuration_space_t  configuration_space,
                                              size_t                     index,
@@ -12,6 +12,9 @@ struct _ccs_hyperparameter_wrapper_cs_s {
 	ccs_expression_t             condition;
 	UT_array                    *parents;
 	UT_array                    *children;
+	size_t                       restriction;
+	size_t                       rank;
+	int                          mark;
 };
 typedef struct _ccs_hyperparameter_wrapper_cs_s _ccs_hyperparameter_wrapper_cs_t;
 
@@ -23,6 +26,104 @@ struct _ccs_distribution_wrapper_s {
 	_ccs_distribution_wrapper_t *next;
 };
 
+// A hyperparameter of a constraint table: its rank contributes rank * stride
+// to the table entry, inactive being ranked after the possible values.
+struct _ccs_table_variable_s {
+	ccs_hyperparameter_t hyperparameter;
+	size_t               index;
+	size_t               stride;
+};
+typedef struct _ccs_table_variable_s _ccs_table_variable_t;
+
+// Constraints over a few categorical, ordinal or discrete hyperparameters are
+// tabulated: the num_variables variables starting at variables in the table
+// variables index a bitmap, starting at bits in the tables, of the
+// combinations for which the constraint is true. num_variables is 0 for
+// constraints that are not tabulated.
+struct _ccs_constraint_table_s {
+	size_t variables;
+	size_t num_variables;
+	size_t bits;
+};
+typedef struct _ccs_constraint_table_s _ccs_constraint_table_t;
+
+// One step of the activation plan: the condition of the hyperparameter at
+// index is the program starting at offset in the constraints code.
+struct _ccs_activation_step_s {
+	size_t                  index;
+	size_t                  offset;
+	_ccs_constraint_table_t table;
+};
+typedef struct _ccs_activation_step_s _ccs_activation_step_t;
+
+// One step of the forbidden plan: the forbidden clause at index clause is the
+// program starting at offset in the constraints code, and cost instructions
+// long. The clause can only reject configurations where the num_required
+// hyperparameters listed at required in the forbidden requirements are
+// active. evaluations and hits count how many times the clause was tested
+// while sampling, and how many times it rejected the configuration.
+struct _ccs_forbidden_step_s {
+	size_t                  clause;
+	size_t                  offset;
+	size_t                  cost;
+	size_t                  required;
+	size_t                  num_required;
+	_ccs_constraint_table_t table;
+	size_t                  evaluations;
+	size_t                  hits;
+};
+typedef struct _ccs_forbidden_step_s _ccs_forbidden_step_t;
+
+// Unconditional hyperparameters sampled from their own distribution are
+// sampled from their distribution restricted by the forbidden clauses that
+// only reference them, or only reference a group of such categorical, ordinal
+// or discrete hyperparameters. The support of each variable of a restriction
+// is split in cells over which these clauses are constant: one per rank of a
+// categorical, ordinal or discrete hyperparameter, or the intervals, in the
+// space of its distribution, delimited by the literals the clauses compare a
+// numerical hyperparameter to. A numerical hyperparameter only keeps its
+// allowed cells, merged when they are adjacent.
+struct _ccs_restriction_variable_s {
+	size_t index;
+	size_t cells;
+	size_t num_cells;
+	size_t stride;
+};
+typedef struct _ccs_restriction_variable_s _ccs_restriction_variable_t;
+
+// A restriction over the num_variables variables starting at variables in
+// the restriction variables, enforcing the num_steps copies of forbidden steps
+// starting at steps in the restriction steps. The combinations of cells are
+// ordered with the first variable varying slowest, and the num_combinations +
+// 1 cumulative masses of the combinations, 0 for the forbidden ones, start at
+// masses in the restriction masses. num_combinations is 0 when the support
+// could not be restricted, in which case the values rejected by the steps are
+// redrawn.
+struct _ccs_restriction_s {
+	size_t variables;
+	size_t num_variables;
+	size_t steps;
+	size_t num_steps;
+	size_t masses;
+	size_t num_combinations;
+};
+typedef struct _ccs_restriction_s _ccs_restriction_t;
+
+// Low discrepancy sequences have one coordinate per hyperparameter. The
+// sequence data of a configuration space holds the sequence_dimension random
+// shifts of the coordinates, followed by the Halton bases or the Sobol
+// direction numbers of each coordinate. sequence_index is the index of the
+// next point, and a sequence_dimension of 0 means the sequence must be
+// restarted.
+#define CCS_SOBOL_BITS 32
+
+// Configurations sampled or excluded while sampling unique configurations are
+// kept in a hash set keyed by their binding data. num_distinct is the number
+// of distinct valid configurations, or SIZE_MAX if it is unknown, and is
+// recounted when num_distinct_ok is not set.
+struct _ccs_sampled_configuration_s;
+typedef struct _ccs_sampled_configuration_s _ccs_sampled_configuration_t;
+
 struct _ccs_configuration_space_data_s;
 typedef struct _ccs_configuration_space_data_s _ccs_configuration_space_data_t;
 
@@ -45,8 +146,32 @@ struct _ccs_configuration_space_data_s {
 	ccs_rng_t                         rng;
 	_ccs_distribution_wrapper_t      *distribution_list;
 	UT_array                         *forbidden_clauses;
-	ccs_bool_t                        graph_ok;
 	UT_array                         *sorted_indexes;
+	UT_array                         *activation_plan;
+	UT_array                         *forbidden_plan;
+	UT_array                         *forbidden_requirements;
+	UT_array                         *table_variables;
+	UT_array                         *tables;
+	UT_array                         *constraints_code;
+	size_t                            constraints_stack_size;
+	int                               constraints_ok;
+	UT_array                         *restrictions;
+	UT_array                         *restriction_variables;
+	UT_array                         *restriction_steps;
+	UT_array                         *restriction_cells;
+	UT_array                         *restriction_masses;
+	int                               restrictions_ok;
+	size_t                            forbidden_tests;
+	int                               forbidden_frozen;
+	int                               lazy_sampling;
+	ccs_sampling_method_t             sampling_method;
+	size_t                            sequence_index;
+	size_t                            sequence_dimension;
+	uint32_t                         *sequence_data;
+	int                               unique_sampling;
+	_ccs_sampled_configuration_t     *sampled_configurations;
+	size_t                            num_distinct;
+	int                               num_distinct_ok;
 };
 
 #endif //_CONFIGURATION_SPACE_INTERNAL_H
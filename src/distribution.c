@@ -288,3 +288,268 @@ ccs_create_uniform_int_distribution(ccs_int_t           lower,
 	                                       distribution_ret);
 }
 
+
+// Position of a value relative to an interval: negative below it, positive
+// above it, and 0 inside.
+static inline int
+_ccs_interval_position(const ccs_interval_t *interval, ccs_numeric_t value) {
+	if (interval->type == CCS_NUM_FLOAT) {
+		if (interval->lower_included ? value.f < interval->lower.f :
+		                               value.f <= interval->lower.f)
+			return -1;
+		if (interval->upper_included ? value.f > interval->upper.f :
+		                               value.f >= interval->upper.f)
+			return 1;
+	} else {
+		if (interval->lower_included ? value.i < interval->lower.i :
+		                               value.i <= interval->lower.i)
+			return -1;
+		if (interval->upper_included ? value.i > interval->upper.i :
+		                               value.i >= interval->upper.i)
+			return 1;
+	}
+	return 0;
+}
+
+// Number of bisection steps, enough for the bounds to be within 2^-64 of
+// the exact ones.
+#define CCS_QUANTILE_BISECTION_STEPS 64
+
+ccs_result_t
+_ccs_distribution_quantile_bounds(
+		_ccs_distribution_data_t     *distribution,
+		_ccs_distribution_quantiles_t quantiles,
+		const ccs_interval_t         *interval,
+		ccs_float_t                  *lower_ret,
+		ccs_float_t                  *upper_ret) {
+	const ccs_float_t last = nextafter(1.0, 0.0);
+	ccs_float_t lo, hi, mid;
+	ccs_numeric_t v;
+	*lower_ret = 0.0;
+	*upper_ret = last;
+	if (((_ccs_distribution_common_data_t *)distribution)->data_types[0] !=
+	    interval->type)
+		return CCS_SUCCESS;
+	// Smallest uniform not mapped below the interval
+	CCS_VALIDATE(quantiles(distribution, NULL, 1, 1, lower_ret, &v));
+	if (_ccs_interval_position(interval, v) < 0) {
+		lo = 0.0;
+		hi = last;
+		CCS_VALIDATE(quantiles(distribution, NULL, 1, 1, &hi, &v));
+		if (_ccs_interval_position(interval, v) < 0)
+			goto empty;
+		for (int k = 0; k < CCS_QUANTILE_BISECTION_STEPS; k++) {
+			mid = lo + (hi - lo) * 0.5;
+			if (mid <= lo || mid >= hi)
+				break;
+			CCS_VALIDATE(quantiles(distribution, NULL, 1, 1, &mid, &v));
+			if (_ccs_interval_position(interval, v) < 0)
+				lo = mid;
+			else
+				hi = mid;
+		}
+		*lower_ret = hi;
+	}
+	// Largest uniform not mapped above the interval
+	CCS_VALIDATE(quantiles(distribution, NULL, 1, 1, upper_ret, &v));
+	if (_ccs_interval_position(interval, v) > 0) {
+		lo = *lower_ret;
+		hi = last;
+		CCS_VALIDATE(quantiles(distribution, NULL, 1, 1, &lo, &v));
+		if (_ccs_interval_position(interval, v) > 0)
+			goto empty;
+		for (int k = 0; k < CCS_QUANTILE_BISECTION_STEPS; k++) {
+			mid = lo + (hi - lo) * 0.5;
+			if (mid <= lo || mid >= hi)
+				break;
+			CCS_VALIDATE(quantiles(distribution, NULL, 1, 1, &mid, &v));
+			if (_ccs_interval_position(interval, v) > 0)
+				hi = mid;
+			else
+				lo = mid;
+		}
+		*upper_ret = lo;
+	}
+	return CCS_SUCCESS;
+empty:
+	*lower_ret = 1.0;
+	*upper_ret = 0.0;
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+_ccs_distribution_truncated_quantiles(
+		_ccs_distribution_data_t     *distribution,
+		_ccs_distribution_quantiles_t quantiles,
+		const ccs_interval_t         *interval,
+		size_t                        num_values,
+		size_t                        stride,
+		const ccs_float_t            *uniforms,
+		ccs_numeric_t                *values) {
+	ccs_float_t   us[CCS_UNIFORMS_BLOCK_SIZE];
+	ccs_numeric_t vs[CCS_UNIFORMS_BLOCK_SIZE];
+	ccs_float_t lower, upper;
+	CCS_VALIDATE(_ccs_distribution_quantile_bounds(distribution, quantiles,
+		interval, &lower, &upper));
+	if (lower > upper)
+		return quantiles(distribution, NULL, num_values, stride, uniforms,
+		                 values);
+	for (size_t i = 0; i < num_values; i += CCS_UNIFORMS_BLOCK_SIZE) {
+		size_t n = num_values - i < CCS_UNIFORMS_BLOCK_SIZE ?
+			num_values - i : CCS_UNIFORMS_BLOCK_SIZE;
+		for (size_t k = 0; k < n; k++) {
+			ccs_float_t u = lower + uniforms[(i + k)*stride] * (upper - lower);
+			us[k] = u < upper ? u : upper;
+		}
+		CCS_VALIDATE(quantiles(distribution, NULL, n, 1, us, vs));
+		for (size_t k = 0; k < n; k++)
+			values[(i + k)*stride] = vs[k];
+	}
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+_ccs_distribution_interval_mass(ccs_distribution_t    distribution,
+                                const ccs_interval_t *intervals,
+                                ccs_float_t          *mass_ret) {
+	ccs_distribution_type_t type =
+		((_ccs_distribution_common_data_t *)(distribution->data))->type;
+	ccs_distribution_t *distributions;
+	size_t num_distributions;
+	ccs_float_t mass;
+	switch (type) {
+	case CCS_MULTIVARIATE:
+		CCS_VALIDATE(ccs_multivariate_distribution_get_num_distributions(
+			distribution, &num_distributions));
+		distributions = (ccs_distribution_t *)alloca(
+			num_distributions * sizeof(ccs_distribution_t));
+		CCS_VALIDATE(ccs_multivariate_distribution_get_distributions(
+			distribution, num_distributions, distributions, NULL));
+		*mass_ret = 1.0;
+		for (size_t i = 0; i < num_distributions; i++) {
+			CCS_VALIDATE(_ccs_distribution_interval_mass(distributions[i],
+				intervals, &mass));
+			*mass_ret *= mass;
+			intervals += ((_ccs_distribution_common_data_t *)
+				(distributions[i]->data))->dimension;
+		}
+		break;
+	case CCS_MIXTURE: {
+		CCS_VALIDATE(ccs_mixture_distribution_get_num_distributions(
+			distribution, &num_distributions));
+		distributions = (ccs_distribution_t *)alloca(
+			num_distributions * sizeof(ccs_distribution_t));
+		ccs_float_t *weights = (ccs_float_t *)alloca(
+			num_distributions * sizeof(ccs_float_t));
+		CCS_VALIDATE(ccs_mixture_distribution_get_distributions(
+			distribution, num_distributions, distributions, NULL));
+		CCS_VALIDATE(ccs_mixture_distribution_get_weights(
+			distribution, num_distributions, weights, NULL));
+		*mass_ret = 0.0;
+		for (size_t i = 0; i < num_distributions; i++) {
+			CCS_VALIDATE(_ccs_distribution_interval_mass(distributions[i],
+				intervals, &mass));
+			*mass_ret += weights[i] * mass;
+		}
+		break;
+	}
+	default: {
+		ccs_float_t lower, upper;
+		CCS_VALIDATE(_ccs_distribution_quantile_bounds(distribution->data,
+			ccs_distribution_get_ops(distribution)->quantiles, intervals,
+			&lower, &upper));
+		*mass_ret = lower > upper ? 0.0 : upper - lower;
+	}
+	}
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+_ccs_distribution_hyperparameters_quantiles(
+		ccs_distribution_t    distribution,
+		ccs_rng_t             rng,
+		ccs_hyperparameter_t *hyperparameters,
+		size_t                num_values,
+		const ccs_float_t    *uniforms,
+		ccs_datum_t          *values) {
+	if (!num_values)
+		return CCS_SUCCESS;
+	ccs_result_t err = CCS_SUCCESS;
+	size_t dim = ((_ccs_distribution_common_data_t *)(distribution->data))->dimension;
+	ccs_bool_t *oversamplings = (ccs_bool_t *)alloca(dim*sizeof(ccs_bool_t));
+	ccs_interval_t *intervals = (ccs_interval_t *)alloca(dim*sizeof(ccs_interval_t));
+	for (size_t i = 0; i < dim; i++)
+		CCS_VALIDATE(ccs_hyperparameter_sampling_interval(hyperparameters[i], intervals+i));
+	CCS_VALIDATE(ccs_distribution_check_oversampling(distribution, intervals, oversamplings));
+
+	uintptr_t mem = (uintptr_t)malloc(num_values * ((dim + 1) * (sizeof(ccs_numeric_t) + sizeof(ccs_datum_t)) + sizeof(size_t)));
+	if (!mem)
+		return -CCS_OUT_OF_MEMORY;
+	ccs_datum_t *ds = (ccs_datum_t *)mem;
+	ccs_numeric_t *vs = (ccs_numeric_t *)(ds + num_values * (dim + 1));
+	ccs_numeric_t *column = vs + num_values * dim;
+	size_t *rows = (size_t *)(column + num_values);
+	size_t num_rows = 0;
+	ccs_bool_t oversampling = CCS_FALSE;
+	for (size_t i = 0; i < dim; i++)
+		if (oversamplings[i])
+			oversampling = CCS_TRUE;
+	CCS_VALIDATE_ERR_GOTO(err, ccs_distribution_get_ops(distribution)->quantiles(
+		distribution->data, oversampling ? intervals : NULL, num_values, dim,
+		uniforms, vs), errmem);
+	for (size_t i = 0; i < dim; i++) {
+		for (size_t j = 0; j < num_values; j++)
+			column[j] = vs[j*dim + i];
+		CCS_VALIDATE_ERR_GOTO(err, ccs_hyperparameter_convert_samples(
+			hyperparameters[i], oversamplings[i], num_values, column, ds),
+			errmem);
+		for (size_t j = 0; j < num_values; j++)
+			values[j*dim + i] = ds[j];
+	}
+
+	for (size_t j = 0; j < num_values; j++)
+		for (size_t i = 0; i < dim; i++)
+			if (values[j*dim + i].type == CCS_INACTIVE) {
+				rows[num_rows++] = j;
+				break;
+			}
+	if (num_rows) {
+		CCS_VALIDATE_ERR_GOTO(err, ccs_distribution_hyperparameters_samples(
+			distribution, rng, hyperparameters, num_rows, ds), errmem);
+		for (size_t j = 0; j < num_rows; j++)
+			for (size_t i = 0; i < dim; i++)
+				values[rows[j]*dim + i] = ds[j*dim + i];
+	}
+errmem:
+	free((void *)mem);
+	return err;
+}
+
+ccs_result_t
+_ccs_distribution_hyperparameter_truncated_quantiles(
+		ccs_distribution_t    distribution,
+		ccs_rng_t             rng,
+		ccs_hyperparameter_t  hyperparameter,
+		const ccs_interval_t *interval,
+		size_t                num_values,
+		const ccs_float_t    *uniforms,
+		ccs_datum_t          *values) {
+	if (!num_values)
+		return CCS_SUCCESS;
+	ccs_result_t err = CCS_SUCCESS;
+	ccs_numeric_t *vs = (ccs_numeric_t *)malloc(
+		num_values * sizeof(ccs_numeric_t));
+	if (!vs)
+		return -CCS_OUT_OF_MEMORY;
+	CCS_VALIDATE_ERR_GOTO(err, ccs_distribution_get_ops(distribution)->quantiles(
+		distribution->data, interval, num_values, 1, uniforms, vs), errmem);
+	CCS_VALIDATE_ERR_GOTO(err, ccs_hyperparameter_convert_samples(
+		hyperparameter, CCS_TRUE, num_values, vs, values), errmem);
+	for (size_t j = 0; j < num_values; j++)
+		if (values[j].type == CCS_INACTIVE)
+			CCS_VALIDATE_ERR_GOTO(err, ccs_distribution_hyperparameters_samples(
+				distribution, rng, &hyperparameter, 1, values + j), errmem);
+errmem:
+	free(vs);
+	return err;
+}
@@ -7,6 +7,10 @@
 		return -CCS_INVALID_DISTRIBUTION; \
 } while (0)
 
+// Number of uniform values generated at once with ccs_rng_uniform_fill when
+// they cannot be generated in place.
+#define CCS_UNIFORMS_BLOCK_SIZE 64
+
 struct _ccs_distribution_data_s;
 typedef struct _ccs_distribution_data_s _ccs_distribution_data_t;
 
@@ -35,6 +39,19 @@ struct _ccs_distribution_ops_s {
 		ccs_rng_t                  rng,
 		size_t                     num_values,
 		ccs_numeric_t            **values);
+
+	// Map num_values points of the unit hypercube, one per row of stride
+	// uniforms, through the inverse of the distribution function. values
+	// uses the same layout. If intervals is not NULL, it holds one interval
+	// per dimension, and the distribution is truncated to these intervals
+	// where it has mass in them.
+	ccs_result_t (*quantiles)(
+		_ccs_distribution_data_t *distribution,
+		const ccs_interval_t     *intervals,
+		size_t                    num_values,
+		size_t                    stride,
+		const ccs_float_t        *uniforms,
+		ccs_numeric_t            *values);
 };
 typedef struct _ccs_distribution_ops_s _ccs_distribution_ops_t;
 
@@ -69,4 +86,75 @@ ccs_dichotomic_search(ccs_int_t size, ccs_float_t *values, ccs_float_t target) {
 	return index;
 }
 
+typedef ccs_result_t (*_ccs_distribution_quantiles_t)(
+	_ccs_distribution_data_t *distribution,
+	const ccs_interval_t     *intervals,
+	size_t                    num_values,
+	size_t                    stride,
+	const ccs_float_t        *uniforms,
+	ccs_numeric_t            *values);
+
+// Find the part [*lower_ret, *upper_ret] of the unit interval that the
+// quantiles of a distribution of dimension 1 map into interval. Quantile
+// functions are non decreasing, so the bounds are found by bisection. The
+// distribution has no mass in interval when *lower_ret > *upper_ret.
+ccs_result_t
+_ccs_distribution_quantile_bounds(
+	_ccs_distribution_data_t     *distribution,
+	_ccs_distribution_quantiles_t quantiles,
+	const ccs_interval_t         *interval,
+	ccs_float_t                  *lower_ret,
+	ccs_float_t                  *upper_ret);
+
+// Quantiles of a distribution of dimension 1 truncated to interval: the
+// uniforms are mapped to the bounds found by
+// _ccs_distribution_quantile_bounds before going through quantiles. The
+// distribution is not truncated if it has no mass in interval.
+ccs_result_t
+_ccs_distribution_truncated_quantiles(
+	_ccs_distribution_data_t     *distribution,
+	_ccs_distribution_quantiles_t quantiles,
+	const ccs_interval_t         *interval,
+	size_t                        num_values,
+	size_t                        stride,
+	const ccs_float_t            *uniforms,
+	ccs_numeric_t                *values);
+
+// Probability that a sample of the distribution falls in intervals, one per
+// dimension.
+ccs_result_t
+_ccs_distribution_interval_mass(
+	ccs_distribution_t    distribution,
+	const ccs_interval_t *intervals,
+	ccs_float_t          *mass_ret);
+
+// Same as ccs_distribution_hyperparameters_samples, but the num_values
+// samples are the images of the points of the unit hypercube given, with a
+// stride of the dimension, in uniforms. The distribution is truncated to the
+// hyperparameters' sampling intervals, so the samples stay in them. Samples
+// that still fall outside, when the distribution has no mass in an interval,
+// are replaced by random samples.
+ccs_result_t
+_ccs_distribution_hyperparameters_quantiles(
+	ccs_distribution_t    distribution,
+	ccs_rng_t             rng,
+	ccs_hyperparameter_t *hyperparameters,
+	size_t                num_values,
+	const ccs_float_t    *uniforms,
+	ccs_datum_t          *values);
+
+// Same as _ccs_distribution_hyperparameters_quantiles for a distribution of
+// dimension 1, truncated to interval instead of the sampling interval of
+// hyperparameter. interval must be included in the sampling interval, and
+// the distribution must have mass in it.
+ccs_result_t
+_ccs_distribution_hyperparameter_truncated_quantiles(
+	ccs_distribution_t    distribution,
+	ccs_rng_t             rng,
+	ccs_hyperparameter_t  hyperparameter,
+	const ccs_interval_t *interval,
+	size_t                num_values,
+	const ccs_float_t    *uniforms,
+	ccs_datum_t          *values);
+
 #endif //_DISTRIBUTION_INTERNAL_H
@@ -47,12 +47,21 @@ _ccs_distribution_mixture_soa_samples(_ccs_distribution_data_t  *data,
                                       size_t                     num_values,
                                       ccs_numeric_t            **values);
 
+static ccs_result_t
+_ccs_distribution_mixture_quantiles(_ccs_distribution_data_t *data,
+                                    const ccs_interval_t     *intervals,
+                                    size_t                    num_values,
+                                    size_t                    stride,
+                                    const ccs_float_t        *uniforms,
+                                    ccs_numeric_t            *values);
+
 static _ccs_distribution_ops_t _ccs_distribution_mixture_ops = {
 	{ &_ccs_distribution_mixture_del },
 	&_ccs_distribution_mixture_samples,
 	&_ccs_distribution_mixture_get_bounds,
 	&_ccs_distribution_mixture_strided_samples,
-	&_ccs_distribution_mixture_soa_samples
+	&_ccs_distribution_mixture_soa_samples,
+	&_ccs_distribution_mixture_quantiles
 };
 
 ccs_result_t
@@ -275,6 +284,102 @@ _ccs_distribution_mixture_soa_samples(_ccs_distribution_data_t  *data,
 	return CCS_SUCCESS;
 }
 
+// When truncated, the weight of each distribution is multiplied by its mass in
+// the intervals, and the rows are grouped by distribution, so each
+// distribution is truncated once.
+static ccs_result_t
+_ccs_distribution_mixture_quantiles(_ccs_distribution_data_t *data,
+                                    const ccs_interval_t     *intervals,
+                                    size_t                    num_values,
+                                    size_t                    stride,
+                                    const ccs_float_t        *uniforms,
+                                    ccs_numeric_t            *values) {
+	_ccs_distribution_mixture_data_t *d = (_ccs_distribution_mixture_data_t *)data;
+	size_t dim = d->common_data.dimension;
+	size_t num_distributions = d->num_distributions;
+	ccs_float_t *weights = d->weights;
+	ccs_float_t *row = (ccs_float_t *)alloca(dim*sizeof(ccs_float_t));
+
+	if (intervals) {
+		weights = (ccs_float_t *)alloca(
+			(num_distributions + 1)*sizeof(ccs_float_t));
+		weights[0] = 0.0;
+		for (size_t i = 0; i < num_distributions; i++) {
+			ccs_float_t mass;
+			CCS_VALIDATE(_ccs_distribution_interval_mass(
+				d->distributions[i], intervals, &mass));
+			weights[i+1] = weights[i] +
+				(d->weights[i+1] - d->weights[i]) * mass;
+		}
+		if (weights[num_distributions] > 0.0) {
+			ccs_float_t inv_sum = 1.0 / weights[num_distributions];
+			for (size_t i = 1; i < num_distributions; i++)
+				if ((weights[i] *= inv_sum) > 1.0)
+					weights[i] = 1.0;
+			weights[num_distributions] = 1.0;
+		} else {
+			weights = d->weights;
+			intervals = NULL;
+		}
+	}
+	if (!intervals) {
+		for (size_t i = 0; i < num_values; i++) {
+			ccs_float_t u = uniforms[i*stride];
+			ccs_int_t index = ccs_dichotomic_search(num_distributions, weights, u);
+			// The position of the first coordinate within the weight of the
+			// selected distribution is uniform, and independent of the selection
+			u = (u - weights[index]) / (weights[index+1] - weights[index]);
+			row[0] = u < 1.0 ? u : nextafter(1.0, 0.0);
+			for (size_t j = 1; j < dim; j++)
+				row[j] = uniforms[i*stride + j];
+			CCS_VALIDATE(ccs_distribution_get_ops(d->distributions[index])->quantiles(d->distributions[index]->data, NULL, 1, dim, row, values + i*stride));
+		}
+		return CCS_SUCCESS;
+	}
+
+	ccs_result_t err = CCS_SUCCESS;
+	uintptr_t mem = (uintptr_t)malloc(num_values * (sizeof(size_t) +
+		dim * (sizeof(ccs_float_t) + sizeof(ccs_numeric_t))));
+	if (!mem)
+		return -CCS_OUT_OF_MEMORY;
+	ccs_numeric_t *vs = (ccs_numeric_t *)mem;
+	ccs_float_t *us = (ccs_float_t *)(vs + num_values * dim);
+	size_t *indexes = (size_t *)(us + num_values * dim);
+	for (size_t i = 0; i < num_values; i++)
+		indexes[i] = ccs_dichotomic_search(num_distributions, weights,
+		                                   uniforms[i*stride]);
+	for (size_t k = 0; k < num_distributions; k++) {
+		size_t n = 0;
+		if (weights[k+1] <= weights[k])
+			continue;
+		for (size_t i = 0; i < num_values; i++) {
+			if (indexes[i] != k)
+				continue;
+			ccs_float_t u = (uniforms[i*stride] - weights[k]) /
+				(weights[k+1] - weights[k]);
+			us[n*dim] = u < 1.0 ? u : nextafter(1.0, 0.0);
+			for (size_t j = 1; j < dim; j++)
+				us[n*dim + j] = uniforms[i*stride + j];
+			n++;
+		}
+		if (!n)
+			continue;
+		CCS_VALIDATE_ERR_GOTO(err, ccs_distribution_get_ops(
+			d->distributions[k])->quantiles(d->distributions[k]->data,
+			intervals, n, dim, us, vs), end);
+		n = 0;
+		for (size_t i = 0; i < num_values; i++)
+			if (indexes[i] == k) {
+				for (size_t j = 0; j < dim; j++)
+					values[i*stride + j] = vs[n*dim + j];
+				n++;
+			}
+	}
+end:
+	free((void *)mem);
+	return err;
+}
+
 ccs_result_t
 ccs_mixture_distribution_get_num_distributions(ccs_distribution_t  distribution,
                                                size_t             *num_distributions_ret) {
@@ -47,12 +47,21 @@ _ccs_distribution_multivariate_soa_samples(_ccs_distribution_data_t  *data,
                                            size_t                     num_values,
                                            ccs_numeric_t            **values);
 
+static ccs_result_t
+_ccs_distribution_multivariate_quantiles(_ccs_distribution_data_t *data,
+                                         const ccs_interval_t     *intervals,
+                                         size_t                    num_values,
+                                         size_t                    stride,
+                                         const ccs_float_t        *uniforms,
+                                         ccs_numeric_t            *values);
+
 static _ccs_distribution_ops_t _ccs_distribution_multivariate_ops = {
 	{ &_ccs_distribution_multivariate_del },
 	&_ccs_distribution_multivariate_samples,
 	&_ccs_distribution_multivariate_get_bounds,
 	&_ccs_distribution_multivariate_strided_samples,
-	&_ccs_distribution_multivariate_soa_samples
+	&_ccs_distribution_multivariate_soa_samples,
+	&_ccs_distribution_multivariate_quantiles
 };
 
 ccs_result_t
@@ -203,6 +212,28 @@ _ccs_distribution_multivariate_soa_samples(_ccs_distribution_data_t  *data,
 	return CCS_SUCCESS;
 }
 
+static ccs_result_t
+_ccs_distribution_multivariate_quantiles(_ccs_distribution_data_t *data,
+                                         const ccs_interval_t     *intervals,
+                                         size_t                    num_values,
+                                         size_t                    stride,
+                                         const ccs_float_t        *uniforms,
+                                         ccs_numeric_t            *values) {
+	_ccs_distribution_multivariate_data_t *d =
+		(_ccs_distribution_multivariate_data_t *)data;
+
+	for (size_t i = 0; i < d->num_distributions; i++) {
+		CCS_VALIDATE(ccs_distribution_get_ops(d->distributions[i])->quantiles(
+			d->distributions[i]->data, intervals, num_values, stride,
+			uniforms, values));
+		uniforms += d->dimensions[i];
+		values += d->dimensions[i];
+		if (intervals)
+			intervals += d->dimensions[i];
+	}
+	return CCS_SUCCESS;
+}
+
 ccs_result_t
 ccs_multivariate_distribution_get_num_distributions(ccs_distribution_t  distribution,
                                                size_t             *num_distributions_ret) {
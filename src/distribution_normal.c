@@ -1,6 +1,8 @@
 #include <math.h>
+#include <float.h>
 #include <gsl/gsl_rng.h>
 #include <gsl/gsl_randist.h>
+#include <gsl/gsl_cdf.h>
 #include "cconfigspace_internal.h"
 #include "distribution_internal.h"
 
@@ -43,12 +45,21 @@ _ccs_distribution_normal_soa_samples(_ccs_distribution_data_t  *data,
                                      size_t                     num_values,
                                      ccs_numeric_t            **values);
 
+static ccs_result_t
+_ccs_distribution_normal_quantiles(_ccs_distribution_data_t *data,
+                                   const ccs_interval_t     *intervals,
+                                   size_t                    num_values,
+                                   size_t                    stride,
+                                   const ccs_float_t        *uniforms,
+                                   ccs_numeric_t            *values);
+
 static _ccs_distribution_ops_t _ccs_distribution_normal_ops = {
 	{ &_ccs_distribution_del },
 	&_ccs_distribution_normal_samples,
 	&_ccs_distribution_normal_get_bounds,
 	&_ccs_distribution_normal_strided_samples,
-	&_ccs_distribution_normal_soa_samples
+	&_ccs_distribution_normal_soa_samples,
+	&_ccs_distribution_normal_quantiles
 };
 
 static ccs_result_t
@@ -112,8 +123,77 @@ _ccs_distribution_normal_get_bounds(_ccs_distribution_data_t *data,
 	return CCS_SUCCESS;
 }
 
+// Rejection tests of the generated values, given the parameters of the
+// rejection: values that are rejected are drawn again.
+typedef int (*_ccs_gaussian_reject_t)(ccs_float_t v, const ccs_float_t *p);
+
+static int
+_ccs_gaussian_reject_lower(ccs_float_t v, const ccs_float_t *p) {
+	return v < p[0];
+}
+
+static int
+_ccs_gaussian_reject_log_int(ccs_float_t v, const ccs_float_t *p) {
+	return v < p[0] ||
+	       CCS_UNLIKELY(exp(v) - p[1] > (ccs_float_t)CCS_INT_MAX);
+}
+
+static int
+_ccs_gaussian_reject_int(ccs_float_t v, const ccs_float_t *p) {
+	return CCS_UNLIKELY(v - p[1] > (ccs_float_t)CCS_INT_MAX ||
+	                    v + p[1] < (ccs_float_t)CCS_INT_MIN);
+}
+
+// Same values as successive calls to gsl_ran_gaussian, which uses the polar
+// Box-Muller method, with the uniforms generated by blocks. Rejected values
+// are drawn again before the next value, as a loop around gsl_ran_gaussian
+// would. A block never holds more uniforms than needed if all the remaining
+// pairs are accepted, so the generator is left in the same state as with
+// gsl_ran_gaussian.
+static ccs_result_t
+_ccs_gaussian_fill(ccs_rng_t               rng,
+                   ccs_float_t             mu,
+                   ccs_float_t             sigma,
+                   _ccs_gaussian_reject_t  reject,
+                   const ccs_float_t      *reject_params,
+                   size_t                  num_values,
+                   size_t                  stride,
+                   ccs_float_t            *values) {
+	ccs_float_t uniforms[CCS_UNIFORMS_BLOCK_SIZE];
+	ccs_float_t x = 0.0;
+	size_t      has_x = 0;
+	size_t      i = 0;
+	while (i < num_values) {
+		size_t count = 2 * (num_values - i) - has_x;
+		if (count > CCS_UNIFORMS_BLOCK_SIZE)
+			count = CCS_UNIFORMS_BLOCK_SIZE;
+		CCS_VALIDATE(ccs_rng_uniform_fill(rng, count, uniforms));
+		for (size_t j = 0; j < count; j++) {
+			// gsl_rng_uniform_pos skips 0
+			if (CCS_UNLIKELY(uniforms[j] == 0.0))
+				continue;
+			if (!has_x) {
+				x = -1 + 2 * uniforms[j];
+				has_x = 1;
+				continue;
+			}
+			ccs_float_t y = -1 + 2 * uniforms[j];
+			ccs_float_t r2 = x * x + y * y;
+			has_x = 0;
+			if (r2 > 1.0 || r2 == 0)
+				continue;
+			ccs_float_t v = sigma * y * sqrt(-2.0 * log(r2) / r2) + mu;
+			if (reject && reject(v, reject_params))
+				continue;
+			values[i*stride] = v;
+			i++;
+		}
+	}
+	return CCS_SUCCESS;
+}
+
 static inline ccs_result_t
-_ccs_distribution_normal_samples_float(gsl_rng                *grng,
+_ccs_distribution_normal_samples_float(ccs_rng_t               rng,
                                        const ccs_scale_type_t  scale_type,
                                        const ccs_float_t       quantization,
                                        const ccs_float_t       mu,
@@ -124,19 +204,20 @@ _ccs_distribution_normal_samples_float(gsl_rng                *grng,
 	size_t i;
 	if (scale_type == CCS_LOGARITHMIC && quantize) {
 		ccs_float_t lq = log(quantization*0.5);
-		if (mu - lq >= 0.0)
+		if (mu - lq >= 0.0) {
 			//at least 50% chance to get a valid value
-			for (i = 0; i < num_values; i++)
-				do {
-					values[i] = gsl_ran_gaussian(grng, sigma) + mu;
-				} while (values[i] < lq);
-		else
+			CCS_VALIDATE(_ccs_gaussian_fill(rng, mu, sigma,
+				&_ccs_gaussian_reject_lower, &lq, num_values, 1, values));
+		} else {
 			//use tail distribution
+			gsl_rng *grng;
+			CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
 			for (i = 0; i < num_values; i++)
 				values[i] = gsl_ran_gaussian_tail(grng, lq - mu, sigma) + mu;
+		}
 	} else
-		for (i = 0; i < num_values; i++)
-			values[i] = gsl_ran_gaussian(grng, sigma) + mu;
+		CCS_VALIDATE(_ccs_gaussian_fill(rng, mu, sigma, NULL, NULL,
+			num_values, 1, values));
 	if (scale_type == CCS_LOGARITHMIC)
 		for (i = 0; i < num_values; i++)
 			values[i] = exp(values[i]);
@@ -149,7 +230,7 @@ _ccs_distribution_normal_samples_float(gsl_rng                *grng,
 }
 
 static inline ccs_result_t
-_ccs_distribution_normal_samples_int(gsl_rng                *grng,
+_ccs_distribution_normal_samples_int(ccs_rng_t               rng,
                                      const ccs_scale_type_t  scale_type,
                                      const ccs_int_t         quantization,
                                      const ccs_float_t       mu,
@@ -165,26 +246,29 @@ _ccs_distribution_normal_samples_int(gsl_rng                *grng,
 		q = 0.5;
 	if (scale_type == CCS_LOGARITHMIC) {
 		ccs_float_t lq = log(q);
-		if (mu - lq >= 0.0)
+		if (mu - lq >= 0.0) {
+			ccs_float_t params[2] = { lq, q };
+			CCS_VALIDATE(_ccs_gaussian_fill(rng, mu, sigma,
+				&_ccs_gaussian_reject_log_int, params, num_values, 1,
+				(ccs_float_t *)values));
 			for (i = 0; i < num_values; i++)
-				do {
-					do {
-						values[i].f = gsl_ran_gaussian(grng, sigma) + mu;
-					} while (values[i].f < lq);
-					values[i].f = exp(values[i].f);
-				} while (CCS_UNLIKELY(values[i].f - q > (ccs_float_t)CCS_INT_MAX));
-		else
+				values[i].f = exp(values[i].f);
+		} else {
+			gsl_rng *grng;
+			CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
 			for (i = 0; i < num_values; i++)
 				do {
 					values[i].f = gsl_ran_gaussian_tail(grng, lq - mu, sigma) + mu;
 					values[i].f = exp(values[i].f);
 				} while (CCS_UNLIKELY(values[i].f - q > (ccs_float_t)CCS_INT_MAX));
+		}
+	}
+	else {
+		ccs_float_t params[2] = { 0.0, q };
+		CCS_VALIDATE(_ccs_gaussian_fill(rng, mu, sigma,
+			&_ccs_gaussian_reject_int, params, num_values, 1,
+			(ccs_float_t *)values));
 	}
-	else
-		for (i = 0; i < num_values; i++)
-			do {
-				values[i].f = gsl_ran_gaussian(grng, sigma) + mu;
-			} while (CCS_UNLIKELY(values[i].f - q > (ccs_float_t)CCS_INT_MAX || values[i].f + q < (ccs_float_t)CCS_INT_MIN));
 	if (quantize) {
 		ccs_float_t rquantization = 1.0 / quantization;
 		for (i = 0; i < num_values; i++)
@@ -207,23 +291,21 @@ _ccs_distribution_normal_samples(_ccs_distribution_data_t *data,
 	const ccs_float_t      mu             = d->mu;
 	const ccs_float_t      sigma          = d->sigma;
 	const int              quantize       = d->quantize;
-	gsl_rng *grng;
-	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
 	if (data_type == CCS_NUM_FLOAT)
-		return _ccs_distribution_normal_samples_float(grng, scale_type,
+		return _ccs_distribution_normal_samples_float(rng, scale_type,
                                                               quantization.f, mu,
                                                               sigma, quantize,
                                                               num_values,
                                                               (ccs_float_t*) values);
 	else
-		return _ccs_distribution_normal_samples_int(grng, scale_type,
+		return _ccs_distribution_normal_samples_int(rng, scale_type,
                                                             quantization.i, mu,
                                                             sigma, quantize,
                                                             num_values, values);
 }
 
 static inline ccs_result_t
-_ccs_distribution_normal_strided_samples_float(gsl_rng                *grng,
+_ccs_distribution_normal_strided_samples_float(ccs_rng_t               rng,
                                                const ccs_scale_type_t  scale_type,
                                                const ccs_float_t       quantization,
                                                const ccs_float_t       mu,
@@ -235,19 +317,20 @@ _ccs_distribution_normal_strided_samples_float(gsl_rng                *grng,
 	size_t i;
 	if (scale_type == CCS_LOGARITHMIC && quantize) {
 		ccs_float_t lq = log(quantization*0.5);
-		if (mu - lq >= 0.0)
+		if (mu - lq >= 0.0) {
 			//at least 50% chance to get a valid value
-			for (i = 0; i < num_values; i++)
-				do {
-					values[i*stride] = gsl_ran_gaussian(grng, sigma) + mu;
-				} while (values[i*stride] < lq);
-		else
+			CCS_VALIDATE(_ccs_gaussian_fill(rng, mu, sigma,
+				&_ccs_gaussian_reject_lower, &lq, num_values, stride, values));
+		} else {
 			//use tail distribution
+			gsl_rng *grng;
+			CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
 			for (i = 0; i < num_values; i++)
 				values[i*stride] = gsl_ran_gaussian_tail(grng, lq - mu, sigma) + mu;
+		}
 	} else
-		for (i = 0; i < num_values; i++)
-			values[i*stride] = gsl_ran_gaussian(grng, sigma) + mu;
+		CCS_VALIDATE(_ccs_gaussian_fill(rng, mu, sigma, NULL, NULL,
+			num_values, stride, values));
 	if (scale_type == CCS_LOGARITHMIC)
 		for (i = 0; i < num_values; i++)
 			values[i*stride] = exp(values[i*stride]);
@@ -260,7 +343,7 @@ _ccs_distribution_normal_strided_samples_float(gsl_rng                *grng,
 }
 
 static inline ccs_result_t
-_ccs_distribution_normal_strided_samples_int(gsl_rng                *grng,
+_ccs_distribution_normal_strided_samples_int(ccs_rng_t               rng,
                                              const ccs_scale_type_t  scale_type,
                                              const ccs_int_t         quantization,
                                              const ccs_float_t       mu,
@@ -277,26 +360,29 @@ _ccs_distribution_normal_strided_samples_int(gsl_rng                *grng,
 		q = 0.5;
 	if (scale_type == CCS_LOGARITHMIC) {
 		ccs_float_t lq = log(q);
-		if (mu - lq >= 0.0)
+		if (mu - lq >= 0.0) {
+			ccs_float_t params[2] = { lq, q };
+			CCS_VALIDATE(_ccs_gaussian_fill(rng, mu, sigma,
+				&_ccs_gaussian_reject_log_int, params, num_values, stride,
+				(ccs_float_t *)values));
 			for (i = 0; i < num_values; i++)
-				do {
-					do {
-						values[i*stride].f = gsl_ran_gaussian(grng, sigma) + mu;
-					} while (values[i*stride].f < lq);
-					values[i*stride].f = exp(values[i*stride].f);
-				} while (CCS_UNLIKELY(values[i*stride].f - q > (ccs_float_t)CCS_INT_MAX));
-		else
+				values[i*stride].f = exp(values[i*stride].f);
+		} else {
+			gsl_rng *grng;
+			CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
 			for (i = 0; i < num_values; i++)
 				do {
 					values[i*stride].f = gsl_ran_gaussian_tail(grng, lq - mu, sigma) + mu;
 					values[i*stride].f = exp(values[i*stride].f);
 				} while (CCS_UNLIKELY(values[i*stride].f - q > (ccs_float_t)CCS_INT_MAX));
+		}
+	}
+	else {
+		ccs_float_t params[2] = { 0.0, q };
+		CCS_VALIDATE(_ccs_gaussian_fill(rng, mu, sigma,
+			&_ccs_gaussian_reject_int, params, num_values, stride,
+			(ccs_float_t *)values));
 	}
-	else
-		for (i = 0; i < num_values; i++)
-			do {
-				values[i*stride].f = gsl_ran_gaussian(grng, sigma) + mu;
-			} while (CCS_UNLIKELY(values[i*stride].f - q > (ccs_float_t)CCS_INT_MAX || values[i*stride].f + q < (ccs_float_t)CCS_INT_MIN));
 	if (quantize) {
 		ccs_float_t rquantization = 1.0 / quantization;
 		for (i = 0; i < num_values; i++)
@@ -320,16 +406,14 @@ _ccs_distribution_normal_strided_samples(_ccs_distribution_data_t *data,
 	const ccs_float_t      mu             = d->mu;
 	const ccs_float_t      sigma          = d->sigma;
 	const int              quantize       = d->quantize;
-	gsl_rng *grng;
-	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
 	if (data_type == CCS_NUM_FLOAT)
-		return _ccs_distribution_normal_strided_samples_float(grng, scale_type,
+		return _ccs_distribution_normal_strided_samples_float(rng, scale_type,
 		                                                      quantization.f, mu,
 		                                                      sigma, quantize,
 		                                                      num_values, stride,
 		                                                      (ccs_float_t*) values);
 	else
-		return _ccs_distribution_normal_strided_samples_int(grng, scale_type,
+		return _ccs_distribution_normal_strided_samples_int(rng, scale_type,
 		                                                    quantization.i, mu,
 		                                                    sigma, quantize,
 		                                                    num_values, stride, values);
@@ -345,6 +429,99 @@ _ccs_distribution_normal_soa_samples(_ccs_distribution_data_t  *data,
 	return CCS_SUCCESS;
 }
 
+// Inverse of the distribution function of the normal distribution truncated
+// to [lower, upper]. The upper tail is used when the truncated distribution
+// lies above the mean, for accuracy.
+static inline ccs_float_t
+_ccs_truncated_normal_quantile(ccs_float_t u,
+                               ccs_float_t mu,
+                               ccs_float_t sigma,
+                               ccs_float_t lower,
+                               ccs_float_t upper) {
+	ccs_float_t l = (lower - mu) / sigma;
+	ccs_float_t h = (upper - mu) / sigma;
+	ccs_float_t p, x;
+	if (l > 0.0) {
+		ccs_float_t ql = gsl_cdf_ugaussian_Q(l);
+		p = ql - u * (ql - gsl_cdf_ugaussian_Q(h));
+	} else {
+		ccs_float_t pl = gsl_cdf_ugaussian_P(l);
+		p = pl + u * (gsl_cdf_ugaussian_P(h) - pl);
+	}
+	if (p < DBL_MIN)
+		p = DBL_MIN;
+	else if (p > 1.0 - DBL_EPSILON)
+		p = 1.0 - DBL_EPSILON;
+	x = l > 0.0 ? gsl_cdf_ugaussian_Qinv(p) : gsl_cdf_ugaussian_Pinv(p);
+	if (x < l)
+		x = l;
+	else if (x > h)
+		x = h;
+	return x * sigma + mu;
+}
+
+// The truncations match the rejections of the samplers.
+static ccs_result_t
+_ccs_distribution_normal_quantiles(_ccs_distribution_data_t *data,
+                                   const ccs_interval_t     *intervals,
+                                   size_t                    num_values,
+                                   size_t                    stride,
+                                   const ccs_float_t        *uniforms,
+                                   ccs_numeric_t            *values) {
+	if (intervals)
+		return _ccs_distribution_truncated_quantiles(data,
+			&_ccs_distribution_normal_quantiles, intervals, num_values, stride,
+			uniforms, values);
+	_ccs_distribution_normal_data_t *d = (_ccs_distribution_normal_data_t *)data;
+	const ccs_numeric_type_t  data_type   = d->common_data.data_types[0];
+	const ccs_scale_type_t scale_type     = d->scale_type;
+	const ccs_numeric_t    quantization   = d->quantization;
+	const ccs_float_t      mu             = d->mu;
+	const ccs_float_t      sigma          = d->sigma;
+	const int              quantize       = d->quantize;
+	ccs_float_t lower = -CCS_INFINITY;
+	ccs_float_t upper = CCS_INFINITY;
+	size_t i;
+	if (data_type == CCS_NUM_FLOAT) {
+		if (scale_type == CCS_LOGARITHMIC && quantize)
+			lower = log(quantization.f*0.5);
+		for (i = 0; i < num_values; i++)
+			values[i*stride].f = _ccs_truncated_normal_quantile(
+				uniforms[i*stride], mu, sigma, lower, upper);
+		if (scale_type == CCS_LOGARITHMIC)
+			for (i = 0; i < num_values; i++)
+				values[i*stride].f = exp(values[i*stride].f);
+		if (quantize) {
+			ccs_float_t rquantization = 1.0 / quantization.f;
+			for (i = 0; i < num_values; i++)
+				values[i*stride].f = round(values[i*stride].f * rquantization) * quantization.f;
+		}
+	} else {
+		ccs_float_t q = quantize ? quantization.i*0.5 : 0.5;
+		if (scale_type == CCS_LOGARITHMIC) {
+			lower = log(q);
+			upper = log((ccs_float_t)CCS_INT_MAX + q);
+		} else {
+			lower = (ccs_float_t)CCS_INT_MIN - q;
+			upper = (ccs_float_t)CCS_INT_MAX + q;
+		}
+		for (i = 0; i < num_values; i++)
+			values[i*stride].f = _ccs_truncated_normal_quantile(
+				uniforms[i*stride], mu, sigma, lower, upper);
+		if (scale_type == CCS_LOGARITHMIC)
+			for (i = 0; i < num_values; i++)
+				values[i*stride].f = exp(values[i*stride].f);
+		if (quantize) {
+			ccs_float_t rquantization = 1.0 / quantization.i;
+			for (i = 0; i < num_values; i++)
+				values[i*stride].i = (ccs_int_t)round(values[i*stride].f * rquantization) * quantization.i;
+		} else
+			for (i = 0; i < num_values; i++)
+				values[i*stride].i = round(values[i*stride].f);
+	}
+	return CCS_SUCCESS;
+}
+
 extern ccs_result_t
 ccs_create_normal_distribution(ccs_numeric_type_t  data_type,
                                ccs_float_t         mu,
@@ -8,6 +8,8 @@ struct _ccs_distribution_roulette_data_s {
 	_ccs_distribution_common_data_t  common_data;
 	size_t                           num_areas;
 	ccs_float_t                     *areas;
+	ccs_float_t                     *probs;
+	size_t                          *aliases;
 };
 typedef struct _ccs_distribution_roulette_data_s _ccs_distribution_roulette_data_t;
 
@@ -40,12 +42,21 @@ _ccs_distribution_roulette_soa_samples(_ccs_distribution_data_t  *data,
                                        size_t                     num_values,
                                        ccs_numeric_t            **values);
 
+static ccs_result_t
+_ccs_distribution_roulette_quantiles(_ccs_distribution_data_t *data,
+                                     const ccs_interval_t     *intervals,
+                                     size_t                    num_values,
+                                     size_t                    stride,
+                                     const ccs_float_t        *uniforms,
+                                     ccs_numeric_t            *values);
+
 static _ccs_distribution_ops_t _ccs_distribution_roulette_ops = {
 	{ &_ccs_distribution_del },
 	&_ccs_distribution_roulette_samples,
 	&_ccs_distribution_roulette_get_bounds,
 	&_ccs_distribution_roulette_strided_samples,
-	&_ccs_distribution_roulette_soa_samples
+	&_ccs_distribution_roulette_soa_samples,
+	&_ccs_distribution_roulette_quantiles
 };
 
 static ccs_result_t
@@ -61,6 +72,18 @@ _ccs_distribution_roulette_get_bounds(_ccs_distribution_data_t *data,
 	return CCS_SUCCESS;
 }
 
+// Walker alias method: the integer part of u * num_areas selects a column,
+// and the fractional part selects either the column or its alias.
+static inline ccs_int_t
+_ccs_roulette_alias_sample(_ccs_distribution_roulette_data_t *d,
+                           ccs_float_t                        u) {
+	ccs_float_t x = u * d->num_areas;
+	size_t index = (size_t)x;
+	if (index >= d->num_areas)
+		index = d->num_areas - 1;
+	return (ccs_int_t)(x - index < d->probs[index] ? index : d->aliases[index]);
+}
+
 static ccs_result_t
 _ccs_distribution_roulette_samples(_ccs_distribution_data_t *data,
                                    ccs_rng_t                 rng,
@@ -68,14 +91,9 @@ _ccs_distribution_roulette_samples(_ccs_distribution_data_t *data,
                                    ccs_numeric_t            *values) {
 	_ccs_distribution_roulette_data_t *d = (_ccs_distribution_roulette_data_t *)data;
 
-	gsl_rng *grng;
-	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
-
-	for (size_t i = 0; i < num_values; i++) {
-		ccs_float_t rnd = gsl_rng_uniform(grng);
-		ccs_int_t index = ccs_dichotomic_search(d->num_areas, d->areas, rnd);
-		values[i].i = index;
-	}
+	CCS_VALIDATE(ccs_rng_uniform_fill(rng, num_values, (ccs_float_t *)values));
+	for (size_t i = 0; i < num_values; i++)
+		values[i].i = _ccs_roulette_alias_sample(d, values[i].f);
 	return CCS_SUCCESS;
 }
 
@@ -87,13 +105,14 @@ _ccs_distribution_roulette_strided_samples(_ccs_distribution_data_t *data,
                                            ccs_numeric_t            *values) {
 	_ccs_distribution_roulette_data_t *d = (_ccs_distribution_roulette_data_t *)data;
 
-	gsl_rng *grng;
-	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
+	ccs_float_t uniforms[CCS_UNIFORMS_BLOCK_SIZE];
 
-	for (size_t i = 0; i < num_values; i++) {
-		ccs_float_t rnd = gsl_rng_uniform(grng);
-		ccs_int_t index = ccs_dichotomic_search(d->num_areas, d->areas, rnd);
-		values[i*stride].i = index;
+	for (size_t i = 0; i < num_values; i += CCS_UNIFORMS_BLOCK_SIZE) {
+		size_t count = num_values - i < CCS_UNIFORMS_BLOCK_SIZE ?
+		               num_values - i : CCS_UNIFORMS_BLOCK_SIZE;
+		CCS_VALIDATE(ccs_rng_uniform_fill(rng, count, uniforms));
+		for (size_t j = 0; j < count; j++)
+			values[(i+j)*stride].i = _ccs_roulette_alias_sample(d, uniforms[j]);
 	}
 	return CCS_SUCCESS;
 }
@@ -108,6 +127,65 @@ _ccs_distribution_roulette_soa_samples(_ccs_distribution_data_t  *data,
 	return CCS_SUCCESS;
 }
 
+static ccs_result_t
+_ccs_distribution_roulette_quantiles(_ccs_distribution_data_t *data,
+                                     const ccs_interval_t     *intervals,
+                                     size_t                    num_values,
+                                     size_t                    stride,
+                                     const ccs_float_t        *uniforms,
+                                     ccs_numeric_t            *values) {
+	if (intervals)
+		return _ccs_distribution_truncated_quantiles(data,
+			&_ccs_distribution_roulette_quantiles, intervals, num_values, stride,
+			uniforms, values);
+	_ccs_distribution_roulette_data_t *d = (_ccs_distribution_roulette_data_t *)data;
+
+	for (size_t i = 0; i < num_values; i++) {
+		ccs_int_t index = ccs_dichotomic_search(d->num_areas, d->areas, uniforms[i*stride]);
+		values[i*stride].i = index;
+	}
+	return CCS_SUCCESS;
+}
+
+// Vose's construction of the alias table: columns of probability lower than
+// the average are topped up by columns of higher probability, which become
+// their alias. work holds the small columns at its start and the large
+// columns at its end.
+static void
+_ccs_roulette_build_aliases(size_t             num_areas,
+                            const ccs_float_t *areas,
+                            ccs_float_t        inv_sum,
+                            ccs_float_t       *probs,
+                            size_t            *aliases,
+                            size_t            *work) {
+	size_t num_small = 0;
+	size_t large = num_areas;
+
+	for (size_t i = 0; i < num_areas; i++) {
+		probs[i] = areas[i] * inv_sum * num_areas;
+		aliases[i] = i;
+		if (probs[i] < 1.0)
+			work[num_small++] = i;
+		else
+			work[--large] = i;
+	}
+	while (num_small && large < num_areas) {
+		size_t s = work[--num_small];
+		size_t l = work[large];
+		aliases[s] = l;
+		probs[l] -= 1.0 - probs[s];
+		if (probs[l] < 1.0) {
+			large++;
+			work[num_small++] = l;
+		}
+	}
+	// Remaining columns are full, up to rounding errors
+	for (size_t i = 0; i < num_small; i++)
+		probs[work[i]] = 1.0;
+	for (size_t i = large; i < num_areas; i++)
+		probs[work[i]] = 1.0;
+}
+
 ccs_result_t
 ccs_create_roulette_distribution(size_t              num_areas,
                                  ccs_float_t        *areas,
@@ -129,20 +207,27 @@ ccs_create_roulette_distribution(size_t              num_areas,
 	if (isnan(inv_sum) || !isfinite(inv_sum))
 		return -CCS_INVALID_VALUE;
 
-	uintptr_t mem = (uintptr_t)calloc(1, sizeof(struct _ccs_distribution_s) + sizeof(_ccs_distribution_roulette_data_t) + sizeof(ccs_float_t)*(num_areas + 1) + sizeof(ccs_numeric_type_t));
+	size_t *work = (size_t *)malloc(sizeof(size_t)*num_areas);
+	if (!work)
+		return -CCS_OUT_OF_MEMORY;
+	uintptr_t mem = (uintptr_t)calloc(1, sizeof(struct _ccs_distribution_s) + sizeof(_ccs_distribution_roulette_data_t) + sizeof(ccs_float_t)*(2*num_areas + 1) + sizeof(size_t)*num_areas + sizeof(ccs_numeric_type_t));
 
-	if (!mem)
+	if (!mem) {
+		free(work);
 		return -CCS_OUT_OF_MEMORY;
+	}
 
 	ccs_distribution_t distrib = (ccs_distribution_t)mem;
 	_ccs_object_init(&(distrib->obj), CCS_DISTRIBUTION, (_ccs_object_ops_t *)&_ccs_distribution_roulette_ops);
 	_ccs_distribution_roulette_data_t * distrib_data = (_ccs_distribution_roulette_data_t *)(mem + sizeof(struct _ccs_distribution_s));
-	distrib_data->common_data.data_types    = (ccs_numeric_type_t *)(mem + sizeof(struct _ccs_distribution_s) + sizeof(_ccs_distribution_roulette_data_t) + sizeof(ccs_float_t)*(num_areas + 1));
+	distrib_data->common_data.data_types    = (ccs_numeric_type_t *)(mem + sizeof(struct _ccs_distribution_s) + sizeof(_ccs_distribution_roulette_data_t) + sizeof(ccs_float_t)*(2*num_areas + 1) + sizeof(size_t)*num_areas);
 	distrib_data->common_data.type          = CCS_ROULETTE;
 	distrib_data->common_data.dimension     = 1;
 	distrib_data->common_data.data_types[0] = CCS_NUM_INTEGER;
 	distrib_data->num_areas                 = num_areas;
 	distrib_data->areas                     = (ccs_float_t *)(mem + sizeof(struct _ccs_distribution_s) + sizeof(_ccs_distribution_roulette_data_t));
+	distrib_data->probs                     = distrib_data->areas + num_areas + 1;
+	distrib_data->aliases                   = (size_t *)(distrib_data->probs + num_areas);
 
 	distrib_data->areas[0] = 0.0;
 	for(size_t i = 1; i <= num_areas; i++) {
@@ -150,9 +235,13 @@ ccs_create_roulette_distribution(size_t              num_areas,
 	}
 	distrib_data->areas[num_areas] = 1.0;
 	if (distrib_data->areas[num_areas] < distrib_data->areas[num_areas-1]) {
+		free(work);
 		free((void *)mem);
 		return -CCS_INVALID_VALUE;
 	}
+	_ccs_roulette_build_aliases(num_areas, areas, inv_sum, distrib_data->probs,
+	                            distrib_data->aliases, work);
+	free(work);
 	distrib->data = (_ccs_distribution_data_t *)distrib_data;
 	*distribution_ret = distrib;
 	return CCS_SUCCESS;
@@ -46,12 +46,21 @@ _ccs_distribution_uniform_soa_samples(_ccs_distribution_data_t  *data,
                                       size_t                     num_values,
                                       ccs_numeric_t            **values);
 
+static ccs_result_t
+_ccs_distribution_uniform_quantiles(_ccs_distribution_data_t *data,
+                                    const ccs_interval_t     *intervals,
+                                    size_t                    num_values,
+                                    size_t                    stride,
+                                    const ccs_float_t        *uniforms,
+                                    ccs_numeric_t            *values);
+
 static _ccs_distribution_ops_t _ccs_distribution_uniform_ops = {
 	{ &_ccs_distribution_del },
 	&_ccs_distribution_uniform_samples,
 	&_ccs_distribution_uniform_get_bounds,
 	&_ccs_distribution_uniform_strided_samples,
-	&_ccs_distribution_uniform_soa_samples
+	&_ccs_distribution_uniform_soa_samples,
+	&_ccs_distribution_uniform_quantiles
  };
 
 static ccs_result_t
@@ -91,12 +100,17 @@ _ccs_distribution_uniform_strided_samples(_ccs_distribution_data_t *data,
 	const ccs_numeric_t       internal_lower = d->internal_lower;
 	const ccs_numeric_t       internal_upper = d->internal_upper;
 	const int                 quantize       = d->quantize;
+	ccs_float_t uniforms[CCS_UNIFORMS_BLOCK_SIZE];
 	gsl_rng *grng;
 	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
 
 	if (data_type == CCS_NUM_FLOAT) {
-		for (i = 0; i < num_values; i++) {
-			values[i*stride].f = gsl_ran_flat(grng, internal_lower.f, internal_upper.f);
+		for (i = 0; i < num_values; i += CCS_UNIFORMS_BLOCK_SIZE) {
+			size_t count = num_values - i < CCS_UNIFORMS_BLOCK_SIZE ?
+			               num_values - i : CCS_UNIFORMS_BLOCK_SIZE;
+			CCS_VALIDATE(ccs_rng_uniform_fill(rng, count, uniforms));
+			for (size_t j = 0; j < count; j++)
+				values[(i+j)*stride].f = internal_lower.f * (1 - uniforms[j]) + internal_upper.f * uniforms[j];
 		}
 		if (scale_type == CCS_LOGARITHMIC) {
 			for (i = 0; i < num_values; i++)
@@ -113,8 +127,12 @@ _ccs_distribution_uniform_strided_samples(_ccs_distribution_data_t *data,
 					values[i*stride].f += lower.f;
 	} else {
 		if (scale_type == CCS_LOGARITHMIC) {
-			for (i = 0; i < num_values; i++) {
-				values[i*stride].i = floor(exp(gsl_ran_flat(grng, internal_lower.f, internal_upper.f)));
+			for (i = 0; i < num_values; i += CCS_UNIFORMS_BLOCK_SIZE) {
+				size_t count = num_values - i < CCS_UNIFORMS_BLOCK_SIZE ?
+				               num_values - i : CCS_UNIFORMS_BLOCK_SIZE;
+				CCS_VALIDATE(ccs_rng_uniform_fill(rng, count, uniforms));
+				for (size_t j = 0; j < count; j++)
+					values[(i+j)*stride].i = floor(exp(internal_lower.f * (1 - uniforms[j]) + internal_upper.f * uniforms[j]));
 			}
 			if (quantize)
 				for (i = 0; i < num_values; i++)
@@ -152,9 +170,9 @@ _ccs_distribution_uniform_samples(_ccs_distribution_data_t *data,
 	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
 
 	if (data_type == CCS_NUM_FLOAT) {
-		for (i = 0; i < num_values; i++) {
-			values[i].f = gsl_ran_flat(grng, internal_lower.f, internal_upper.f);
-		}
+		CCS_VALIDATE(ccs_rng_uniform_fill(rng, num_values, (ccs_float_t *)values));
+		for (i = 0; i < num_values; i++)
+			values[i].f = internal_lower.f * (1 - values[i].f) + internal_upper.f * values[i].f;
 		if (scale_type == CCS_LOGARITHMIC) {
 			for (i = 0; i < num_values; i++)
 				values[i].f = exp(values[i].f);
@@ -170,9 +188,9 @@ _ccs_distribution_uniform_samples(_ccs_distribution_data_t *data,
 					values[i].f += lower.f;
 	} else {
 		if (scale_type == CCS_LOGARITHMIC) {
-			for (i = 0; i < num_values; i++) {
-				values[i].i = floor(exp(gsl_ran_flat(grng, internal_lower.f, internal_upper.f)));
-			}
+			CCS_VALIDATE(ccs_rng_uniform_fill(rng, num_values, (ccs_float_t *)values));
+			for (i = 0; i < num_values; i++)
+				values[i].i = floor(exp(internal_lower.f * (1 - values[i].f) + internal_upper.f * values[i].f));
 			if (quantize)
 				for (i = 0; i < num_values; i++)
 					values[i].i = ((values[i].i - lower.i)/quantization.i) * quantization.i + lower.i;
@@ -201,6 +219,72 @@ _ccs_distribution_uniform_soa_samples(_ccs_distribution_data_t  *data,
 	return CCS_SUCCESS;
 }
 
+// Same transformations as the samplers, with the uniforms in place of the
+// generator draws.
+static ccs_result_t
+_ccs_distribution_uniform_quantiles(_ccs_distribution_data_t *data,
+                                    const ccs_interval_t     *intervals,
+                                    size_t                    num_values,
+                                    size_t                    stride,
+                                    const ccs_float_t        *uniforms,
+                                    ccs_numeric_t            *values) {
+	if (intervals)
+		return _ccs_distribution_truncated_quantiles(data,
+			&_ccs_distribution_uniform_quantiles, intervals, num_values, stride,
+			uniforms, values);
+	_ccs_distribution_uniform_data_t *d = (_ccs_distribution_uniform_data_t *)data;
+	size_t i;
+	const ccs_numeric_type_t  data_type      = d->common_data.data_types[0];
+	const ccs_scale_type_t    scale_type     = d->scale_type;
+	const ccs_numeric_t       quantization   = d->quantization;
+	const ccs_numeric_t       lower          = d->lower;
+	const ccs_numeric_t       internal_lower = d->internal_lower;
+	const ccs_numeric_t       internal_upper = d->internal_upper;
+	const int                 quantize       = d->quantize;
+
+	if (data_type == CCS_NUM_FLOAT) {
+		for (i = 0; i < num_values; i++) {
+			ccs_float_t u = uniforms[i*stride];
+			values[i*stride].f = internal_lower.f * (1 - u) + internal_upper.f * u;
+		}
+		if (scale_type == CCS_LOGARITHMIC) {
+			for (i = 0; i < num_values; i++)
+				values[i*stride].f = exp(values[i*stride].f);
+			if (quantize)
+				for (i = 0; i < num_values; i++)
+					values[i*stride].f = floor((values[i*stride].f - lower.f)/quantization.f) * quantization.f + lower.f;
+		} else
+			if (quantize)
+				for (i = 0; i < num_values; i++)
+					values[i*stride].f = floor(values[i*stride].f) * quantization.f + lower.f;
+			else
+				for (i = 0; i < num_values; i++)
+					values[i*stride].f += lower.f;
+	} else {
+		if (scale_type == CCS_LOGARITHMIC) {
+			for (i = 0; i < num_values; i++) {
+				ccs_float_t u = uniforms[i*stride];
+				values[i*stride].i = floor(exp(internal_lower.f * (1 - u) + internal_upper.f * u));
+			}
+			if (quantize)
+				for (i = 0; i < num_values; i++)
+					values[i*stride].i = ((values[i*stride].i - lower.i)/quantization.i) * quantization.i + lower.i;
+		} else {
+			for (i = 0; i < num_values; i++) {
+				ccs_int_t v = (ccs_int_t)(uniforms[i*stride] * internal_upper.i);
+				values[i*stride].i = v < internal_upper.i ? v : internal_upper.i - 1;
+			}
+			if (quantize)
+				for (i = 0; i < num_values; i++)
+					values[i*stride].i = values[i*stride].i * quantization.i + lower.i;
+			else
+				for (i = 0; i < num_values; i++)
+					values[i*stride].i += lower.i;
+		}
+	}
+	return CCS_SUCCESS;
+}
+
 ccs_result_t
 ccs_create_uniform_distribution(ccs_numeric_type_t  data_type,
                                 ccs_numeric_t       lower,
@@ -1,5 +1,6 @@
 #include "cconfigspace_internal.h"
 #include "expression_internal.h"
+#include "context_internal.h"
 #include <math.h>
 #include <string.h>
 #include "utarray.h"
@@ -92,6 +93,7 @@ _ccs_expression_del(ccs_object_t o) {
 	_ccs_expression_data_t *data = d->data;
 	for (size_t i = 0; i < data->num_nodes; i++)
 		ccs_release_object(data->nodes[i]);
+	free(data->program);
 	return CCS_SUCCESS;
 }
 
@@ -509,6 +511,144 @@ static _ccs_expression_ops_t _ccs_expr_greater_or_equal_ops = {
 	&_ccs_expr_greater_or_equal_eval
 };
 
+// Order of the membership index of IN expressions. Values that can be equal
+// according to _ccs_datum_test_equal_generic compare equal: integers and
+// floats are ordered by numerical value, NaNs are grouped together, and other
+// values are ordered by type and then by value.
+static inline int
+_ccs_expr_in_key_class(const ccs_datum_t *d) {
+	if (d->type == CCS_INTEGER)
+		return 0;
+	if (d->type == CCS_FLOAT)
+		return isnan(d->value.f) ? 1 : 0;
+	return 2;
+}
+
+static inline int
+_ccs_expr_in_key_cmp(const ccs_datum_t *a, const ccs_datum_t *b) {
+	int ca = _ccs_expr_in_key_class(a);
+	int cb = _ccs_expr_in_key_class(b);
+	if (ca != cb)
+		return ca < cb ? -1 : 1;
+	if (ca == 0) {
+		ccs_float_t fa = a->type == CCS_INTEGER ? (ccs_float_t)a->value.i : a->value.f;
+		ccs_float_t fb = b->type == CCS_INTEGER ? (ccs_float_t)b->value.i : b->value.f;
+		return fa < fb ? -1 : fa > fb ? 1 : 0;
+	}
+	if (ca == 1)
+		return 0;
+	if (a->type != b->type)
+		return a->type < b->type ? -1 : 1;
+	switch (a->type) {
+	case CCS_STRING:
+	{
+		ccs_int_t cmp = _ccs_string_cmp(a->value.s, b->value.s);
+		return cmp < 0 ? -1 : cmp > 0 ? 1 : 0;
+	}
+	case CCS_NONE:
+		return 0;
+	default:
+		return memcmp(&(a->value), &(b->value), sizeof(ccs_value_t));
+	}
+}
+
+static int
+_ccs_expr_in_entry_cmp(const void *a, const void *b) {
+	const _ccs_expression_in_entry_t *ea = (const _ccs_expression_in_entry_t *)a;
+	const _ccs_expression_in_entry_t *eb = (const _ccs_expression_in_entry_t *)b;
+	int cmp = _ccs_expr_in_key_cmp(&ea->value, &eb->value);
+	if (cmp)
+		return cmp;
+	return ea->index < eb->index ? -1 : ea->index > eb->index ? 1 : 0;
+}
+
+// Number of entries of the membership index of an IN expression with the
+// given list node, 0 if the node is not a list of literals
+static inline size_t
+_ccs_expr_in_index_size(ccs_datum_t *node) {
+	ccs_object_type_t t;
+	if (node->type != CCS_OBJECT ||
+	    ccs_object_get_type(node->value.o, &t) != CCS_SUCCESS ||
+	    t != CCS_EXPRESSION)
+		return 0;
+	_ccs_expression_data_t *list = ((ccs_expression_t)node->value.o)->data;
+	if (list->type != CCS_LIST)
+		return 0;
+	for (size_t i = 0; i < list->num_nodes; i++)
+		if (list->nodes[i]->data->type != CCS_LITERAL)
+			return 0;
+	return list->num_nodes;
+}
+
+static ccs_result_t
+_ccs_expression_check_operand(ccs_hyperparameter_t       hyperparameter,
+                              ccs_hyperparameter_type_t  type,
+                              ccs_datum_t               *value);
+
+static inline ccs_result_t
+_ccs_expr_in_index_init(_ccs_expression_in_data_t  *d,
+                        _ccs_expression_in_entry_t *entries,
+                        size_t                      num_entries) {
+	ccs_expression_t          left = d->expr.nodes[0];
+	ccs_expression_t         *list = d->expr.nodes[1]->data->nodes;
+	ccs_hyperparameter_t      hyperparameter = NULL;
+	ccs_hyperparameter_type_t type = CCS_HYPERPARAMETER_TYPE_MAX;
+	if (left->data->type == CCS_VARIABLE) {
+		hyperparameter =
+			((_ccs_expression_variable_data_t *)left->data)->hyperparameter;
+		CCS_VALIDATE(ccs_hyperparameter_get_type(hyperparameter, &type));
+	}
+	d->invalid_index = num_entries;
+	for (size_t i = 0; i < num_entries; i++) {
+		entries[i].value = ((_ccs_expression_literal_data_t *)list[i]->data)->value;
+		entries[i].index = i;
+		if (d->invalid_index == num_entries) {
+			ccs_result_t err = _ccs_expression_check_operand(
+			    hyperparameter, type, &entries[i].value);
+			if (err == -CCS_INVALID_VALUE)
+				d->invalid_index = i;
+			else if (err)
+				return CCS_SUCCESS;
+		}
+	}
+	qsort(entries, num_entries, sizeof(_ccs_expression_in_entry_t),
+	      &_ccs_expr_in_entry_cmp);
+	d->num_entries = num_entries;
+	d->entries = entries;
+	return CCS_SUCCESS;
+}
+
+// Same result as testing the elements of the list in order
+static inline ccs_result_t
+_ccs_expr_in_lookup(_ccs_expression_in_data_t *d,
+                    ccs_datum_t               *value,
+                    ccs_datum_t               *result) {
+	_ccs_expression_in_entry_t *entries = d->entries;
+	size_t lo = 0;
+	size_t hi = d->num_entries;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (_ccs_expr_in_key_cmp(&entries[mid].value, value) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	for (; lo < d->num_entries &&
+	       !_ccs_expr_in_key_cmp(&entries[lo].value, value) &&
+	       entries[lo].index < d->invalid_index; lo++) {
+		ccs_bool_t equal;
+		if (!_ccs_datum_test_equal_generic(value, &entries[lo].value, &equal) &&
+		    equal) {
+			*result = ccs_true;
+			return CCS_SUCCESS;
+		}
+	}
+	if (d->invalid_index < d->num_entries)
+		return -CCS_INVALID_VALUE;
+	*result = ccs_false;
+	return CCS_SUCCESS;
+}
+
 static ccs_result_t
 _ccs_expr_in_eval(_ccs_expression_data_t *data,
                   ccs_context_t           context,
@@ -528,6 +668,9 @@ _ccs_expr_in_eval(_ccs_expression_data_t *data,
 	ccs_datum_t               left;
 	ccs_hyperparameter_type_t htl = CCS_HYPERPARAMETER_TYPE_MAX;
 	eval_node(data, context, values, left, &htl);
+	if (((_ccs_expression_in_data_t *)data)->entries)
+		return _ccs_expr_in_lookup((_ccs_expression_in_data_t *)data,
+		                           &left, result);
 	for (size_t i = 0; i < num_nodes; i++) {
 		ccs_datum_t right;
 		CCS_VALIDATE(ccs_expression_list_eval_node(data->nodes[1], context, values, i, &right));
@@ -849,9 +992,34 @@ static ccs_result_t
 _ccs_expr_variable_del(ccs_object_t o) {
 	_ccs_expression_variable_data_t *d =
 		(_ccs_expression_variable_data_t *)((ccs_expression_t)o)->data;
+	free(d->expr.program);
 	return ccs_release_object(d->hyperparameter);
 }
 
+// Variables remember the index their hyperparameter was last found at. A
+// hyperparameter appears at most once in a context, so the hint is valid for
+// any context holding the hyperparameter at that index. It is thus shared by
+// all contexts and threads, and only needs relaxed atomic accesses.
+static inline ccs_result_t
+_ccs_expr_variable_get_index(_ccs_expression_variable_data_t *d,
+                             ccs_context_t                    context,
+                             size_t                          *index_ret) {
+	if (context && context->data) {
+		UT_array *array = context->data->hyperparameters;
+		size_t index = __atomic_load_n(&d->index_hint, __ATOMIC_RELAXED);
+		if (index < utarray_len(array) &&
+		    ((_ccs_hyperparameter_wrapper_t *)utarray_eltptr(
+		       array, index))->hyperparameter == d->hyperparameter) {
+			*index_ret = index;
+			return CCS_SUCCESS;
+		}
+	}
+	CCS_VALIDATE(ccs_context_get_hyperparameter_index(context,
+	    d->hyperparameter, index_ret));
+	__atomic_store_n(&d->index_hint, *index_ret, __ATOMIC_RELAXED);
+	return CCS_SUCCESS;
+}
+
 static ccs_result_t
 _ccs_expr_variable_eval(_ccs_expression_data_t *data,
                         ccs_context_t           context,
@@ -861,8 +1029,7 @@ _ccs_expr_variable_eval(_ccs_expression_data_t *data,
 		(_ccs_expression_variable_data_t *)data;
 	size_t index;
 	CCS_CHECK_PTR(values);
-	CCS_VALIDATE(ccs_context_get_hyperparameter_index(context,
-	    (ccs_hyperparameter_t)(d->hyperparameter), &index));
+	CCS_VALIDATE(_ccs_expr_variable_get_index(d, context, &index));
 	*result = values[index];
 	if (result->type == CCS_INACTIVE)
 		return -CCS_INACTIVE_HYPERPARAMETER;
@@ -1037,10 +1204,18 @@ ccs_create_expression(ccs_expression_type_t  type,
 			return -CCS_INVALID_VALUE;
 	}
 
+	size_t data_size = sizeof(struct _ccs_expression_data_s);
+	size_t num_entries = 0;
+	if (type == CCS_IN) {
+		data_size = sizeof(_ccs_expression_in_data_t);
+		num_entries = _ccs_expr_in_index_size(nodes + 1);
+	}
+
 	uintptr_t mem = (uintptr_t)calloc(1,
 	    sizeof(struct _ccs_expression_s) +
-	    sizeof(struct _ccs_expression_data_s) +
-	    num_nodes*sizeof(ccs_expression_t));
+	    data_size +
+	    num_nodes*sizeof(ccs_expression_t) +
+	    num_entries*sizeof(_ccs_expression_in_entry_t));
 	if (!mem)
 		return -CCS_OUT_OF_MEMORY;
 
@@ -1053,7 +1228,7 @@ ccs_create_expression(ccs_expression_type_t  type,
 	expression_data->num_nodes = num_nodes;
 	expression_data->nodes = (ccs_expression_t *)(mem +
 	    sizeof(struct _ccs_expression_s) +
-	    sizeof(struct _ccs_expression_data_s));
+	    data_size);
 	for (size_t i = 0; i < num_nodes; i++) {
 		if (nodes[i].type == CCS_OBJECT) {
 			ccs_object_type_t t;
@@ -1074,6 +1249,11 @@ ccs_create_expression(ccs_expression_type_t  type,
 			    nodes[i], expression_data->nodes + i), cleanup);
 		}
 	}
+	if (num_entries)
+		CCS_VALIDATE_ERR_GOTO(err, _ccs_expr_in_index_init(
+		    (_ccs_expression_in_data_t *)expression_data,
+		    (_ccs_expression_in_entry_t *)(expression_data->nodes + num_nodes),
+		    num_entries), cleanup);
 	expression->data = expression_data;
 	*expression_ret = expression;
 	return CCS_SUCCESS;
@@ -1104,6 +1284,23 @@ ccs_create_unary_expression(ccs_expression_type_t  type,
 	return ccs_create_expression(type, 1, &node, expression_ret);
 }
 
+static inline int
+_ccs_expression_check_bindings(_ccs_expression_program_t *program,
+                               ccs_context_t              context) {
+	if (!program->num_bindings)
+		return 1;
+	UT_array *array = context->data->hyperparameters;
+	size_t num_hyperparameters = utarray_len(array);
+	for (size_t i = 0; i < program->num_bindings; i++) {
+		_ccs_expression_binding_t *b = program->bindings + i;
+		if (b->index >= num_hyperparameters ||
+		    ((_ccs_hyperparameter_wrapper_t *)utarray_eltptr(
+		       array, b->index))->hyperparameter != b->hyperparameter)
+			return 0;
+	}
+	return 1;
+}
+
 ccs_result_t
 ccs_expression_eval(ccs_expression_t  expression,
                     ccs_context_t     context,
@@ -1111,6 +1308,14 @@ ccs_expression_eval(ccs_expression_t  expression,
                     ccs_datum_t      *result_ret) {
 	CCS_CHECK_OBJ(expression, CCS_EXPRESSION);
 	CCS_CHECK_PTR(result_ret);
+	_ccs_expression_program_t *program = expression->data->program;
+	if (program && program->context == context &&
+	    (values || !program->num_bindings) &&
+	    _ccs_expression_check_bindings(program, context)) {
+		ccs_datum_t *stack = (ccs_datum_t *)alloca(
+			program->stack_size * sizeof(ccs_datum_t));
+		return _ccs_expression_run(program->code, values, stack, result_ret);
+	}
 	_ccs_expression_ops_t *ops = ccs_expression_get_ops(expression);
 	return ops->eval(expression->data, context, values, result_ret);
 }
@@ -1314,3 +1519,1372 @@ errutarray:
 	return err;
 }
 
+static const UT_icd _index_icd = {
+	sizeof(size_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+static ccs_result_t
+_get_required_indexes(ccs_expression_t  expression,
+                      ccs_context_t     context,
+                      UT_array         *array) {
+	ccs_result_t err = CCS_SUCCESS;
+	switch (expression->data->type) {
+	case CCS_VARIABLE: {
+		size_t index;
+		CCS_VALIDATE(ccs_context_get_hyperparameter_index(context,
+			((_ccs_expression_variable_data_t *)expression->data)->hyperparameter,
+			&index));
+		utarray_push_back(array, &index);
+		break;
+	}
+	case CCS_LITERAL:
+	case CCS_LIST:
+		break;
+	case CCS_IN:
+		// List elements are only evaluated until one matches
+		CCS_VALIDATE(_get_required_indexes(expression->data->nodes[0],
+		                                   context, array));
+		break;
+	case CCS_OR: {
+		// Only hyperparameters required by both sides are required
+		size_t    start = utarray_len(array);
+		size_t    count = start;
+		size_t   *indexes;
+		UT_array *right;
+		CCS_VALIDATE(_get_required_indexes(expression->data->nodes[0],
+		                                   context, array));
+		utarray_new(right, &_index_icd);
+		CCS_VALIDATE_ERR_GOTO(err, _get_required_indexes(
+			expression->data->nodes[1], context, right), end);
+		indexes = (size_t *)utarray_front(array);
+		for (size_t i = start; i < utarray_len(array); i++) {
+			size_t *p_index = NULL;
+			while ( (p_index = (size_t *)utarray_next(right, p_index)) )
+				if (*p_index == indexes[i]) {
+					indexes[count++] = indexes[i];
+					break;
+				}
+		}
+		utarray_resize(array, count);
+	end:
+		utarray_free(right);
+		break;
+	}
+	default:
+		for (size_t i = 0; i < expression->data->num_nodes; i++)
+			CCS_VALIDATE(_get_required_indexes(expression->data->nodes[i],
+			                                   context, array));
+	}
+	return err;
+}
+
+static int _index_sort(const void *a, const void *b) {
+	size_t ia = *(size_t *)a;
+	size_t ib = *(size_t *)b;
+	return ia < ib ? -1 : ia > ib ? 1 : 0;
+}
+
+ccs_result_t
+_ccs_expression_get_required_indexes(ccs_expression_t  expression,
+                                     ccs_context_t     context,
+                                     UT_array         *indexes) {
+	size_t start = utarray_len(indexes);
+	size_t count = start;
+	CCS_VALIDATE(_get_required_indexes(expression, context, indexes));
+	if (utarray_len(indexes) == start)
+		return CCS_SUCCESS;
+	size_t *p_index = (size_t *)utarray_front(indexes);
+	qsort(p_index + start, utarray_len(indexes) - start, sizeof(size_t),
+	      &_index_sort);
+	for (size_t i = start; i < utarray_len(indexes); i++)
+		if (count == start || p_index[i] != p_index[count - 1])
+			p_index[count++] = p_index[i];
+	utarray_resize(indexes, count);
+	return CCS_SUCCESS;
+}
+
+
+static ccs_result_t
+_ccs_expression_check_operand(ccs_hyperparameter_t       hyperparameter,
+                              ccs_hyperparameter_type_t  type,
+                              ccs_datum_t               *value) {
+	if (type == CCS_HYPERPARAMETER_TYPE_ORDINAL || type == CCS_HYPERPARAMETER_TYPE_CATEGORICAL) {
+		ccs_bool_t valid;
+		CCS_VALIDATE(ccs_hyperparameter_check_value(hyperparameter, *value, &valid));
+		if (!valid)
+			return -CCS_INVALID_VALUE;
+	} else if (type == CCS_HYPERPARAMETER_TYPE_NUMERICAL || type == CCS_HYPERPARAMETER_TYPE_DISCRETE) {
+		if (value->type != CCS_INTEGER && value->type != CCS_FLOAT)
+			return -CCS_INVALID_VALUE;
+	}
+	return CCS_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_expression_run_compare(const _ccs_expression_instruction_t *ins,
+                            ccs_datum_t                         *left,
+                            ccs_datum_t                         *right,
+                            ccs_datum_t                         *result) {
+	ccs_hyperparameter_type_t htl = ins->hyperparameter_types[0];
+	ccs_hyperparameter_type_t htr = ins->hyperparameter_types[1];
+	ccs_bool_t equal;
+	ccs_int_t  cmp;
+	ccs_result_t err;
+	if (ins->type != CCS_EQUAL && ins->type != CCS_NOT_EQUAL &&
+	    (htl == CCS_HYPERPARAMETER_TYPE_CATEGORICAL ||
+	     htr == CCS_HYPERPARAMETER_TYPE_CATEGORICAL))
+		return -CCS_INVALID_VALUE;
+	if (!(ins->flags & CCS_EXPRESSION_CHECKED_LEFT))
+		CCS_VALIDATE(_ccs_expression_check_operand(
+		    ins->hyperparameters[0], htl, right));
+	if (!(ins->flags & CCS_EXPRESSION_CHECKED_RIGHT))
+		CCS_VALIDATE(_ccs_expression_check_operand(
+		    ins->hyperparameters[1], htr, left));
+	switch (ins->type) {
+	case CCS_EQUAL:
+	case CCS_NOT_EQUAL:
+		err = _ccs_datum_test_equal_generic(left, right, &equal);
+		if (htl == CCS_HYPERPARAMETER_TYPE_MAX &&
+		    htr == CCS_HYPERPARAMETER_TYPE_MAX &&
+		    err)
+			return err;
+		if (ins->type == CCS_NOT_EQUAL)
+			equal = !equal;
+		*result = (equal ? ccs_true : ccs_false);
+		return CCS_SUCCESS;
+	default:
+		break;
+	}
+	if (htl == CCS_HYPERPARAMETER_TYPE_ORDINAL)
+		CCS_VALIDATE(ccs_ordinal_hyperparameter_compare_values(
+		    ins->hyperparameters[0], *left, *right, &cmp));
+	else if (htr == CCS_HYPERPARAMETER_TYPE_ORDINAL)
+		CCS_VALIDATE(ccs_ordinal_hyperparameter_compare_values(
+		    ins->hyperparameters[1], *left, *right, &cmp));
+	else
+		CCS_VALIDATE(_ccs_datum_cmp_generic(left, right, &cmp));
+	switch (ins->type) {
+	case CCS_LESS:
+		*result = (cmp < 0 ? ccs_true : ccs_false);
+		break;
+	case CCS_GREATER:
+		*result = (cmp > 0 ? ccs_true : ccs_false);
+		break;
+	case CCS_LESS_OR_EQUAL:
+		*result = (cmp <= 0 ? ccs_true : ccs_false);
+		break;
+	default:
+		*result = (cmp >= 0 ? ccs_true : ccs_false);
+	}
+	return CCS_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_expression_run_arithmetic(ccs_expression_type_t  type,
+                               ccs_datum_t           *left,
+                               ccs_datum_t           *right,
+                               ccs_datum_t           *result) {
+	if (left->type == CCS_INTEGER && right->type == CCS_INTEGER) {
+		ccs_int_t l = left->value.i;
+		ccs_int_t r = right->value.i;
+		switch (type) {
+		case CCS_ADD:
+			*result = ccs_int(l + r);
+			break;
+		case CCS_SUBSTRACT:
+			*result = ccs_int(l - r);
+			break;
+		case CCS_MULTIPLY:
+			*result = ccs_int(l * r);
+			break;
+		case CCS_DIVIDE:
+			if (r == 0)
+				return -CCS_INVALID_VALUE;
+			*result = ccs_int(l / r);
+			break;
+		default:
+			if (r == 0)
+				return -CCS_INVALID_VALUE;
+			*result = ccs_int(l % r);
+		}
+		return CCS_SUCCESS;
+	}
+	ccs_float_t l, r;
+	if (left->type == CCS_INTEGER)
+		l = left->value.i;
+	else if (left->type == CCS_FLOAT)
+		l = left->value.f;
+	else
+		return -CCS_INVALID_VALUE;
+	if (right->type == CCS_INTEGER)
+		r = right->value.i;
+	else if (right->type == CCS_FLOAT)
+		r = right->value.f;
+	else
+		return -CCS_INVALID_VALUE;
+	switch (type) {
+	case CCS_ADD:
+		*result = ccs_float(l + r);
+		break;
+	case CCS_SUBSTRACT:
+		*result = ccs_float(l - r);
+		break;
+	case CCS_MULTIPLY:
+		*result = ccs_float(l * r);
+		break;
+	case CCS_DIVIDE:
+		if (r == 0.0)
+			return -CCS_INVALID_VALUE;
+		*result = ccs_float(l / r);
+		break;
+	default:
+		if (r == 0.0)
+			return -CCS_INVALID_VALUE;
+		*result = ccs_float(fmod(l, r));
+	}
+	return CCS_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_expression_run_unary(ccs_expression_type_t  type,
+                          ccs_datum_t           *value) {
+	switch (type) {
+	case CCS_POSITIVE:
+		if (value->type != CCS_INTEGER && value->type != CCS_FLOAT)
+			return -CCS_INVALID_VALUE;
+		break;
+	case CCS_NEGATIVE:
+		if (value->type == CCS_INTEGER)
+			*value = ccs_int(- value->value.i);
+		else if (value->type == CCS_FLOAT)
+			*value = ccs_float(- value->value.f);
+		else
+			return -CCS_INVALID_VALUE;
+		break;
+	default:
+		if (value->type != CCS_BOOLEAN)
+			return -CCS_INVALID_VALUE;
+		*value = (value->value.i ? ccs_false : ccs_true);
+	}
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+_ccs_expression_run(const _ccs_expression_instruction_t *code,
+                    ccs_datum_t                         *values,
+                    ccs_datum_t                         *stack,
+                    ccs_datum_t                         *result) {
+	const _ccs_expression_instruction_t *ins = code;
+	ccs_datum_t *sp = stack;
+	ccs_datum_t  value;
+	ccs_bool_t   equal;
+	while (1) {
+		switch (ins->opcode) {
+		case CCS_EXPRESSION_OP_RETURN:
+			sp--;
+			if (sp->type == CCS_INACTIVE)
+				return -CCS_INACTIVE_HYPERPARAMETER;
+			*result = *sp;
+			return CCS_SUCCESS;
+		case CCS_EXPRESSION_OP_FAIL:
+			return (ccs_result_t)ins->value.value.i;
+		case CCS_EXPRESSION_OP_PUSH:
+			*sp++ = ins->value;
+			break;
+		case CCS_EXPRESSION_OP_LOAD:
+			*sp++ = values[ins->operand];
+			break;
+		case CCS_EXPRESSION_OP_JUMP_INACTIVE:
+			if (sp[-1].type == CCS_INACTIVE) {
+				ins = code + ins->operand;
+				continue;
+			}
+			break;
+		case CCS_EXPRESSION_OP_OR_LEFT:
+			if (sp[-1].type != CCS_INACTIVE) {
+				if (sp[-1].type != CCS_BOOLEAN)
+					return -CCS_INVALID_VALUE;
+				if (sp[-1].value.i) {
+					sp[-1] = ccs_true;
+					ins = code + ins->operand;
+					continue;
+				}
+				sp[-1] = ccs_false;
+			}
+			break;
+		case CCS_EXPRESSION_OP_OR_RIGHT:
+			// Left is either false or inactive
+			sp--;
+			if (sp->type == CCS_INACTIVE)
+				sp[-1] = *sp;
+			else if (sp->type != CCS_BOOLEAN)
+				return -CCS_INVALID_VALUE;
+			else if (sp->value.i)
+				sp[-1] = ccs_true;
+			break;
+		case CCS_EXPRESSION_OP_BINARY:
+			// Left is active, it was skipped over otherwise
+			sp--;
+			if (sp->type == CCS_INACTIVE) {
+				sp[-1] = *sp;
+				break;
+			}
+			switch (ins->type) {
+			case CCS_AND:
+				if (sp[-1].type != CCS_BOOLEAN || sp->type != CCS_BOOLEAN)
+					return -CCS_INVALID_VALUE;
+				sp[-1] = ((sp[-1].value.i && sp->value.i) ? ccs_true : ccs_false);
+				break;
+			case CCS_EQUAL:
+			case CCS_NOT_EQUAL:
+			case CCS_LESS:
+			case CCS_GREATER:
+			case CCS_LESS_OR_EQUAL:
+			case CCS_GREATER_OR_EQUAL:
+				CCS_VALIDATE(_ccs_expression_run_compare(
+				    ins, sp - 1, sp, sp - 1));
+				break;
+			default:
+				CCS_VALIDATE(_ccs_expression_run_arithmetic(
+				    ins->type, sp - 1, sp, sp - 1));
+			}
+			break;
+		case CCS_EXPRESSION_OP_UNARY:
+			if (sp[-1].type != CCS_INACTIVE)
+				CCS_VALIDATE(_ccs_expression_run_unary(ins->type, sp - 1));
+			break;
+		case CCS_EXPRESSION_OP_COMPARE_LOAD:
+			// Fused load of a variable and comparison to a literal
+			*sp = values[ins->operand];
+			if (sp->type != CCS_INACTIVE) {
+				value = ins->value;
+				CCS_VALIDATE(_ccs_expression_run_compare(
+				    ins, sp, &value, sp));
+			}
+			sp++;
+			break;
+		case CCS_EXPRESSION_OP_IN_ELEMENT:
+			sp--;
+			if (sp->type == CCS_INACTIVE) {
+				sp[-1] = *sp;
+				ins = code + ins->operand;
+				continue;
+			}
+			if (!(ins->flags & CCS_EXPRESSION_CHECKED_LEFT))
+				CCS_VALIDATE(_ccs_expression_check_operand(
+				    ins->hyperparameters[0], ins->hyperparameter_types[0], sp));
+			if (_ccs_datum_test_equal_generic(sp - 1, sp, &equal))
+				break;
+			if (equal) {
+				sp[-1] = ccs_true;
+				ins = code + ins->operand;
+				continue;
+			}
+			break;
+		case CCS_EXPRESSION_OP_IN_END:
+			sp[-1] = ccs_false;
+			break;
+		case CCS_EXPRESSION_OP_IN_SET:
+			if (sp[-1].type != CCS_INACTIVE)
+				CCS_VALIDATE(_ccs_expr_in_lookup(
+				    (_ccs_expression_in_data_t *)
+				      ((ccs_expression_t)ins->value.value.o)->data,
+				    sp - 1, sp - 1));
+			break;
+		}
+		ins++;
+	}
+}
+
+static inline void
+_ccs_expression_instruction_init(_ccs_expression_instruction_t *ins,
+                                 _ccs_expression_opcode_t       opcode,
+                                 ccs_expression_type_t          type) {
+	ins->opcode = opcode;
+	ins->type = type;
+	ins->operand = 0;
+	ins->value = ccs_none;
+	ins->hyperparameters[0] = NULL;
+	ins->hyperparameters[1] = NULL;
+	ins->hyperparameter_types[0] = CCS_HYPERPARAMETER_TYPE_MAX;
+	ins->hyperparameter_types[1] = CCS_HYPERPARAMETER_TYPE_MAX;
+	ins->flags = 0;
+}
+
+// Expressions that do not depend on any variable
+static int
+_ccs_expression_is_constant(ccs_expression_t expression) {
+	_ccs_expression_data_t *data = expression->data;
+	if (data->type == CCS_VARIABLE)
+		return 0;
+	for (size_t i = 0; i < data->num_nodes; i++)
+		if (!_ccs_expression_is_constant(data->nodes[i]))
+			return 0;
+	return 1;
+}
+
+struct _ccs_expression_compiler_s {
+	ccs_context_t  context;
+	UT_array      *code;
+	size_t         start;
+	size_t         depth;
+	size_t         max_depth;
+};
+typedef struct _ccs_expression_compiler_s _ccs_expression_compiler_t;
+
+// Jumps are emitted with this target, and patched once the end of the
+// construct they belong to is known.
+#define CCS_EXPRESSION_UNPATCHED SIZE_MAX
+
+static inline void
+_ccs_expression_patch(_ccs_expression_compiler_t *c,
+                      size_t                      first) {
+	size_t len = utarray_len(c->code);
+	_ccs_expression_instruction_t *ins =
+		(_ccs_expression_instruction_t *)utarray_front(c->code);
+	for (size_t i = first; i < len; i++)
+		if (ins[i].operand == CCS_EXPRESSION_UNPATCHED)
+			ins[i].operand = len - c->start;
+}
+
+static inline ccs_result_t
+_ccs_expression_emit(_ccs_expression_compiler_t    *c,
+                     _ccs_expression_instruction_t *ins,
+                     int                            stack_delta) {
+	utarray_push_back(c->code, ins);
+	c->depth += stack_delta;
+	if (c->depth > c->max_depth)
+		c->max_depth = c->depth;
+	return CCS_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_expression_compile_node(_ccs_expression_compiler_t *c,
+                             ccs_expression_t            expression);
+
+// Fetch the index and type of a variable node, or the error evaluating it
+// would return.
+static inline ccs_result_t
+_ccs_expression_compile_variable(_ccs_expression_compiler_t *c,
+                                 ccs_expression_t            expression,
+                                 size_t                     *index,
+                                 ccs_hyperparameter_t       *hyperparameter,
+                                 ccs_hyperparameter_type_t  *type) {
+	_ccs_expression_variable_data_t *d =
+		(_ccs_expression_variable_data_t *)expression->data;
+	*hyperparameter = d->hyperparameter;
+	CCS_VALIDATE(ccs_hyperparameter_get_type(d->hyperparameter, type));
+	return _ccs_expr_variable_get_index(d, c->context, index);
+}
+
+// Initialize a comparison instruction with the hyperparameters of the
+// variable operands. Literals compared to a hyperparameter are checked once.
+static ccs_result_t
+_ccs_expression_compare_init(ccs_expression_t               expression,
+                             _ccs_expression_instruction_t *ins) {
+	ccs_expression_t *nodes = expression->data->nodes;
+	_ccs_expression_instruction_init(ins, CCS_EXPRESSION_OP_BINARY,
+	                                 expression->data->type);
+	for (int i = 0; i < 2; i++) {
+		if (nodes[i]->data->type == CCS_VARIABLE) {
+			_ccs_expression_variable_data_t *d =
+				(_ccs_expression_variable_data_t *)nodes[i]->data;
+			ins->hyperparameters[i] = d->hyperparameter;
+			CCS_VALIDATE(ccs_hyperparameter_get_type(
+			    d->hyperparameter, ins->hyperparameter_types + i));
+		}
+	}
+	for (int i = 0; i < 2; i++) {
+		if (ins->hyperparameter_types[i] != CCS_HYPERPARAMETER_TYPE_MAX &&
+		    nodes[1 - i]->data->type == CCS_LITERAL) {
+			_ccs_expression_literal_data_t *d =
+				(_ccs_expression_literal_data_t *)nodes[1 - i]->data;
+			if (_ccs_expression_check_operand(ins->hyperparameters[i],
+			        ins->hyperparameter_types[i], &d->value) == CCS_SUCCESS)
+				ins->flags |= (i ? CCS_EXPRESSION_CHECKED_RIGHT :
+				                   CCS_EXPRESSION_CHECKED_LEFT);
+		}
+	}
+	return CCS_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_expression_compile_compare(_ccs_expression_compiler_t *c,
+                                ccs_expression_t            expression) {
+	_ccs_expression_instruction_t ins;
+	ccs_expression_t *nodes = expression->data->nodes;
+	size_t first = utarray_len(c->code);
+	CCS_VALIDATE(_ccs_expression_compare_init(expression, &ins));
+	if (nodes[0]->data->type == CCS_VARIABLE &&
+	    nodes[1]->data->type == CCS_LITERAL &&
+	    _ccs_expr_variable_get_index(
+	        (_ccs_expression_variable_data_t *)nodes[0]->data,
+	        c->context, &ins.operand) == CCS_SUCCESS) {
+		ins.opcode = CCS_EXPRESSION_OP_COMPARE_LOAD;
+		ins.value = ((_ccs_expression_literal_data_t *)nodes[1]->data)->value;
+		return _ccs_expression_emit(c, &ins, 1);
+	}
+	_ccs_expression_instruction_t jump;
+	_ccs_expression_instruction_init(&jump, CCS_EXPRESSION_OP_JUMP_INACTIVE,
+	                                 expression->data->type);
+	jump.operand = CCS_EXPRESSION_UNPATCHED;
+	CCS_VALIDATE(_ccs_expression_compile_node(c, nodes[0]));
+	CCS_VALIDATE(_ccs_expression_emit(c, &jump, 0));
+	CCS_VALIDATE(_ccs_expression_compile_node(c, nodes[1]));
+	CCS_VALIDATE(_ccs_expression_emit(c, &ins, -1));
+	_ccs_expression_patch(c, first);
+	return CCS_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_expression_compile_in(_ccs_expression_compiler_t *c,
+                           ccs_expression_t            expression) {
+	_ccs_expression_instruction_t ins;
+	ccs_expression_t *nodes = expression->data->nodes;
+	ccs_expression_t  list = nodes[1];
+	size_t first = utarray_len(c->code);
+	_ccs_expression_instruction_init(&ins, CCS_EXPRESSION_OP_FAIL, CCS_IN);
+	if (list->data->type != CCS_LIST) {
+		ins.value = ccs_int(-CCS_INVALID_VALUE);
+		return _ccs_expression_emit(c, &ins, 1);
+	}
+	if (list->data->num_nodes == 0) {
+		ins.opcode = CCS_EXPRESSION_OP_PUSH;
+		ins.value = ccs_false;
+		return _ccs_expression_emit(c, &ins, 1);
+	}
+	CCS_VALIDATE(_ccs_expression_compile_node(c, nodes[0]));
+	if (((_ccs_expression_in_data_t *)expression->data)->entries) {
+		ins.opcode = CCS_EXPRESSION_OP_IN_SET;
+		ins.value = ccs_object(expression);
+		return _ccs_expression_emit(c, &ins, 0);
+	}
+	ins.opcode = CCS_EXPRESSION_OP_JUMP_INACTIVE;
+	ins.operand = CCS_EXPRESSION_UNPATCHED;
+	CCS_VALIDATE(_ccs_expression_emit(c, &ins, 0));
+	ins.opcode = CCS_EXPRESSION_OP_IN_ELEMENT;
+	if (nodes[0]->data->type == CCS_VARIABLE) {
+		_ccs_expression_variable_data_t *d =
+			(_ccs_expression_variable_data_t *)nodes[0]->data;
+		ins.hyperparameters[0] = d->hyperparameter;
+		CCS_VALIDATE(ccs_hyperparameter_get_type(
+		    d->hyperparameter, ins.hyperparameter_types));
+	}
+	for (size_t i = 0; i < list->data->num_nodes; i++) {
+		ccs_expression_t node = list->data->nodes[i];
+		ins.flags = 0;
+		if (node->data->type == CCS_LITERAL &&
+		    _ccs_expression_check_operand(ins.hyperparameters[0],
+		        ins.hyperparameter_types[0],
+		        &((_ccs_expression_literal_data_t *)node->data)->value) ==
+		    CCS_SUCCESS)
+			ins.flags = CCS_EXPRESSION_CHECKED_LEFT;
+		CCS_VALIDATE(_ccs_expression_compile_node(c, node));
+		CCS_VALIDATE(_ccs_expression_emit(c, &ins, -1));
+	}
+	ins.opcode = CCS_EXPRESSION_OP_IN_END;
+	ins.operand = 0;
+	CCS_VALIDATE(_ccs_expression_emit(c, &ins, 0));
+	_ccs_expression_patch(c, first);
+	return CCS_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_expression_compile_node(_ccs_expression_compiler_t *c,
+                             ccs_expression_t            expression) {
+	_ccs_expression_instruction_t ins;
+	_ccs_expression_data_t *data = expression->data;
+	size_t first = utarray_len(c->code);
+	ccs_result_t err;
+	_ccs_expression_instruction_init(&ins, CCS_EXPRESSION_OP_PUSH, data->type);
+	// Constant subtrees are folded into their value, or the error evaluating
+	// them returns
+	if (data->type != CCS_LITERAL && _ccs_expression_is_constant(expression)) {
+		err = ccs_expression_eval(expression, NULL, NULL, &ins.value);
+		if (err) {
+			ins.opcode = CCS_EXPRESSION_OP_FAIL;
+			ins.value = ccs_int(err);
+		}
+		return _ccs_expression_emit(c, &ins, 1);
+	}
+	switch (data->type) {
+	case CCS_LITERAL:
+		ins.value = ((_ccs_expression_literal_data_t *)data)->value;
+		return _ccs_expression_emit(c, &ins, 1);
+	case CCS_VARIABLE:
+		err = _ccs_expression_compile_variable(c, expression, &ins.operand,
+		    ins.hyperparameters, ins.hyperparameter_types);
+		if (err) {
+			ins.opcode = CCS_EXPRESSION_OP_FAIL;
+			ins.value = ccs_int(err);
+		} else
+			ins.opcode = CCS_EXPRESSION_OP_LOAD;
+		return _ccs_expression_emit(c, &ins, 1);
+	case CCS_LIST:
+		ins.opcode = CCS_EXPRESSION_OP_FAIL;
+		ins.value = ccs_int(-CCS_UNSUPPORTED_OPERATION);
+		return _ccs_expression_emit(c, &ins, 1);
+	case CCS_OR:
+		CCS_VALIDATE(_ccs_expression_compile_node(c, data->nodes[0]));
+		ins.opcode = CCS_EXPRESSION_OP_OR_LEFT;
+		ins.operand = CCS_EXPRESSION_UNPATCHED;
+		CCS_VALIDATE(_ccs_expression_emit(c, &ins, 0));
+		CCS_VALIDATE(_ccs_expression_compile_node(c, data->nodes[1]));
+		ins.opcode = CCS_EXPRESSION_OP_OR_RIGHT;
+		ins.operand = 0;
+		CCS_VALIDATE(_ccs_expression_emit(c, &ins, -1));
+		_ccs_expression_patch(c, first);
+		return CCS_SUCCESS;
+	case CCS_EQUAL:
+	case CCS_NOT_EQUAL:
+	case CCS_LESS:
+	case CCS_GREATER:
+	case CCS_LESS_OR_EQUAL:
+	case CCS_GREATER_OR_EQUAL:
+		return _ccs_expression_compile_compare(c, expression);
+	case CCS_IN:
+		return _ccs_expression_compile_in(c, expression);
+	case CCS_POSITIVE:
+	case CCS_NEGATIVE:
+	case CCS_NOT:
+		CCS_VALIDATE(_ccs_expression_compile_node(c, data->nodes[0]));
+		ins.opcode = CCS_EXPRESSION_OP_UNARY;
+		return _ccs_expression_emit(c, &ins, 0);
+	default:
+		CCS_VALIDATE(_ccs_expression_compile_node(c, data->nodes[0]));
+		ins.opcode = CCS_EXPRESSION_OP_JUMP_INACTIVE;
+		ins.operand = CCS_EXPRESSION_UNPATCHED;
+		CCS_VALIDATE(_ccs_expression_emit(c, &ins, 0));
+		CCS_VALIDATE(_ccs_expression_compile_node(c, data->nodes[1]));
+		ins.opcode = CCS_EXPRESSION_OP_BINARY;
+		ins.operand = 0;
+		CCS_VALIDATE(_ccs_expression_emit(c, &ins, -1));
+		_ccs_expression_patch(c, first);
+		return CCS_SUCCESS;
+	}
+}
+
+ccs_result_t
+_ccs_expression_compile(ccs_expression_t  expression,
+                        ccs_context_t     context,
+                        UT_array         *code,
+                        size_t           *stack_size_ret) {
+	CCS_CHECK_OBJ(expression, CCS_EXPRESSION);
+	ccs_result_t err;
+	_ccs_expression_compiler_t c;
+	_ccs_expression_instruction_t ins;
+	c.context = context;
+	c.code = code;
+	c.start = utarray_len(code);
+	c.depth = 0;
+	c.max_depth = 0;
+	CCS_VALIDATE_ERR_GOTO(err, _ccs_expression_compile_node(&c, expression), errcode);
+	_ccs_expression_instruction_init(&ins, CCS_EXPRESSION_OP_RETURN,
+	                                 expression->data->type);
+	CCS_VALIDATE_ERR_GOTO(err, _ccs_expression_emit(&c, &ins, -1), errcode);
+	*stack_size_ret = c.max_depth;
+	return CCS_SUCCESS;
+errcode:
+	utarray_resize(code, c.start);
+	return err;
+}
+
+#undef  utarray_oom
+#define utarray_oom() { \
+	err = -CCS_OUT_OF_MEMORY; \
+	goto errcode; \
+}
+static const UT_icd _instruction_icd = {
+	sizeof(_ccs_expression_instruction_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+ccs_result_t
+ccs_expression_compile(ccs_expression_t expression,
+                       ccs_context_t    context) {
+	CCS_CHECK_OBJ(expression, CCS_EXPRESSION);
+	CCS_VALIDATE(ccs_expression_check_context(expression, context));
+	ccs_result_t err;
+	UT_array *code = NULL;
+	size_t stack_size;
+	size_t num_instructions;
+	size_t num_bindings = 0;
+	_ccs_expression_instruction_t *ins;
+	_ccs_expression_program_t *program;
+	utarray_new(code, &_instruction_icd);
+	CCS_VALIDATE_ERR_GOTO(err, _ccs_expression_compile(expression, context,
+	    code, &stack_size), errcode);
+	num_instructions = utarray_len(code);
+	ins = (_ccs_expression_instruction_t *)utarray_front(code);
+	for (size_t i = 0; i < num_instructions; i++)
+		if (ins[i].opcode == CCS_EXPRESSION_OP_LOAD ||
+		    ins[i].opcode == CCS_EXPRESSION_OP_COMPARE_LOAD)
+			num_bindings++;
+	program = (_ccs_expression_program_t *)malloc(
+		sizeof(_ccs_expression_program_t) +
+		num_instructions * sizeof(_ccs_expression_instruction_t) +
+		num_bindings * sizeof(_ccs_expression_binding_t));
+	if (!program) {
+		err = -CCS_OUT_OF_MEMORY;
+		goto errcode;
+	}
+	program->context = context;
+	program->stack_size = stack_size;
+	program->num_bindings = num_bindings;
+	program->code = (_ccs_expression_instruction_t *)(program + 1);
+	program->bindings = (_ccs_expression_binding_t *)
+		(program->code + num_instructions);
+	memcpy(program->code, ins,
+	       num_instructions * sizeof(_ccs_expression_instruction_t));
+	num_bindings = 0;
+	for (size_t i = 0; i < num_instructions; i++)
+		if (ins[i].opcode == CCS_EXPRESSION_OP_LOAD ||
+		    ins[i].opcode == CCS_EXPRESSION_OP_COMPARE_LOAD) {
+			program->bindings[num_bindings].index = ins[i].operand;
+			program->bindings[num_bindings].hyperparameter =
+				ins[i].hyperparameters[0];
+			num_bindings++;
+		}
+	free(expression->data->program);
+	expression->data->program = program;
+	err = CCS_SUCCESS;
+errcode:
+	if (code)
+		utarray_free(code);
+	return err;
+}
+
+static ccs_result_t
+_ccs_expression_eval_rows(ccs_expression_t  expression,
+                          ccs_context_t     context,
+                          size_t            stride,
+                          ccs_datum_t      *values,
+                          size_t            num_rows,
+                          const size_t     *rows,
+                          ccs_datum_t      *results);
+
+// Evaluate the elements of the list of an IN expression for the rows where the
+// left operand, stored in results, is active and was not found yet.
+static ccs_result_t
+_ccs_expression_eval_rows_in(ccs_expression_t  expression,
+                             ccs_context_t     context,
+                             size_t            stride,
+                             ccs_datum_t      *values,
+                             size_t            num_rows,
+                             const size_t     *rows,
+                             ccs_datum_t      *results) {
+	ccs_expression_t *nodes = expression->data->nodes;
+	ccs_expression_t  list = nodes[1];
+	ccs_hyperparameter_t      hyperparameter = NULL;
+	ccs_hyperparameter_type_t type = CCS_HYPERPARAMETER_TYPE_MAX;
+	ccs_result_t err = CCS_SUCCESS;
+	size_t m = 0;
+	if (list->data->type != CCS_LIST)
+		return -CCS_INVALID_VALUE;
+	if (list->data->num_nodes == 0) {
+		for (size_t i = 0; i < num_rows; i++)
+			results[i] = ccs_false;
+		return CCS_SUCCESS;
+	}
+	CCS_VALIDATE(_ccs_expression_eval_rows(nodes[0], context, stride,
+	    values, num_rows, rows, results));
+	if (((_ccs_expression_in_data_t *)expression->data)->entries) {
+		for (size_t i = 0; i < num_rows; i++)
+			if (results[i].type != CCS_INACTIVE)
+				CCS_VALIDATE(_ccs_expr_in_lookup(
+				    (_ccs_expression_in_data_t *)expression->data,
+				    results + i, results + i));
+		return CCS_SUCCESS;
+	}
+	if (nodes[0]->data->type == CCS_VARIABLE) {
+		hyperparameter =
+			((_ccs_expression_variable_data_t *)nodes[0]->data)->hyperparameter;
+		CCS_VALIDATE(ccs_hyperparameter_get_type(hyperparameter, &type));
+	}
+	uintptr_t mem = (uintptr_t)malloc(num_rows *
+		(sizeof(ccs_datum_t) + 2 * sizeof(size_t)));
+	if (!mem)
+		return -CCS_OUT_OF_MEMORY;
+	ccs_datum_t *col = (ccs_datum_t *)mem;
+	size_t *sub = (size_t *)(col + num_rows);
+	size_t *pos = sub + num_rows;
+	for (size_t i = 0; i < num_rows; i++)
+		if (results[i].type != CCS_INACTIVE) {
+			sub[m] = rows[i];
+			pos[m++] = i;
+		}
+	for (size_t j = 0; m && j < list->data->num_nodes; j++) {
+		ccs_expression_t node = list->data->nodes[j];
+		int checked = node->data->type == CCS_LITERAL &&
+			_ccs_expression_check_operand(hyperparameter, type,
+			    &((_ccs_expression_literal_data_t *)node->data)->value) ==
+			CCS_SUCCESS;
+		size_t n = 0;
+		CCS_VALIDATE_ERR_GOTO(err, _ccs_expression_eval_rows(node, context,
+		    stride, values, m, sub, col), end);
+		for (size_t k = 0; k < m; k++) {
+			ccs_datum_t *left = results + pos[k];
+			ccs_bool_t equal;
+			if (col[k].type == CCS_INACTIVE) {
+				*left = col[k];
+				continue;
+			}
+			if (!checked)
+				CCS_VALIDATE_ERR_GOTO(err, _ccs_expression_check_operand(
+				    hyperparameter, type, col + k), end);
+			if (!_ccs_datum_test_equal_generic(left, col + k, &equal) &&
+			    equal) {
+				*left = ccs_true;
+				continue;
+			}
+			sub[n] = sub[k];
+			pos[n++] = pos[k];
+		}
+		m = n;
+	}
+	for (size_t k = 0; k < m; k++)
+		results[pos[k]] = ccs_false;
+end:
+	free((void *)mem);
+	return err;
+}
+
+// Type of a column of operands when they are all integers or all floats,
+// CCS_NONE otherwise.
+static inline ccs_data_type_t
+_ccs_expression_column_type(const ccs_datum_t *column,
+                            size_t             stride,
+                            size_t             num_rows,
+                            const size_t      *pos) {
+	ccs_data_type_t type = column[pos ? pos[0] : 0].type;
+	if (type != CCS_INTEGER && type != CCS_FLOAT)
+		return CCS_NONE;
+	for (size_t k = 1; k < num_rows; k++)
+		if (column[(pos ? pos[k] : k) * stride].type != type)
+			return CCS_NONE;
+	return type;
+}
+
+#define _ccs_rows_foreach(statement) do { \
+	for (size_t k = 0; k < num_rows; k++) { \
+		ccs_datum_t       *l = left + pos[k]; \
+		const ccs_datum_t *r = right + k * stride; \
+		statement; \
+	} \
+} while (0)
+
+#define _ccs_rows_float(d, t) \
+	((t) == CCS_INTEGER ? (ccs_float_t)(d)->value.i : (d)->value.f)
+
+#define _ccs_rows_bool(c) ((c) ? ccs_true : ccs_false)
+
+// Comparisons and arithmetic operations between numeric operands: the left
+// operands are in left at the positions given by pos, and are replaced by the
+// results, the right operands are in right, stride apart (0 for a literal).
+// When each side only holds integers or only holds floats, the operation is
+// done with one loop specialized for the operation and the types of the
+// operands, and the function returns 1. Otherwise, or when a division by zero
+// would need to be reported, nothing is done and the function returns 0, the
+// caller then evaluates the rows one at a time. The results are the same as
+// with _ccs_expression_run_compare and _ccs_expression_run_arithmetic.
+static int
+_ccs_expression_eval_rows_numeric(ccs_expression_type_t  type,
+                                  size_t                 num_rows,
+                                  const size_t          *pos,
+                                  ccs_datum_t           *left,
+                                  const ccs_datum_t     *right,
+                                  size_t                 stride) {
+	if (!num_rows)
+		return 1;
+	ccs_data_type_t tl = _ccs_expression_column_type(left, 1, num_rows, pos);
+	ccs_data_type_t tr = _ccs_expression_column_type(right, stride,
+	                                                 stride ? num_rows : 1, NULL);
+	if (tl == CCS_NONE || tr == CCS_NONE)
+		return 0;
+	if (type == CCS_DIVIDE || type == CCS_MODULO)
+		for (size_t k = 0; k < (stride ? num_rows : 1); k++)
+			if ((tr == CCS_INTEGER && right[k * stride].value.i == 0) ||
+			    (tr == CCS_FLOAT && right[k * stride].value.f == 0.0))
+				return 0;
+	if (tl == CCS_INTEGER && tr == CCS_INTEGER) {
+		switch (type) {
+		case CCS_EQUAL:
+			_ccs_rows_foreach(*l = _ccs_rows_bool(l->value.i == r->value.i));
+			break;
+		case CCS_NOT_EQUAL:
+			_ccs_rows_foreach(*l = _ccs_rows_bool(l->value.i != r->value.i));
+			break;
+		case CCS_LESS:
+			_ccs_rows_foreach(*l = _ccs_rows_bool(l->value.i < r->value.i));
+			break;
+		case CCS_GREATER:
+			_ccs_rows_foreach(*l = _ccs_rows_bool(l->value.i > r->value.i));
+			break;
+		case CCS_LESS_OR_EQUAL:
+			_ccs_rows_foreach(*l = _ccs_rows_bool(l->value.i <= r->value.i));
+			break;
+		case CCS_GREATER_OR_EQUAL:
+			_ccs_rows_foreach(*l = _ccs_rows_bool(l->value.i >= r->value.i));
+			break;
+		case CCS_ADD:
+			_ccs_rows_foreach(*l = ccs_int(l->value.i + r->value.i));
+			break;
+		case CCS_SUBSTRACT:
+			_ccs_rows_foreach(*l = ccs_int(l->value.i - r->value.i));
+			break;
+		case CCS_MULTIPLY:
+			_ccs_rows_foreach(*l = ccs_int(l->value.i * r->value.i));
+			break;
+		case CCS_DIVIDE:
+			_ccs_rows_foreach(*l = ccs_int(l->value.i / r->value.i));
+			break;
+		case CCS_MODULO:
+			_ccs_rows_foreach(*l = ccs_int(l->value.i % r->value.i));
+			break;
+		default:
+			return 0;
+		}
+		return 1;
+	}
+	switch (type) {
+	// Floats are equal when their representations are, as in
+	// _ccs_datum_test_equal_generic
+	case CCS_EQUAL:
+		if (tl == tr)
+			_ccs_rows_foreach(*l = _ccs_rows_bool(l->value.i == r->value.i));
+		else
+			_ccs_rows_foreach(*l = _ccs_rows_bool(
+				_ccs_rows_float(l, tl) == _ccs_rows_float(r, tr)));
+		break;
+	case CCS_NOT_EQUAL:
+		if (tl == tr)
+			_ccs_rows_foreach(*l = _ccs_rows_bool(l->value.i != r->value.i));
+		else
+			_ccs_rows_foreach(*l = _ccs_rows_bool(
+				_ccs_rows_float(l, tl) != _ccs_rows_float(r, tr)));
+		break;
+	case CCS_LESS:
+		_ccs_rows_foreach(*l = _ccs_rows_bool(
+			_ccs_rows_float(l, tl) < _ccs_rows_float(r, tr)));
+		break;
+	case CCS_GREATER:
+		_ccs_rows_foreach(*l = _ccs_rows_bool(
+			_ccs_rows_float(l, tl) > _ccs_rows_float(r, tr)));
+		break;
+	case CCS_LESS_OR_EQUAL:
+		_ccs_rows_foreach(*l = _ccs_rows_bool(
+			_ccs_rows_float(l, tl) <= _ccs_rows_float(r, tr)));
+		break;
+	case CCS_GREATER_OR_EQUAL:
+		_ccs_rows_foreach(*l = _ccs_rows_bool(
+			_ccs_rows_float(l, tl) >= _ccs_rows_float(r, tr)));
+		break;
+	case CCS_ADD:
+		_ccs_rows_foreach(*l = ccs_float(
+			_ccs_rows_float(l, tl) + _ccs_rows_float(r, tr)));
+		break;
+	case CCS_SUBSTRACT:
+		_ccs_rows_foreach(*l = ccs_float(
+			_ccs_rows_float(l, tl) - _ccs_rows_float(r, tr)));
+		break;
+	case CCS_MULTIPLY:
+		_ccs_rows_foreach(*l = ccs_float(
+			_ccs_rows_float(l, tl) * _ccs_rows_float(r, tr)));
+		break;
+	case CCS_DIVIDE:
+		_ccs_rows_foreach(*l = ccs_float(
+			_ccs_rows_float(l, tl) / _ccs_rows_float(r, tr)));
+		break;
+	case CCS_MODULO:
+		_ccs_rows_foreach(*l = ccs_float(
+			fmod(_ccs_rows_float(l, tl), _ccs_rows_float(r, tr))));
+		break;
+	default:
+		return 0;
+	}
+	return 1;
+}
+
+#undef _ccs_rows_bool
+#undef _ccs_rows_float
+#undef _ccs_rows_foreach
+
+// Evaluate the expression for the rows of values listed in rows, one node at a
+// time over all the rows. As with ccs_expression_eval, right operands are only
+// evaluated for the rows where the left operand is active, or not true for OR
+// expressions. Inactive results are returned as inactive values.
+static ccs_result_t
+_ccs_expression_eval_rows(ccs_expression_t  expression,
+                          ccs_context_t     context,
+                          size_t            stride,
+                          ccs_datum_t      *values,
+                          size_t            num_rows,
+                          const size_t     *rows,
+                          ccs_datum_t      *results) {
+	_ccs_expression_data_t *data = expression->data;
+	_ccs_expression_instruction_t ins;
+	ccs_result_t err = CCS_SUCCESS;
+	size_t index;
+	size_t m = 0;
+	// Comparisons of ordinal and categorical values need their
+	// hyperparameter, the others can use the numeric loops
+	int numeric = 1;
+	if (!num_rows)
+		return CCS_SUCCESS;
+	switch (data->type) {
+	case CCS_LITERAL:
+		for (size_t i = 0; i < num_rows; i++)
+			results[i] = ((_ccs_expression_literal_data_t *)data)->value;
+		return CCS_SUCCESS;
+	case CCS_VARIABLE:
+		CCS_CHECK_PTR(values);
+		CCS_VALIDATE(_ccs_expr_variable_get_index(
+		    (_ccs_expression_variable_data_t *)data, context, &index));
+		for (size_t i = 0; i < num_rows; i++)
+			results[i] = values[rows[i] * stride + index];
+		return CCS_SUCCESS;
+	case CCS_LIST:
+		return -CCS_UNSUPPORTED_OPERATION;
+	case CCS_IN:
+		return _ccs_expression_eval_rows_in(expression, context, stride,
+		    values, num_rows, rows, results);
+	case CCS_POSITIVE:
+	case CCS_NEGATIVE:
+	case CCS_NOT:
+		CCS_VALIDATE(_ccs_expression_eval_rows(data->nodes[0], context,
+		    stride, values, num_rows, rows, results));
+		for (size_t i = 0; i < num_rows; i++)
+			if (results[i].type != CCS_INACTIVE)
+				CCS_VALIDATE(_ccs_expression_run_unary(data->type, results + i));
+		return CCS_SUCCESS;
+	case CCS_EQUAL:
+	case CCS_NOT_EQUAL:
+	case CCS_LESS:
+	case CCS_GREATER:
+	case CCS_LESS_OR_EQUAL:
+	case CCS_GREATER_OR_EQUAL:
+		CCS_VALIDATE(_ccs_expression_compare_init(expression, &ins));
+		for (int i = 0; i < 2; i++)
+			if (ins.hyperparameter_types[i] ==
+			        CCS_HYPERPARAMETER_TYPE_ORDINAL ||
+			    ins.hyperparameter_types[i] ==
+			        CCS_HYPERPARAMETER_TYPE_CATEGORICAL)
+				numeric = 0;
+		break;
+	case CCS_AND:
+		numeric = 0;
+		break;
+	default:
+		break;
+	}
+	CCS_VALIDATE(_ccs_expression_eval_rows(data->nodes[0], context, stride,
+	    values, num_rows, rows, results));
+	uintptr_t mem = (uintptr_t)malloc(num_rows *
+		(sizeof(ccs_datum_t) + 2 * sizeof(size_t)));
+	if (!mem)
+		return -CCS_OUT_OF_MEMORY;
+	ccs_datum_t *col = (ccs_datum_t *)mem;
+	size_t *sub = (size_t *)(col + num_rows);
+	size_t *pos = sub + num_rows;
+	if (data->type == CCS_OR) {
+		for (size_t i = 0; i < num_rows; i++) {
+			if (results[i].type != CCS_INACTIVE) {
+				if (results[i].type != CCS_BOOLEAN) {
+					err = -CCS_INVALID_VALUE;
+					goto end;
+				}
+				if (results[i].value.i) {
+					results[i] = ccs_true;
+					continue;
+				}
+				results[i] = ccs_false;
+			}
+			sub[m] = rows[i];
+			pos[m++] = i;
+		}
+		CCS_VALIDATE_ERR_GOTO(err, _ccs_expression_eval_rows(data->nodes[1],
+		    context, stride, values, m, sub, col), end);
+		for (size_t k = 0; k < m; k++) {
+			if (col[k].type == CCS_INACTIVE)
+				results[pos[k]] = col[k];
+			else if (col[k].type != CCS_BOOLEAN) {
+				err = -CCS_INVALID_VALUE;
+				goto end;
+			} else if (col[k].value.i)
+				results[pos[k]] = ccs_true;
+		}
+		goto end;
+	}
+	for (size_t i = 0; i < num_rows; i++)
+		if (results[i].type != CCS_INACTIVE) {
+			sub[m] = rows[i];
+			pos[m++] = i;
+		}
+	if (numeric && data->nodes[1]->data->type == CCS_LITERAL &&
+	    _ccs_expression_eval_rows_numeric(data->type, m, pos, results,
+	        &((_ccs_expression_literal_data_t *)data->nodes[1]->data)->value,
+	        0))
+		goto end;
+	CCS_VALIDATE_ERR_GOTO(err, _ccs_expression_eval_rows(data->nodes[1],
+	    context, stride, values, m, sub, col), end);
+	if (numeric &&
+	    _ccs_expression_eval_rows_numeric(data->type, m, pos, results, col, 1))
+		goto end;
+	switch (data->type) {
+	case CCS_AND:
+		for (size_t k = 0; k < m; k++) {
+			ccs_datum_t *left = results + pos[k];
+			if (col[k].type == CCS_INACTIVE)
+				*left = col[k];
+			else if (left->type != CCS_BOOLEAN || col[k].type != CCS_BOOLEAN) {
+				err = -CCS_INVALID_VALUE;
+				goto end;
+			} else
+				*left = ((left->value.i && col[k].value.i) ? ccs_true : ccs_false);
+		}
+		break;
+	case CCS_EQUAL:
+	case CCS_NOT_EQUAL:
+	case CCS_LESS:
+	case CCS_GREATER:
+	case CCS_LESS_OR_EQUAL:
+	case CCS_GREATER_OR_EQUAL:
+		for (size_t k = 0; k < m; k++) {
+			ccs_datum_t *left = results + pos[k];
+			if (col[k].type == CCS_INACTIVE)
+				*left = col[k];
+			else
+				CCS_VALIDATE_ERR_GOTO(err, _ccs_expression_run_compare(
+				    &ins, left, col + k, left), end);
+		}
+		break;
+	default:
+		for (size_t k = 0; k < m; k++) {
+			ccs_datum_t *left = results + pos[k];
+			if (col[k].type == CCS_INACTIVE)
+				*left = col[k];
+			else
+				CCS_VALIDATE_ERR_GOTO(err, _ccs_expression_run_arithmetic(
+				    data->type, left, col + k, left), end);
+		}
+	}
+end:
+	free((void *)mem);
+	return err;
+}
+
+ccs_result_t
+ccs_expression_eval_batch(ccs_expression_t  expression,
+                          ccs_context_t     context,
+                          size_t            num_rows,
+                          ccs_datum_t      *values,
+                          ccs_datum_t      *results) {
+	CCS_CHECK_OBJ(expression, CCS_EXPRESSION);
+	CCS_CHECK_ARY(num_rows, results);
+	if (!num_rows)
+		return CCS_SUCCESS;
+	ccs_result_t err;
+	size_t stride = 0;
+	if (context)
+		CCS_VALIDATE(ccs_context_get_num_hyperparameters(context, &stride));
+	size_t *rows = (size_t *)malloc(num_rows * sizeof(size_t));
+	if (!rows)
+		return -CCS_OUT_OF_MEMORY;
+	for (size_t i = 0; i < num_rows; i++)
+		rows[i] = i;
+	err = _ccs_expression_eval_rows(expression, context, stride, values,
+	                                num_rows, rows, results);
+	free(rows);
+	return err;
+}
+
+static inline int
+_ccs_expression_is_literal_bool(ccs_expression_t expression,
+                                ccs_bool_t       value) {
+	if (expression->data->type != CCS_LITERAL)
+		return 0;
+	ccs_datum_t *v = &((_ccs_expression_literal_data_t *)expression->data)->value;
+	return v->type == CCS_BOOLEAN && (v->value.i ? CCS_TRUE : CCS_FALSE) == value;
+}
+
+// Expressions that evaluate to a boolean when they do not fail
+static inline int
+_ccs_expression_is_boolean(ccs_expression_t expression) {
+	switch (expression->data->type) {
+	case CCS_OR:
+	case CCS_AND:
+	case CCS_EQUAL:
+	case CCS_NOT_EQUAL:
+	case CCS_LESS:
+	case CCS_GREATER:
+	case CCS_LESS_OR_EQUAL:
+	case CCS_GREATER_OR_EQUAL:
+	case CCS_NOT:
+	case CCS_IN:
+		return 1;
+	case CCS_LITERAL:
+		return ((_ccs_expression_literal_data_t *)expression->data)->value.type == CCS_BOOLEAN;
+	default:
+		return 0;
+	}
+}
+
+// Expressions that evaluate to a number when they do not fail
+static inline int
+_ccs_expression_is_numeric(ccs_expression_t expression) {
+	switch (expression->data->type) {
+	case CCS_ADD:
+	case CCS_SUBSTRACT:
+	case CCS_MULTIPLY:
+	case CCS_DIVIDE:
+	case CCS_MODULO:
+	case CCS_POSITIVE:
+	case CCS_NEGATIVE:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static const ccs_expression_type_t _ccs_expression_mirror[] = {
+	CCS_OR,
+	CCS_AND,
+	CCS_EQUAL, CCS_NOT_EQUAL,
+	CCS_GREATER, CCS_LESS, CCS_GREATER_OR_EQUAL, CCS_LESS_OR_EQUAL
+};
+
+// Rewrite a node whose children are already simplified. Returns NULL in
+// simplified_ret if no rule applies. Rules must not change the result of the
+// evaluation, including errors, in any context.
+static ccs_result_t
+_ccs_expression_simplify_node(ccs_expression_t  expression,
+                              ccs_expression_t *simplified_ret) {
+	_ccs_expression_data_t *data = expression->data;
+	ccs_expression_t *nodes = data->nodes;
+	ccs_expression_t  node = NULL;
+	*simplified_ret = NULL;
+	if (data->type != CCS_LITERAL && data->type != CCS_LIST &&
+	    _ccs_expression_is_constant(expression)) {
+		ccs_datum_t value;
+		if (ccs_expression_eval(expression, NULL, NULL, &value) == CCS_SUCCESS)
+			return ccs_create_literal(value, simplified_ret);
+		return CCS_SUCCESS;
+	}
+	switch (data->type) {
+	case CCS_OR:
+		// The right operand is not evaluated when the left one is true
+		if (_ccs_expression_is_literal_bool(nodes[0], CCS_TRUE))
+			return ccs_create_literal(ccs_true, simplified_ret);
+		if (_ccs_expression_is_literal_bool(nodes[0], CCS_FALSE) &&
+		    _ccs_expression_is_boolean(nodes[1]))
+			node = nodes[1];
+		else if (_ccs_expression_is_literal_bool(nodes[1], CCS_FALSE) &&
+		         _ccs_expression_is_boolean(nodes[0]))
+			node = nodes[0];
+		break;
+	case CCS_AND:
+		if (_ccs_expression_is_literal_bool(nodes[0], CCS_TRUE) &&
+		    _ccs_expression_is_boolean(nodes[1]))
+			node = nodes[1];
+		else if (_ccs_expression_is_literal_bool(nodes[1], CCS_TRUE) &&
+		         _ccs_expression_is_boolean(nodes[0]))
+			node = nodes[0];
+		break;
+	case CCS_NOT:
+		if (nodes[0]->data->type == CCS_NOT &&
+		    _ccs_expression_is_boolean(nodes[0]->data->nodes[0]))
+			node = nodes[0]->data->nodes[0];
+		break;
+	case CCS_NEGATIVE:
+		if (nodes[0]->data->type == CCS_NEGATIVE &&
+		    _ccs_expression_is_numeric(nodes[0]->data->nodes[0]))
+			node = nodes[0]->data->nodes[0];
+		break;
+	case CCS_POSITIVE:
+		if (_ccs_expression_is_numeric(nodes[0]))
+			node = nodes[0];
+		break;
+	case CCS_EQUAL:
+	case CCS_NOT_EQUAL:
+	case CCS_LESS:
+	case CCS_GREATER:
+	case CCS_LESS_OR_EQUAL:
+	case CCS_GREATER_OR_EQUAL:
+		// Variables go on the left of comparisons
+		if (nodes[0]->data->type == CCS_LITERAL &&
+		    nodes[1]->data->type == CCS_VARIABLE)
+			return ccs_create_binary_expression(
+			    _ccs_expression_mirror[data->type],
+			    ccs_object(nodes[1]), ccs_object(nodes[0]),
+			    simplified_ret);
+		break;
+	default:
+		break;
+	}
+	if (node) {
+		CCS_VALIDATE(ccs_retain_object(node));
+		*simplified_ret = node;
+	}
+	return CCS_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_expression_simplify(ccs_expression_t  expression,
+                         ccs_expression_t *simplified_ret) {
+	_ccs_expression_data_t *data = expression->data;
+	size_t num_nodes = data->num_nodes;
+	ccs_result_t err = CCS_SUCCESS;
+	ccs_expression_t current = NULL;
+	ccs_expression_t simplified;
+	int changed = 0;
+	ccs_datum_t *nodes = NULL;
+	if (num_nodes) {
+		nodes = (ccs_datum_t *)calloc(num_nodes, sizeof(ccs_datum_t));
+		if (!nodes)
+			return -CCS_OUT_OF_MEMORY;
+	}
+	for (size_t i = 0; i < num_nodes; i++) {
+		ccs_expression_t node;
+		CCS_VALIDATE_ERR_GOTO(err, _ccs_expression_simplify(
+		    data->nodes[i], &node), end);
+		nodes[i] = ccs_object(node);
+		if (node != data->nodes[i])
+			changed = 1;
+	}
+	if (changed)
+		CCS_VALIDATE_ERR_GOTO(err, ccs_create_expression(data->type,
+		    num_nodes, nodes, &current), end);
+	else {
+		CCS_VALIDATE_ERR_GOTO(err, ccs_retain_object(expression), end);
+		current = expression;
+	}
+	CCS_VALIDATE_ERR_GOTO(err, _ccs_expression_simplify_node(current,
+	    &simplified), end);
+	if (simplified) {
+		ccs_release_object(current);
+		current = simplified;
+	}
+	*simplified_ret = current;
+	current = NULL;
+end:
+	if (current)
+		ccs_release_object(current);
+	for (size_t i = 0; i < num_nodes; i++)
+		if (nodes[i].value.o)
+			ccs_release_object(nodes[i].value.o);
+	free(nodes);
+	return err;
+}
+
+ccs_result_t
+ccs_expression_simplify(ccs_expression_t  expression,
+                        ccs_expression_t *expression_ret) {
+	CCS_CHECK_OBJ(expression, CCS_EXPRESSION);
+	CCS_CHECK_PTR(expression_ret);
+	return _ccs_expression_simplify(expression, expression_ret);
+}
@@ -1,9 +1,13 @@
 #ifndef _EXPRESSION_INTERNAL_H
 #define _EXPRESSION_INTERNAL_H
+#include "utarray.h"
 
 struct _ccs_expression_data_s;
 typedef struct _ccs_expression_data_s _ccs_expression_data_t;
 
+struct _ccs_expression_program_s;
+typedef struct _ccs_expression_program_s _ccs_expression_program_t;
+
 struct _ccs_expression_ops_s {
 	_ccs_object_ops_t obj_ops;
 
@@ -21,9 +25,10 @@ struct _ccs_expression_s {
 };
 
 struct _ccs_expression_data_s {
-	ccs_expression_type_t  type;
-	size_t                 num_nodes;
-	ccs_expression_t      *nodes;
+	ccs_expression_type_t      type;
+	size_t                     num_nodes;
+	ccs_expression_t          *nodes;
+	_ccs_expression_program_t *program;
 };
 
 struct _ccs_expression_literal_data_s {
@@ -35,6 +40,103 @@ typedef struct _ccs_expression_literal_data_s _ccs_expression_literal_data_t;
 struct _ccs_expression_variable_data_s {
 	_ccs_expression_data_t expr;
 	ccs_hyperparameter_t   hyperparameter;
+	size_t                 index_hint;
 };
 typedef struct _ccs_expression_variable_data_s _ccs_expression_variable_data_t;
+
+struct _ccs_expression_in_entry_s {
+	ccs_datum_t value;
+	size_t      index;
+};
+typedef struct _ccs_expression_in_entry_s _ccs_expression_in_entry_t;
+
+// IN expressions whose list only contains literals keep the list values
+// sorted, to find the first element equal to a value by binary search.
+// invalid_index is the index of the first element that cannot be compared to
+// the hyperparameter on the left, or num_entries.
+struct _ccs_expression_in_data_s {
+	_ccs_expression_data_t      expr;
+	size_t                      num_entries;
+	_ccs_expression_in_entry_t *entries;
+	size_t                      invalid_index;
+};
+typedef struct _ccs_expression_in_data_s _ccs_expression_in_data_t;
+
+// Expressions can be compiled against a context into a flat program for a
+// small stack machine. Variables are resolved to value indexes at compile
+// time, and inactive values are propagated on the stack as CCS_INACTIVE data.
+// Jump targets are relative to the first instruction of the program.
+enum _ccs_expression_opcode_e {
+	CCS_EXPRESSION_OP_RETURN,
+	CCS_EXPRESSION_OP_FAIL,
+	CCS_EXPRESSION_OP_PUSH,
+	CCS_EXPRESSION_OP_LOAD,
+	CCS_EXPRESSION_OP_JUMP_INACTIVE,
+	CCS_EXPRESSION_OP_OR_LEFT,
+	CCS_EXPRESSION_OP_OR_RIGHT,
+	CCS_EXPRESSION_OP_BINARY,
+	CCS_EXPRESSION_OP_UNARY,
+	CCS_EXPRESSION_OP_COMPARE_LOAD,
+	CCS_EXPRESSION_OP_IN_ELEMENT,
+	CCS_EXPRESSION_OP_IN_END,
+	CCS_EXPRESSION_OP_IN_SET
+};
+typedef enum _ccs_expression_opcode_e _ccs_expression_opcode_t;
+
+// The value compared to a hyperparameter has already been checked against it
+#define CCS_EXPRESSION_CHECKED_LEFT  1
+#define CCS_EXPRESSION_CHECKED_RIGHT 2
+
+struct _ccs_expression_instruction_s {
+	_ccs_expression_opcode_t  opcode;
+	ccs_expression_type_t     type;
+	size_t                    operand;
+	ccs_datum_t               value;
+	ccs_hyperparameter_t      hyperparameters[2];
+	ccs_hyperparameter_type_t hyperparameter_types[2];
+	int                       flags;
+};
+typedef struct _ccs_expression_instruction_s _ccs_expression_instruction_t;
+
+// Program of an expression compiled with ccs_expression_compile. The context
+// is not retained: before running the program, the hyperparameters of the
+// context at the bound indexes are checked to be the ones the expression uses.
+struct _ccs_expression_binding_s {
+	size_t               index;
+	ccs_hyperparameter_t hyperparameter;
+};
+typedef struct _ccs_expression_binding_s _ccs_expression_binding_t;
+
+struct _ccs_expression_program_s {
+	ccs_context_t                  context;
+	size_t                         stack_size;
+	size_t                         num_bindings;
+	_ccs_expression_binding_t     *bindings;
+	_ccs_expression_instruction_t *code;
+};
+
+// Appends the program of expression to code, and returns the number of stack
+// slots it needs in stack_size_ret.
+extern ccs_result_t
+_ccs_expression_compile(ccs_expression_t  expression,
+                        ccs_context_t     context,
+                        UT_array         *code,
+                        size_t           *stack_size_ret);
+
+// Appends to indexes, sorted and without duplicates, the indexes in context of
+// the hyperparameters that must all be active for expression to evaluate to
+// something else than -CCS_INACTIVE_HYPERPARAMETER or an error.
+extern ccs_result_t
+_ccs_expression_get_required_indexes(ccs_expression_t  expression,
+                                     ccs_context_t     context,
+                                     UT_array         *indexes);
+
+// Runs a program on values. stack must hold the number of slots returned by
+// _ccs_expression_compile. Returns -CCS_INACTIVE_HYPERPARAMETER if the result
+// depends on an inactive hyperparameter, as ccs_expression_eval would.
+extern ccs_result_t
+_ccs_expression_run(const _ccs_expression_instruction_t *code,
+                    ccs_datum_t                         *values,
+                    ccs_datum_t                         *stack,
+                    ccs_datum_t                         *result);
 #endif //_EXPRESSION_INTERNAL_H
@@ -0,0 +1,319 @@
+#include "cconfigspace_internal.h"
+#include "expression_internal.h"
+#include <ctype.h>
+#include <errno.h>
+#include <string.h>
+
+// Operator precedence parser for the CCS expression grammar. Operators and
+// their precedence and associativity come from the exported tables, and
+// terminals follow ccs_terminal_regexp. Terminals are only recognized where
+// the grammar expects them, so "-1" is a literal where an operand is expected
+// and a substraction otherwise. Identifiers are matched greedily before being
+// compared to the none, true and false symbols.
+
+struct _ccs_expression_parser_s {
+	ccs_context_t  context;
+	const char    *cur;
+};
+typedef struct _ccs_expression_parser_s _ccs_expression_parser_t;
+
+static ccs_result_t
+_ccs_parser_parse_expression(_ccs_expression_parser_t *p,
+                             int                       min_precedence,
+                             ccs_expression_t         *expression_ret);
+
+static inline void
+_ccs_parser_skip_spaces(_ccs_expression_parser_t *p) {
+	while (isspace((unsigned char)*p->cur))
+		p->cur++;
+}
+
+static inline int
+_ccs_parser_accept(_ccs_expression_parser_t *p,
+                   char                      c) {
+	_ccs_parser_skip_spaces(p);
+	if (*p->cur != c)
+		return 0;
+	p->cur++;
+	return 1;
+}
+
+// Longest operator of the given arity at the current position
+static ccs_expression_type_t
+_ccs_parser_match_operator(_ccs_expression_parser_t *p,
+                           int                       arity) {
+	ccs_expression_type_t type = CCS_EXPRESSION_TYPE_MAX;
+	size_t                length = 0;
+	_ccs_parser_skip_spaces(p);
+	for (int i = CCS_OR; i < CCS_EXPRESSION_TYPE_MAX; i++) {
+		const char *symbol = ccs_expression_symbols[i];
+		if (!symbol || ccs_expression_arity[i] != arity)
+			continue;
+		size_t l = strlen(symbol);
+		if (l > length && !strncmp(p->cur, symbol, l)) {
+			type = (ccs_expression_type_t)i;
+			length = l;
+		}
+	}
+	return type;
+}
+
+static ccs_result_t
+_ccs_parser_parse_string(_ccs_expression_parser_t *p,
+                         ccs_expression_t         *expression_ret) {
+	char        quote = *p->cur;
+	const char *c = p->cur + 1;
+	size_t      length = 0;
+	while (*c != quote) {
+		if (!*c || strchr("\t\n\r\f", *c))
+			return -CCS_INVALID_VALUE;
+		if (*c == '\\') {
+			c++;
+			if (!*c || (*c != quote && !strchr("0tnrf\\", *c)))
+				return -CCS_INVALID_VALUE;
+		}
+		c++;
+		length++;
+	}
+	if (!length)
+		return -CCS_INVALID_VALUE;
+	char *str = (char *)malloc(length + 1);
+	if (!str)
+		return -CCS_OUT_OF_MEMORY;
+	char *s = str;
+	for (c = p->cur + 1; *c != quote; c++) {
+		if (*c == '\\') {
+			c++;
+			switch (*c) {
+			case '0': *s++ = '\0'; break;
+			case 't': *s++ = '\t'; break;
+			case 'n': *s++ = '\n'; break;
+			case 'r': *s++ = '\r'; break;
+			case 'f': *s++ = '\f'; break;
+			default:  *s++ = *c;
+			}
+		} else
+			*s++ = *c;
+	}
+	*s = '\0';
+	p->cur = c + 1;
+	ccs_result_t err = ccs_create_literal(ccs_string(str), expression_ret);
+	free(str);
+	return err;
+}
+
+static ccs_result_t
+_ccs_parser_parse_number(_ccs_expression_parser_t *p,
+                         ccs_expression_t         *expression_ret) {
+	const char *c = p->cur;
+	int         is_float = 0;
+	if (*c == '-')
+		c++;
+	while (isdigit((unsigned char)*c))
+		c++;
+	if (*c == '.' && isdigit((unsigned char)c[1])) {
+		is_float = 1;
+		c++;
+		while (isdigit((unsigned char)*c))
+			c++;
+	}
+	if (*c == 'e' || *c == 'E') {
+		const char *e = c + 1;
+		if (*e == '+' || *e == '-')
+			e++;
+		if (isdigit((unsigned char)*e)) {
+			is_float = 1;
+			c = e;
+			while (isdigit((unsigned char)*c))
+				c++;
+		}
+	}
+	char       *end;
+	ccs_datum_t value;
+	errno = 0;
+	if (is_float)
+		value = ccs_float(strtod(p->cur, &end));
+	else
+		value = ccs_int(strtoll(p->cur, &end, 10));
+	if ((!is_float && errno == ERANGE) || end != c)
+		return -CCS_INVALID_VALUE;
+	p->cur = c;
+	return ccs_create_literal(value, expression_ret);
+}
+
+static ccs_result_t
+_ccs_parser_parse_identifier(_ccs_expression_parser_t *p,
+                             ccs_expression_t         *expression_ret) {
+	const char *c = p->cur;
+	while (isalnum((unsigned char)*c) || *c == '_')
+		c++;
+	size_t length = c - p->cur;
+	for (int i = CCS_TERM_NONE; i <= CCS_TERM_FALSE; i++) {
+		const char *symbol = ccs_terminal_symbols[i];
+		if (strlen(symbol) == length && !strncmp(p->cur, symbol, length)) {
+			p->cur = c;
+			return ccs_create_literal(i == CCS_TERM_NONE ? ccs_none :
+			    (i == CCS_TERM_TRUE ? ccs_true : ccs_false), expression_ret);
+		}
+	}
+	char *name = (char *)malloc(length + 1);
+	if (!name)
+		return -CCS_OUT_OF_MEMORY;
+	memcpy(name, p->cur, length);
+	name[length] = '\0';
+	ccs_hyperparameter_t hyperparameter;
+	ccs_result_t err = ccs_context_get_hyperparameter_by_name(p->context,
+	    name, &hyperparameter);
+	free(name);
+	if (err)
+		return err;
+	p->cur = c;
+	return ccs_create_variable(hyperparameter, expression_ret);
+}
+
+static ccs_result_t
+_ccs_parser_parse_value(_ccs_expression_parser_t *p,
+                        ccs_expression_t         *expression_ret) {
+	_ccs_parser_skip_spaces(p);
+	const char *c = p->cur;
+	if (*c == '"' || *c == '\'')
+		return _ccs_parser_parse_string(p, expression_ret);
+	if (isdigit((unsigned char)*c) ||
+	    (*c == '-' && isdigit((unsigned char)c[1])))
+		return _ccs_parser_parse_number(p, expression_ret);
+	if (isalpha((unsigned char)*c) || *c == '_')
+		return _ccs_parser_parse_identifier(p, expression_ret);
+	return -CCS_INVALID_VALUE;
+}
+
+static ccs_result_t
+_ccs_parser_parse_list(_ccs_expression_parser_t *p,
+                       ccs_expression_t         *expression_ret) {
+	ccs_result_t err = CCS_SUCCESS;
+	size_t       num_values = 0;
+	size_t       capacity = 0;
+	ccs_datum_t *values = NULL;
+	if (!_ccs_parser_accept(p, '['))
+		return -CCS_INVALID_VALUE;
+	if (!_ccs_parser_accept(p, ']')) {
+		do {
+			ccs_expression_t value;
+			if (num_values == capacity) {
+				capacity = capacity ? 2 * capacity : 16;
+				ccs_datum_t *tmp = (ccs_datum_t *)realloc(values,
+				    capacity * sizeof(ccs_datum_t));
+				if (!tmp) {
+					err = -CCS_OUT_OF_MEMORY;
+					goto end;
+				}
+				values = tmp;
+			}
+			CCS_VALIDATE_ERR_GOTO(err,
+			    _ccs_parser_parse_value(p, &value), end);
+			values[num_values++] = ccs_object(value);
+		} while (_ccs_parser_accept(p, ','));
+		if (!_ccs_parser_accept(p, ']')) {
+			err = -CCS_INVALID_VALUE;
+			goto end;
+		}
+	}
+	err = ccs_create_expression(CCS_LIST, num_values, values, expression_ret);
+end:
+	for (size_t i = 0; i < num_values; i++)
+		ccs_release_object(values[i].value.o);
+	free(values);
+	return err;
+}
+
+static inline int
+_ccs_parser_operand_precedence(ccs_expression_type_t type) {
+	if (ccs_expression_associativity[type] == CCS_RIGHT_TO_LEFT)
+		return ccs_expression_precedence[type];
+	return ccs_expression_precedence[type] + 1;
+}
+
+static ccs_result_t
+_ccs_parser_parse_operand(_ccs_expression_parser_t *p,
+                          ccs_expression_t         *expression_ret) {
+	ccs_expression_t      node;
+	ccs_expression_type_t type;
+	ccs_result_t          err;
+	if (_ccs_parser_accept(p, '(')) {
+		CCS_VALIDATE(_ccs_parser_parse_expression(p, 0, &node));
+		if (!_ccs_parser_accept(p, ')')) {
+			ccs_release_object(node);
+			return -CCS_INVALID_VALUE;
+		}
+		*expression_ret = node;
+		return CCS_SUCCESS;
+	}
+	// Negative numbers are literals
+	if (!(*p->cur == '-' && isdigit((unsigned char)p->cur[1]))) {
+		type = _ccs_parser_match_operator(p, 1);
+		if (type != CCS_EXPRESSION_TYPE_MAX) {
+			p->cur += strlen(ccs_expression_symbols[type]);
+			CCS_VALIDATE(_ccs_parser_parse_expression(p,
+			    _ccs_parser_operand_precedence(type), &node));
+			err = ccs_create_unary_expression(type, ccs_object(node),
+			                                  expression_ret);
+			ccs_release_object(node);
+			return err;
+		}
+	}
+	return _ccs_parser_parse_value(p, expression_ret);
+}
+
+static ccs_result_t
+_ccs_parser_parse_expression(_ccs_expression_parser_t *p,
+                             int                       min_precedence,
+                             ccs_expression_t         *expression_ret) {
+	ccs_expression_t      left, right, expression;
+	ccs_expression_type_t type;
+	ccs_result_t          err;
+	CCS_VALIDATE(_ccs_parser_parse_operand(p, &left));
+	while (1) {
+		type = _ccs_parser_match_operator(p, 2);
+		if (type == CCS_EXPRESSION_TYPE_MAX ||
+		    ccs_expression_precedence[type] < min_precedence)
+			break;
+		p->cur += strlen(ccs_expression_symbols[type]);
+		if (type == CCS_IN)
+			err = _ccs_parser_parse_list(p, &right);
+		else
+			err = _ccs_parser_parse_expression(p,
+			    _ccs_parser_operand_precedence(type), &right);
+		if (err) {
+			ccs_release_object(left);
+			return err;
+		}
+		err = ccs_create_binary_expression(type, ccs_object(left),
+		                                   ccs_object(right), &expression);
+		ccs_release_object(left);
+		ccs_release_object(right);
+		if (err)
+			return err;
+		left = expression;
+	}
+	*expression_ret = left;
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_expression_parse(ccs_context_t     context,
+                     const char       *expression_string,
+                     ccs_expression_t *expression_ret) {
+	CCS_CHECK_PTR(expression_string);
+	CCS_CHECK_PTR(expression_ret);
+	_ccs_expression_parser_t parser;
+	ccs_expression_t         expression;
+	parser.context = context;
+	parser.cur = expression_string;
+	CCS_VALIDATE(_ccs_parser_parse_expression(&parser, 0, &expression));
+	_ccs_parser_skip_spaces(&parser);
+	if (*parser.cur) {
+		ccs_release_object(expression);
+		return -CCS_INVALID_VALUE;
+	}
+	*expression_ret = expression;
+	return CCS_SUCCESS;
+}
@@ -266,6 +266,45 @@ _ccs_categorical_hyperparameter_get_values(ccs_hyperparameter_t  hyperparameter,
 	return CCS_SUCCESS;
 }
 
+size_t
+_ccs_categorical_hyperparameter_get_num_values(
+		ccs_hyperparameter_t hyperparameter) {
+	return ((_ccs_hyperparameter_categorical_data_t *)
+		hyperparameter->data)->num_possible_values;
+}
+
+ccs_datum_t
+_ccs_categorical_hyperparameter_get_value(ccs_hyperparameter_t hyperparameter,
+                                          size_t               rank) {
+	return ((_ccs_hyperparameter_categorical_data_t *)
+		hyperparameter->data)->possible_values[rank].d;
+}
+
+// Sampled values are copies of the possible values, so small sets are first
+// scanned for an identical datum, which avoids hashing strings.
+#define CCS_CATEGORICAL_SCAN_MAX 16
+
+ccs_result_t
+_ccs_categorical_hyperparameter_get_rank(ccs_hyperparameter_t  hyperparameter,
+                                         const ccs_datum_t    *value,
+                                         size_t               *rank_ret) {
+	_ccs_hyperparameter_categorical_data_t *d =
+		(_ccs_hyperparameter_categorical_data_t *)hyperparameter->data;
+	_ccs_hash_datum_t *p;
+	if (d->num_possible_values <= CCS_CATEGORICAL_SCAN_MAX)
+		for (size_t i = 0; i < d->num_possible_values; i++)
+			if (d->possible_values[i].d.type == value->type &&
+			    d->possible_values[i].d.value.i == value->value.i) {
+				*rank_ret = i;
+				return CCS_SUCCESS;
+			}
+	HASH_FIND(hh, d->hash, value, sizeof(ccs_datum_t), p);
+	if (!p)
+		return -CCS_INVALID_VALUE;
+	*rank_ret = p - d->possible_values;
+	return CCS_SUCCESS;
+}
+
 ccs_result_t
 ccs_create_categorical_hyperparameter(const char           *name,
                                       size_t                num_possible_values,
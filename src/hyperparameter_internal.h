@@ -54,4 +54,20 @@ struct _ccs_hyperparameter_common_data_s {
 };
 
 typedef struct _ccs_hyperparameter_common_data_s _ccs_hyperparameter_common_data_t;
+
+// Categorical, ordinal and discrete hyperparameters share an implementation
+// where possible values are identified by their rank.
+extern size_t
+_ccs_categorical_hyperparameter_get_num_values(
+	ccs_hyperparameter_t hyperparameter);
+
+extern ccs_datum_t
+_ccs_categorical_hyperparameter_get_value(ccs_hyperparameter_t hyperparameter,
+                                          size_t               rank);
+
+// Returns -CCS_INVALID_VALUE if value is not a possible value.
+extern ccs_result_t
+_ccs_categorical_hyperparameter_get_rank(ccs_hyperparameter_t  hyperparameter,
+                                         const ccs_datum_t    *value,
+                                         size_t               *rank_ret);
 #endif //_HYPERPARAMETER_INTERNAL_H
@@ -302,7 +302,7 @@ ccs_objective_space_add_objective(ccs_objective_space_t objective_space,
                                   ccs_expression_t      expression,
                                   ccs_objective_type_t  type) {
 	CCS_CHECK_OBJ(objective_space, CCS_OBJECTIVE_SPACE);
-	CCS_VALIDATE(ccs_expression_check_context(
+	CCS_VALIDATE(ccs_expression_compile(
 	  expression, (ccs_context_t)objective_space));
 	CCS_VALIDATE(ccs_retain_object(expression));
 	_ccs_objective_t objective;
@@ -321,7 +321,7 @@ ccs_objective_space_add_objectives(ccs_objective_space_t  objective_space,
 	CCS_CHECK_ARY(num_objectives, expressions);
 	CCS_CHECK_ARY(num_objectives, types);
 	for (size_t i = 0; i < num_objectives; i++) {
-		CCS_VALIDATE(ccs_expression_check_context(
+		CCS_VALIDATE(ccs_expression_compile(
 		  expressions[i], (ccs_context_t)objective_space));
 		CCS_VALIDATE(ccs_retain_object(expressions[i]));
 		_ccs_objective_t objective;
@@ -1,6 +1,7 @@
 #include "cconfigspace_internal.h"
 #include "rng_internal.h"
 #include <stdlib.h>
+#include <string.h>
 
 static ccs_result_t
 _ccs_rng_del(ccs_object_t object);
@@ -60,6 +61,53 @@ ccs_rng_set_seed(ccs_rng_t         rng,
 	return CCS_SUCCESS;
 }
 
+ccs_result_t
+ccs_rng_get_state(ccs_rng_t  rng,
+                  size_t     state_size,
+                  void      *state,
+                  size_t    *state_size_ret) {
+	CCS_CHECK_OBJ(rng, CCS_RNG);
+	CCS_CHECK_ARY(state_size, state);
+	if (!state && !state_size_ret)
+		return -CCS_INVALID_VALUE;
+	gsl_rng *grng = rng->data->rng;
+	size_t name_size = strlen(rng->data->rng_type->name) + 1;
+	size_t size = name_size + gsl_rng_size(grng);
+	if (state) {
+		if (state_size < size)
+			return -CCS_INVALID_VALUE;
+		memcpy(state, rng->data->rng_type->name, name_size);
+		memcpy((char *)state + name_size, gsl_rng_state(grng),
+		       gsl_rng_size(grng));
+	}
+	if (state_size_ret)
+		*state_size_ret = size;
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_rng_set_state(ccs_rng_t   rng,
+                  size_t      state_size,
+                  const void *state) {
+	CCS_CHECK_OBJ(rng, CCS_RNG);
+	CCS_CHECK_PTR(state);
+	gsl_rng *grng = rng->data->rng;
+	size_t name_size = strlen(rng->data->rng_type->name) + 1;
+	if (state_size != name_size + gsl_rng_size(grng) ||
+	    memcmp(state, rng->data->rng_type->name, name_size))
+		return -CCS_INVALID_VALUE;
+	if (rng->data->rng_type == ccs_rng_philox4x32_10) {
+		_ccs_philox_state_t philox_state;
+		memcpy(&philox_state, (const char *)state + name_size,
+		       sizeof(philox_state));
+		if (philox_state.index > 4)
+			return -CCS_INVALID_VALUE;
+	}
+	memcpy(gsl_rng_state(grng), (const char *)state + name_size,
+	       gsl_rng_size(grng));
+	return CCS_SUCCESS;
+}
+
 ccs_result_t
 ccs_rng_get(ccs_rng_t          rng,
             unsigned long int *value_ret) {
@@ -78,6 +126,61 @@ ccs_rng_uniform(ccs_rng_t    rng,
 	return CCS_SUCCESS;
 }
 
+ccs_result_t
+ccs_rng_uniform_fill(ccs_rng_t    rng,
+                     size_t       num_values,
+                     ccs_float_t *values) {
+	CCS_CHECK_OBJ(rng, CCS_RNG);
+	CCS_CHECK_ARY(num_values, values);
+	gsl_rng *grng = rng->data->rng;
+	if (rng->data->rng_type == ccs_rng_philox4x32_10)
+		_ccs_philox_uniform_fill((_ccs_philox_state_t *)grng->state,
+		                         num_values, values);
+	else
+		for (size_t i = 0; i < num_values; i++)
+			values[i] = gsl_rng_uniform(grng);
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_rng_jump(ccs_rng_t rng,
+             uint64_t  num_values) {
+	CCS_CHECK_OBJ(rng, CCS_RNG);
+	gsl_rng *grng = rng->data->rng;
+	if (rng->data->rng_type == ccs_rng_philox4x32_10)
+		_ccs_philox_jump((_ccs_philox_state_t *)grng->state, num_values);
+	else
+		for (uint64_t i = 0; i < num_values; i++)
+			gsl_rng_get(grng);
+	return CCS_SUCCESS;
+}
+
+ccs_result_t
+ccs_rng_split(ccs_rng_t  rng,
+              size_t     num_children,
+              ccs_rng_t *children) {
+	CCS_CHECK_OBJ(rng, CCS_RNG);
+	CCS_CHECK_ARY(num_children, children);
+	ccs_result_t err;
+	gsl_rng *grng = rng->data->rng;
+	uint64_t seed = gsl_rng_get(grng);
+	seed = (seed << 32) ^ gsl_rng_get(grng);
+	size_t i;
+	for (i = 0; i < num_children; i++) {
+		CCS_VALIDATE_ERR_GOTO(err, ccs_rng_create_with_type(
+			rng->data->rng_type, children + i), errrngs);
+		gsl_rng_set(children[i]->data->rng,
+		            _ccs_rng_derive_seed((unsigned long int)seed, i));
+	}
+	return CCS_SUCCESS;
+errrngs:
+	for (size_t j = 0; j < i; j++) {
+		ccs_release_object(children[j]);
+		children[j] = NULL;
+	}
+	return err;
+}
+
 ccs_result_t
 ccs_rng_get_gsl_rng(ccs_rng_t   rng,
                     gsl_rng   **gsl_rng_ret) {
@@ -10,6 +10,35 @@ struct _ccs_rng_data_s {
 
 typedef struct _ccs_rng_data_s _ccs_rng_data_t;
 
+// State of the Philox4x32-10 generator: a 128 bits counter, a 64 bits key,
+// and the last generated block, from which index words have been consumed.
+struct _ccs_philox_state_s {
+	uint32_t counter[4];
+	uint32_t key[2];
+	uint32_t output[4];
+	uint32_t index;
+};
+typedef struct _ccs_philox_state_s _ccs_philox_state_t;
+
+void
+_ccs_philox_uniform_fill(_ccs_philox_state_t *state,
+                         size_t               num_values,
+                         ccs_float_t         *values);
+
+void
+_ccs_philox_jump(_ccs_philox_state_t *state,
+                 uint64_t             num_values);
+
+// splitmix64 finalizer, used to derive decorrelated seeds from a seed: the
+// seeds derived for distinct indexes are distinct.
+static inline unsigned long int
+_ccs_rng_derive_seed(unsigned long int seed, uint64_t index) {
+	uint64_t z = (uint64_t)seed + (index + 1) * UINT64_C(0x9e3779b97f4a7c15);
+	z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+	z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+	return (unsigned long int)(z ^ (z >> 31));
+}
+
 struct _ccs_rng_ops_s {
 	_ccs_object_ops_t obj_ops;
 };
@@ -0,0 +1,156 @@
+#include "cconfigspace_internal.h"
+#include "rng_internal.h"
+#include <string.h>
+
+// Philox4x32-10 counter based generator, from Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3", SC'11. Each counter value is encrypted into a
+// block of 4 independent 32 bits words.
+#define PHILOX_M0 UINT32_C(0xD2511F53)
+#define PHILOX_M1 UINT32_C(0xCD9E8D57)
+#define PHILOX_W0 UINT32_C(0x9E3779B9)
+#define PHILOX_W1 UINT32_C(0xBB67AE85)
+#define PHILOX_ROUNDS 10
+// Number of blocks generated together, lane by lane, so that the rounds can
+// be vectorized by the compiler.
+#define PHILOX_LANES 16
+#define PHILOX_TO_FLOAT (1.0 / 4294967296.0)
+
+static inline void
+_philox_increment(uint32_t counter[4]) {
+	if (++counter[0]) return;
+	if (++counter[1]) return;
+	if (++counter[2]) return;
+	++counter[3];
+}
+
+static inline void
+_philox_add(uint32_t counter[4], uint64_t n) {
+	uint64_t sum = (uint64_t)counter[0] + (uint32_t)n;
+	counter[0] = (uint32_t)sum;
+	sum = (uint64_t)counter[1] + (n >> 32) + (sum >> 32);
+	counter[1] = (uint32_t)sum;
+	if (sum >> 32)
+		if (++counter[2] == 0)
+			++counter[3];
+}
+
+// Generates num_blocks (at most PHILOX_LANES) consecutive blocks starting at
+// the state counter, and advances the counter past them. Words of block l are
+// stored in out[4*l] to out[4*l+3].
+static inline void
+_philox_blocks(_ccs_philox_state_t *state,
+               size_t               num_blocks,
+               uint32_t            *out) {
+	uint32_t c0[PHILOX_LANES], c1[PHILOX_LANES];
+	uint32_t c2[PHILOX_LANES], c3[PHILOX_LANES];
+	uint32_t k0 = state->key[0];
+	uint32_t k1 = state->key[1];
+	for (size_t l = 0; l < num_blocks; l++) {
+		c0[l] = state->counter[0];
+		c1[l] = state->counter[1];
+		c2[l] = state->counter[2];
+		c3[l] = state->counter[3];
+		_philox_increment(state->counter);
+	}
+	for (int r = 0; r < PHILOX_ROUNDS; r++) {
+		for (size_t l = 0; l < num_blocks; l++) {
+			uint64_t p0 = (uint64_t)PHILOX_M0 * c0[l];
+			uint64_t p1 = (uint64_t)PHILOX_M1 * c2[l];
+			uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1[l] ^ k0;
+			uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3[l] ^ k1;
+			c1[l] = (uint32_t)p1;
+			c3[l] = (uint32_t)p0;
+			c0[l] = n0;
+			c2[l] = n2;
+		}
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+	for (size_t l = 0; l < num_blocks; l++) {
+		out[4*l]     = c0[l];
+		out[4*l + 1] = c1[l];
+		out[4*l + 2] = c2[l];
+		out[4*l + 3] = c3[l];
+	}
+}
+
+static void
+_philox_set(void *vstate, unsigned long int seed) {
+	_ccs_philox_state_t *state = (_ccs_philox_state_t *)vstate;
+	memset(state->counter, 0, sizeof(state->counter));
+	state->key[0] = (uint32_t)seed;
+	state->key[1] = (uint32_t)((uint64_t)seed >> 32);
+	state->index = 4;
+}
+
+static unsigned long int
+_philox_get(void *vstate) {
+	_ccs_philox_state_t *state = (_ccs_philox_state_t *)vstate;
+	if (state->index == 4) {
+		_philox_blocks(state, 1, state->output);
+		state->index = 0;
+	}
+	return state->output[state->index++];
+}
+
+static double
+_philox_get_double(void *vstate) {
+	return _philox_get(vstate) * PHILOX_TO_FLOAT;
+}
+
+// Produces the same values as successive calls to _philox_get_double.
+void
+_ccs_philox_uniform_fill(_ccs_philox_state_t *state,
+                         size_t               num_values,
+                         ccs_float_t         *values) {
+	uint32_t words[4 * PHILOX_LANES];
+	while (num_values && state->index < 4) {
+		*values++ = state->output[state->index++] * PHILOX_TO_FLOAT;
+		num_values--;
+	}
+	while (num_values >= 4) {
+		size_t num_blocks = num_values / 4;
+		if (num_blocks > PHILOX_LANES)
+			num_blocks = PHILOX_LANES;
+		_philox_blocks(state, num_blocks, words);
+		for (size_t i = 0; i < 4 * num_blocks; i++)
+			values[i] = words[i] * PHILOX_TO_FLOAT;
+		values += 4 * num_blocks;
+		num_values -= 4 * num_blocks;
+	}
+	if (num_values) {
+		_philox_blocks(state, 1, state->output);
+		state->index = 0;
+		while (num_values--)
+			*values++ = state->output[state->index++] * PHILOX_TO_FLOAT;
+	}
+}
+
+// The next word returned is word index of the block preceding the counter, so
+// jumping num_values words ahead moves to word (index + num_values) % 4 of the
+// block (index + num_values) / 4 - 1 positions after the counter.
+void
+_ccs_philox_jump(_ccs_philox_state_t *state,
+                 uint64_t             num_values) {
+	uint64_t index = state->index + (num_values % 4);
+	uint64_t num_blocks = num_values / 4 + index / 4;
+	if (!num_blocks) {
+		state->index = (uint32_t)index;
+		return;
+	}
+	_philox_add(state->counter, num_blocks - 1);
+	_philox_blocks(state, 1, state->output);
+	state->index = (uint32_t)(index % 4);
+}
+
+static const gsl_rng_type _philox4x32_10_type = {
+	"philox4x32_10",
+	UINT32_MAX,
+	0,
+	sizeof(_ccs_philox_state_t),
+	&_philox_set,
+	&_philox_get,
+	&_philox_get_double
+};
+
+const gsl_rng_type *ccs_rng_philox4x32_10 = &_philox4x32_10_type;
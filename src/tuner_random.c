@@ -54,8 +54,18 @@ _ccs_tuner_random_tell(_ccs_tuner_data_t *data,
 	_ccs_random_tuner_data_t *d = (_ccs_random_tuner_data_t *)data;
 	UT_array *history = d->history;
 	ccs_result_t err;
+	ccs_bool_t unique;
+	CCS_VALIDATE(ccs_configuration_space_get_unique_sampling(
+	    d->common_data.configuration_space, &unique));
 	for (size_t i = 0; i < num_evaluations; i++) {
 		ccs_result_t error;
+		if (unique) {
+			ccs_configuration_t configuration;
+			CCS_VALIDATE(ccs_evaluation_get_configuration(evaluations[i],
+			                                              &configuration));
+			CCS_VALIDATE(ccs_configuration_space_exclude_configurations(
+			    d->common_data.configuration_space, 1, &configuration));
+		}
 		CCS_VALIDATE(ccs_evaluation_get_error(evaluations[i], &error));
 		if (!error) {
 			int discard = 0;
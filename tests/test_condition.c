@@ -197,10 +197,289 @@ test_transitive() {
 	assert( err == CCS_SUCCESS );
 }
 
+void
+test_reorder() {
+	ccs_hyperparameter_t      hyperparameters[5];
+	ccs_configuration_space_t space;
+	ccs_expression_t          expression;
+	ccs_configuration_t       configurations[100];
+	ccs_datum_t               values[5];
+	ccs_result_t              err;
+	// Each condition refers to a hyperparameter added later, so every
+	// condition requires the order of the hyperparameters to be updated.
+	size_t                    children[3] = { 0, 1, 3 };
+	size_t                    parents[3] = { 1, 3, 4 };
+
+	hyperparameters[0] = create_numerical("param1");
+	hyperparameters[1] = create_numerical("param2");
+	hyperparameters[2] = create_numerical("param3");
+	hyperparameters[3] = create_numerical("param4");
+	hyperparameters[4] = create_numerical("param5");
+
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_add_hyperparameters(space, 5, hyperparameters,
+	                                                  NULL);
+	assert( err == CCS_SUCCESS );
+
+	for (int i = 0; i < 3; i++) {
+		err = ccs_create_binary_expression(CCS_LESS,
+		                                   ccs_object(hyperparameters[parents[i]]),
+		                                   ccs_float(0.5), &expression);
+		assert( err == CCS_SUCCESS );
+		err = ccs_configuration_space_set_condition(space, children[i], expression);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(expression);
+		assert( err == CCS_SUCCESS );
+	}
+
+	err = ccs_create_binary_expression(CCS_LESS, ccs_object(hyperparameters[0]),
+	                                   ccs_float(0.5), &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_condition(space, 4, expression);
+	assert( err == -CCS_INVALID_GRAPH );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_create_binary_expression(CCS_LESS, ccs_object(hyperparameters[2]),
+	                                   ccs_float(0.5), &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_condition(space, 2, expression);
+	assert( err == -CCS_INVALID_GRAPH );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_get_condition(space, 4, &expression);
+	assert( err == CCS_SUCCESS );
+	assert( expression == NULL );
+
+	err = ccs_configuration_space_samples(space, 100, configurations);
+	assert( err == CCS_SUCCESS );
+
+	for (int i = 0; i < 100; i ++) {
+		ccs_bool_t active = CCS_TRUE;
+		err = ccs_configuration_get_values(configurations[i], 5, values, NULL);
+		assert( err == CCS_SUCCESS );
+		assert( values[2].type == CCS_FLOAT );
+		assert( values[4].type == CCS_FLOAT );
+		for (int j = 2; j >= 0; j--) {
+			active = active && values[parents[j]].value.f < 0.5;
+			if (active)
+				assert( values[children[j]].type == CCS_FLOAT );
+			else
+				assert( values[children[j]].type == CCS_INACTIVE );
+		}
+		err = ccs_configuration_space_check_configuration(space, configurations[i]);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+
+	for (int i =0; i < 5; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
+
+void
+test_categorical() {
+	ccs_hyperparameter_t      hyperparameters[3];
+	ccs_configuration_space_t space;
+	ccs_expression_t          conditions[2];
+	ccs_datum_t               possible_values[3];
+	ccs_datum_t               values[3], result;
+	ccs_configuration_t       configurations[1000];
+	ccs_result_t              err;
+
+	possible_values[0] = ccs_string("a");
+	possible_values[1] = ccs_string("b");
+	possible_values[2] = ccs_string("c");
+	err = ccs_create_categorical_hyperparameter("parent", 3, possible_values,
+	                                            0, NULL, hyperparameters);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_categorical_hyperparameter("child1", 3, possible_values,
+	                                            0, NULL, hyperparameters + 1);
+	assert( err == CCS_SUCCESS );
+	hyperparameters[2] = create_numerical("child2");
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameters(space, 3, hyperparameters, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_parse((ccs_context_t)space,
+	                           "parent == 'a' || parent # ['c']", conditions);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_condition(space, 1, conditions[0]);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_parse((ccs_context_t)space,
+	                           "child1 != 'b' && parent != 'c'", conditions + 1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_condition(space, 2, conditions[1]);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_samples(space, 1000, configurations);
+	assert( err == CCS_SUCCESS );
+	for (int i = 0; i < 1000; i++) {
+		err = ccs_configuration_get_values(configurations[i], 3, values, NULL);
+		assert( err == CCS_SUCCESS );
+		for (int j = 0; j < 2; j++) {
+			err = ccs_expression_eval(conditions[j], (ccs_context_t)space,
+			                          values, &result);
+			if (err == CCS_SUCCESS && result.type == CCS_BOOLEAN &&
+			    result.value.i == CCS_TRUE)
+				assert( values[j + 1].type != CCS_INACTIVE );
+			else
+				assert( values[j + 1].type == CCS_INACTIVE );
+		}
+		err = ccs_configuration_space_check_configuration(space, configurations[i]);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+
+	values[0] = ccs_string("b");
+	values[1] = ccs_string("a");
+	values[2] = ccs_inactive;
+	err = ccs_configuration_space_check_configuration_values(space, 3, values);
+	assert( err == -CCS_INVALID_CONFIGURATION );
+	values[1] = ccs_inactive;
+	err = ccs_configuration_space_check_configuration_values(space, 3, values);
+	assert( err == CCS_SUCCESS );
+	values[0] = ccs_string("a");
+	values[1] = ccs_string("c");
+	err = ccs_configuration_space_check_configuration_values(space, 3, values);
+	assert( err == -CCS_INVALID_CONFIGURATION );
+	values[2] = ccs_float(0.5);
+	err = ccs_configuration_space_check_configuration_values(space, 3, values);
+	assert( err == CCS_SUCCESS );
+
+	for (int i = 0; i < 2; i++) {
+		err = ccs_release_object(conditions[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	for (int i = 0; i < 3; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
+
+void
+test_lazy() {
+	ccs_hyperparameter_t      hyperparameters[4];
+	ccs_configuration_space_t space;
+	ccs_distribution_t        distributions[2], distribution;
+	ccs_expression_t          expression;
+	ccs_datum_t               values[4];
+	ccs_configuration_t       configurations[1000];
+	size_t                    indexes[2];
+	ccs_bool_t                lazy;
+	ccs_result_t              err;
+	const char               *conditions[3] = {
+		"param1 > 0.0", "param2 > 0.5", "param1 < 0.0" };
+
+	hyperparameters[0] = create_numerical("param1");
+	hyperparameters[1] = create_numerical("param2");
+	hyperparameters[2] = create_numerical("param3");
+	hyperparameters[3] = create_numerical("param4");
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameters(space, 4, hyperparameters, NULL);
+	assert( err == CCS_SUCCESS );
+	for (int i = 0; i < 3; i++) {
+		err = ccs_expression_parse((ccs_context_t)space, conditions[i],
+		                           &expression);
+		assert( err == CCS_SUCCESS );
+		err = ccs_configuration_space_set_condition(space, i + 1, expression);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(expression);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_expression_parse((ccs_context_t)space, "param3 < -0.5", &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_forbidden_clause(space, expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+	for (int i = 0; i < 2; i++) {
+		err = ccs_create_uniform_distribution(CCS_NUM_FLOAT, CCSF(-1.0),
+		                                      CCSF(1.0), CCS_LINEAR, CCSF(0.0),
+		                                      distributions + i);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_create_multivariate_distribution(2, distributions, &distribution);
+	assert( err == CCS_SUCCESS );
+	indexes[0] = 0;
+	indexes[1] = 3;
+	err = ccs_configuration_space_set_distribution(space, distribution, indexes);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_get_lazy_sampling(space, &lazy);
+	assert( err == CCS_SUCCESS );
+	assert( lazy == CCS_FALSE );
+	err = ccs_configuration_space_set_lazy_sampling(space, CCS_TRUE);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_get_lazy_sampling(space, &lazy);
+	assert( err == CCS_SUCCESS );
+	assert( lazy == CCS_TRUE );
+
+	for (int k = 0; k < 2; k++) {
+		if (k == 0) {
+			err = ccs_configuration_space_samples(space, 1000, configurations);
+			assert( err == CCS_SUCCESS );
+		} else
+			for (int i = 0; i < 1000; i++) {
+				err = ccs_configuration_space_sample(space, configurations + i);
+				assert( err == CCS_SUCCESS );
+			}
+		for (int i = 0; i < 1000; i++) {
+			err = ccs_configuration_get_values(configurations[i], 4, values, NULL);
+			assert( err == CCS_SUCCESS );
+			assert( values[0].type == CCS_FLOAT );
+			if (values[0].value.f > 0.0) {
+				assert( values[1].type == CCS_FLOAT );
+				assert( values[3].type == CCS_INACTIVE );
+				if (values[1].value.f > 0.5) {
+					assert( values[2].type == CCS_FLOAT );
+					assert( values[2].value.f >= -0.5 );
+				} else
+					assert( values[2].type == CCS_INACTIVE );
+			} else {
+				assert( values[1].type == CCS_INACTIVE );
+				assert( values[2].type == CCS_INACTIVE );
+				assert( (values[3].type == CCS_FLOAT) == (values[0].value.f < 0.0) );
+			}
+			err = ccs_configuration_space_check_configuration(space, configurations[i]);
+			assert( err == CCS_SUCCESS );
+			err = ccs_release_object(configurations[i]);
+			assert( err == CCS_SUCCESS );
+		}
+	}
+
+	for (int i = 0; i < 2; i++) {
+		err = ccs_release_object(distributions[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(distribution);
+	assert( err == CCS_SUCCESS );
+	for (int i = 0; i < 4; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
+
 int main() {
 	ccs_init();
 	test_simple();
 	test_transitive();
+	test_reorder();
+	test_categorical();
+	test_lazy();
 	ccs_fini();
 	return 0;
 }
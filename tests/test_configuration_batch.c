@@ -0,0 +1,236 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <cconfigspace.h>
+
+#define NUM_CONFIGURATIONS 100
+
+ccs_configuration_space_t create_configuration_space(
+		ccs_hyperparameter_t *hyperparameters) {
+	ccs_configuration_space_t configuration_space;
+	ccs_datum_t               possible_values[3];
+	ccs_expression_t          expression;
+	ccs_result_t              err;
+
+	err = ccs_create_configuration_space("my_config_space", NULL,
+	                                     &configuration_space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_numerical_hyperparameter("param1", CCS_NUM_FLOAT,
+	                                          CCSF(-5.0), CCSF(5.0),
+	                                          CCSF(0.0), CCSF(0.0),
+	                                          NULL, hyperparameters);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_numerical_hyperparameter("param2", CCS_NUM_INTEGER,
+	                                          CCSI(0), CCSI(10),
+	                                          CCSI(0), CCSI(0),
+	                                          NULL, hyperparameters+1);
+	assert( err == CCS_SUCCESS );
+	possible_values[0] = ccs_int(1);
+	possible_values[1] = ccs_float(2.0);
+	possible_values[2] = ccs_string("3");
+	err = ccs_create_categorical_hyperparameter("param3", 3, possible_values,
+	                                            0, NULL, hyperparameters+2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameters(configuration_space, 3,
+	                                                  hyperparameters, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_parse((ccs_context_t)configuration_space,
+	                           "param2 < 5", &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_condition(configuration_space, 0,
+	                                            expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+	return configuration_space;
+}
+
+void test_create() {
+	ccs_hyperparameter_t      hyperparameters[3];
+	ccs_configuration_t       configurations[NUM_CONFIGURATIONS];
+	ccs_configuration_t       configurations2[NUM_CONFIGURATIONS + 1];
+	ccs_configuration_space_t configuration_space, configuration_space_ret;
+	ccs_configuration_batch_t configuration_batch;
+	ccs_numeric_type_t        data_type;
+	ccs_numeric_t            *values;
+	uint64_t                 *actives;
+	size_t                    num_configurations;
+	void                     *user_data;
+	ccs_result_t              err;
+
+	configuration_space = create_configuration_space(hyperparameters);
+	err = ccs_configuration_space_samples(configuration_space,
+	                                      NUM_CONFIGURATIONS, configurations);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_configuration_batch(configuration_space,
+	                                     NUM_CONFIGURATIONS, configurations,
+	                                     (void *)0xdeadbeef,
+	                                     &configuration_batch);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_batch_get_configuration_space(configuration_batch,
+	                                                      &configuration_space_ret);
+	assert( err == CCS_SUCCESS );
+	assert( configuration_space_ret == configuration_space );
+	err = ccs_configuration_batch_get_user_data(configuration_batch,
+	                                            &user_data);
+	assert( err == CCS_SUCCESS );
+	assert( user_data == (void *)0xdeadbeef );
+	err = ccs_configuration_batch_get_num_configurations(configuration_batch,
+	                                                     &num_configurations);
+	assert( err == CCS_SUCCESS );
+	assert( num_configurations == NUM_CONFIGURATIONS );
+
+	for (size_t j = 0; j < 3; j++) {
+		err = ccs_configuration_batch_get_column(configuration_batch, j,
+		                                         &data_type, &values,
+		                                         &actives);
+		assert( err == CCS_SUCCESS );
+		assert( data_type == (j == 0 ? CCS_NUM_FLOAT : CCS_NUM_INTEGER) );
+		for (size_t i = 0; i < NUM_CONFIGURATIONS; i++) {
+			ccs_datum_t value, expected;
+			int active = (actives[i / 64] >> (i % 64)) & 1;
+			err = ccs_configuration_get_value(configurations[i], j, &value);
+			assert( err == CCS_SUCCESS );
+			assert( active == (value.type != CCS_INACTIVE) );
+			if (!active) {
+				assert( j == 0 && isnan(values[i].f) );
+				continue;
+			}
+			if (j == 0)
+				assert( value.value.f == values[i].f );
+			else if (j == 1)
+				assert( value.value.i == values[i].i );
+			else {
+				ccs_datum_t possible_values[3];
+				err = ccs_categorical_hyperparameter_get_values(
+					hyperparameters[2], 3, possible_values, NULL);
+				assert( err == CCS_SUCCESS );
+				assert( values[i].i >= 0 && values[i].i < 3 );
+				expected = possible_values[values[i].i];
+				assert( expected.type == value.type );
+				assert( expected.value.i == value.value.i );
+			}
+		}
+	}
+	err = ccs_configuration_batch_get_column(configuration_batch, 3,
+	                                         &data_type, &values, &actives);
+	assert( err == -CCS_OUT_OF_BOUNDS );
+
+	err = ccs_configuration_batch_get_configurations(configuration_batch, 0,
+	                                                 NULL, &num_configurations);
+	assert( err == CCS_SUCCESS );
+	assert( num_configurations == NUM_CONFIGURATIONS );
+	err = ccs_configuration_batch_get_configurations(configuration_batch,
+	                                                 NUM_CONFIGURATIONS - 1,
+	                                                 configurations2, NULL);
+	assert( err == -CCS_INVALID_VALUE );
+	err = ccs_configuration_batch_get_configurations(configuration_batch,
+	                                                 NUM_CONFIGURATIONS + 1,
+	                                                 configurations2, NULL);
+	assert( err == CCS_SUCCESS );
+	assert( configurations2[NUM_CONFIGURATIONS] == NULL );
+	for (size_t i = 0; i < NUM_CONFIGURATIONS; i++) {
+		int cmp;
+		err = ccs_configuration_cmp(configurations[i], configurations2[i],
+		                            &cmp);
+		assert( err == CCS_SUCCESS );
+		assert( cmp == 0 );
+		err = ccs_release_object(configurations2[i]);
+		assert( err == CCS_SUCCESS );
+	}
+
+	// Modified columns are reflected in the configurations
+	err = ccs_configuration_batch_get_column(configuration_batch, 2,
+	                                         NULL, &values, NULL);
+	assert( err == CCS_SUCCESS );
+	values[0].i = 3;
+	err = ccs_configuration_batch_get_configurations(configuration_batch,
+	                                                 NUM_CONFIGURATIONS,
+	                                                 configurations2, NULL);
+	assert( err == -CCS_INVALID_CONFIGURATION );
+	values[0].i = 2;
+	err = ccs_configuration_batch_get_configurations(configuration_batch,
+	                                                 NUM_CONFIGURATIONS,
+	                                                 configurations2, NULL);
+	assert( err == CCS_SUCCESS );
+	{
+		ccs_datum_t value;
+		err = ccs_configuration_get_value(configurations2[0], 2, &value);
+		assert( err == CCS_SUCCESS );
+		assert( value.type == CCS_STRING );
+	}
+	for (size_t i = 0; i < NUM_CONFIGURATIONS; i++) {
+		err = ccs_release_object(configurations2[i]);
+		assert( err == CCS_SUCCESS );
+	}
+
+	err = ccs_release_object(configuration_batch);
+	assert( err == CCS_SUCCESS );
+	for (size_t i = 0; i < NUM_CONFIGURATIONS; i++) {
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	for (size_t i = 0; i < 3; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(configuration_space);
+	assert( err == CCS_SUCCESS );
+}
+
+void test_errors() {
+	ccs_hyperparameter_t      hyperparameters[3];
+	ccs_hyperparameter_t      hyperparameters2[3];
+	ccs_configuration_t       configuration;
+	ccs_configuration_space_t configuration_space, configuration_space2;
+	ccs_configuration_batch_t configuration_batch;
+	ccs_result_t              err;
+
+	configuration_space = create_configuration_space(hyperparameters);
+	configuration_space2 = create_configuration_space(hyperparameters2);
+	err = ccs_configuration_space_sample(configuration_space2, &configuration);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_configuration_batch(configuration_space, 1,
+	                                     &configuration, NULL,
+	                                     &configuration_batch);
+	assert( err == -CCS_INVALID_CONFIGURATION );
+	err = ccs_release_object(configuration);
+	assert( err == CCS_SUCCESS );
+
+	// Unset values are not possible values
+	err = ccs_create_configuration(configuration_space, 0, NULL, NULL,
+	                               &configuration);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_configuration_batch(configuration_space, 1,
+	                                     &configuration, NULL,
+	                                     &configuration_batch);
+	assert( err == -CCS_INVALID_CONFIGURATION );
+	err = ccs_release_object(configuration);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_create_configuration_batch(configuration_space, 0, NULL, NULL,
+	                                     &configuration_batch);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(configuration_batch);
+	assert( err == CCS_SUCCESS );
+
+	for (size_t i = 0; i < 3; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(hyperparameters2[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(configuration_space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(configuration_space2);
+	assert( err == CCS_SUCCESS );
+}
+
+int main() {
+	ccs_init();
+	test_create();
+	test_errors();
+	ccs_fini();
+	return 0;
+}
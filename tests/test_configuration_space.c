@@ -2,6 +2,7 @@
 #include <assert.h>
 #include <cconfigspace.h>
 #include <string.h>
+#include <gsl/gsl_cdf.h>
 
 double d = -2.0;
 
@@ -222,6 +223,24 @@ void test_sample() {
 		assert( err == CCS_SUCCESS );
 	}
 
+	// Large requests are sampled by windows
+	{
+		const size_t         num = 10000;
+		ccs_configuration_t *many = (ccs_configuration_t *)malloc(
+			num * sizeof(ccs_configuration_t));
+		assert( many );
+		err = ccs_configuration_space_samples(configuration_space, num,
+		                                      many);
+		assert( err == CCS_SUCCESS );
+		for (size_t i = 0; i < num; i++) {
+			err = ccs_configuration_check(many[i]);
+			assert( err == CCS_SUCCESS );
+			err = ccs_release_object(many[i]);
+			assert( err == CCS_SUCCESS );
+		}
+		free(many);
+	}
+
 	err = ccs_release_object(configuration);
 	assert( err == CCS_SUCCESS );
 	for (size_t i = 0; i < 4; i++) {
@@ -232,6 +251,139 @@ void test_sample() {
 	assert( err == CCS_SUCCESS );
 }
 
+void test_sample_parallel() {
+	ccs_hyperparameter_t      hyperparameters[4];
+	ccs_configuration_t       configurations1[1000];
+	ccs_configuration_t       configurations2[1000];
+	ccs_configuration_space_t configuration_space;
+	ccs_rng_t                 rng;
+	ccs_result_t              err;
+	int                       cmp;
+
+	err = ccs_create_configuration_space("my_config_space", NULL,
+	                                     &configuration_space);
+	assert( err == CCS_SUCCESS );
+
+	hyperparameters[0] = create_dummy_hyperparameter("param1");
+	hyperparameters[1] = create_dummy_hyperparameter("param2");
+	hyperparameters[2] = create_dummy_hyperparameter("param3");
+	err = ccs_create_numerical_hyperparameter("param4", CCS_NUM_INTEGER,
+	                                          CCSI(-5), CCSI(5),
+	                                          CCSI(0), CCSI(0),
+	                                          NULL, hyperparameters+3);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_add_hyperparameters(configuration_space, 4,
+	                                                  hyperparameters, NULL);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_get_rng(configuration_space, &rng);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_rng_set_seed(rng, 1234);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_samples_parallel(configuration_space, 1,
+	                                               1000, configurations1);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_rng_set_seed(rng, 1234);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_samples_parallel(configuration_space, 4,
+	                                               1000, configurations2);
+	assert( err == CCS_SUCCESS );
+
+	for (size_t i = 0; i < 1000; i++) {
+		err = ccs_configuration_check(configurations1[i]);
+		assert( err == CCS_SUCCESS );
+		err = ccs_configuration_cmp(configurations1[i], configurations2[i], &cmp);
+		assert( err == CCS_SUCCESS );
+		assert( cmp == 0 );
+		err = ccs_release_object(configurations1[i]);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(configurations2[i]);
+		assert( err == CCS_SUCCESS );
+	}
+
+	for (size_t i = 0; i < 4; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(configuration_space);
+	assert( err == CCS_SUCCESS );
+}
+
+void test_create_configurations() {
+	ccs_hyperparameter_t      hyperparameters[2];
+	ccs_configuration_t       configurations[10];
+	ccs_configuration_space_t configuration_space;
+	ccs_datum_t               values[20];
+	ccs_datum_t               value;
+	ccs_result_t              err;
+	int32_t                   refcount;
+
+	err = ccs_create_configuration_space("my_config_space", NULL,
+	                                     &configuration_space);
+	assert( err == CCS_SUCCESS );
+
+	hyperparameters[0] = create_dummy_hyperparameter("param1");
+	hyperparameters[1] = create_dummy_hyperparameter("param2");
+	err = ccs_configuration_space_add_hyperparameters(configuration_space, 2,
+	                                                  hyperparameters, NULL);
+	assert( err == CCS_SUCCESS );
+
+	for (size_t i = 0; i < 20; i++)
+		values[i] = ccs_float(i * 0.1);
+	err = ccs_create_configurations(configuration_space, 10, 3, values,
+	                                NULL, configurations);
+	assert( err == -CCS_INVALID_VALUE );
+	// Sizes that would overflow the allocation
+	err = ccs_create_configurations(configuration_space, SIZE_MAX / 2, 0,
+	                                NULL, NULL, configurations);
+	assert( err == -CCS_OUT_OF_MEMORY );
+	err = ccs_create_configurations(configuration_space, 10, 2, values,
+	                                NULL, configurations);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_object_get_refcount(configuration_space, &refcount);
+	assert( err == CCS_SUCCESS );
+	assert( refcount == 2 );
+
+	for (size_t i = 0; i < 10; i++) {
+		err = ccs_configuration_check(configurations[i]);
+		assert( err == CCS_SUCCESS );
+		err = ccs_configuration_get_value(configurations[i], 1, &value);
+		assert( err == CCS_SUCCESS );
+		assert( value.type == CCS_FLOAT );
+		assert( value.value.f == values[2*i + 1].value.f );
+	}
+
+	err = ccs_retain_object(configurations[3]);
+	assert( err == CCS_SUCCESS );
+	for (size_t i = 0; i < 10; i++) {
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_object_get_refcount(configuration_space, &refcount);
+	assert( err == CCS_SUCCESS );
+	assert( refcount == 2 );
+	err = ccs_configuration_get_value(configurations[3], 0, &value);
+	assert( err == CCS_SUCCESS );
+	assert( value.type == CCS_FLOAT );
+	assert( value.value.f == values[6].value.f );
+	err = ccs_release_object(configurations[3]);
+	assert( err == CCS_SUCCESS );
+	err = ccs_object_get_refcount(configuration_space, &refcount);
+	assert( err == CCS_SUCCESS );
+	assert( refcount == 1 );
+
+	for (size_t i = 0; i < 2; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(configuration_space);
+	assert( err == CCS_SUCCESS );
+}
+
 void test_set_distribution() {
 	ccs_hyperparameter_t      hyperparameters[3];
 	ccs_distribution_t        distribs[2];
@@ -367,13 +519,549 @@ void test_set_distribution() {
 	assert( err == CCS_SUCCESS );
 }
 
+void test_sampling_methods() {
+	ccs_hyperparameter_t      hyperparameters[4];
+	ccs_datum_t               possible_values[4];
+	ccs_distribution_t        distribution;
+	ccs_expression_t          expression;
+	ccs_configuration_t       configuration;
+	ccs_configuration_t       configurations[64];
+	ccs_configuration_space_t configuration_space;
+	ccs_sampling_method_t     method;
+	ccs_result_t              err;
+
+	err = ccs_create_configuration_space("my_config_space", NULL,
+	                                     &configuration_space);
+	assert( err == CCS_SUCCESS );
+
+	hyperparameters[0] = create_dummy_hyperparameter("param1");
+	err = ccs_create_numerical_hyperparameter("param2", CCS_NUM_INTEGER,
+	                                          CCSI(-5), CCSI(5),
+	                                          CCSI(0), CCSI(0),
+	                                          NULL, hyperparameters+1);
+	assert( err == CCS_SUCCESS );
+	possible_values[0] = ccs_int(1);
+	possible_values[1] = ccs_float(2.0);
+	possible_values[2] = ccs_string("3");
+	possible_values[3] = ccs_none;
+	err = ccs_create_categorical_hyperparameter("param3", 4, possible_values,
+	                                            0, NULL, hyperparameters+2);
+	assert( err == CCS_SUCCESS );
+	hyperparameters[3] = create_dummy_hyperparameter("param4");
+	err = ccs_configuration_space_add_hyperparameters(configuration_space, 4,
+	                                                  hyperparameters, NULL);
+	assert( err == CCS_SUCCESS );
+	// Oversampling normal distribution
+	err = ccs_create_normal_float_distribution(0.0, 2.0, CCS_LINEAR, 0.0,
+	                                           &distribution);
+	assert( err == CCS_SUCCESS );
+	size_t index = 3;
+	err = ccs_configuration_space_set_distribution(configuration_space,
+	                                               distribution, &index);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_get_sampling_method(configuration_space,
+	                                                  &method);
+	assert( err == CCS_SUCCESS );
+	assert( method == CCS_SAMPLING_RANDOM );
+	err = ccs_configuration_space_set_sampling_method(configuration_space,
+	                                                  CCS_SAMPLING_METHOD_MAX);
+	assert( err == -CCS_INVALID_VALUE );
+
+	for (int m = CCS_SAMPLING_LATIN_HYPERCUBE; m < CCS_SAMPLING_METHOD_MAX; m++) {
+		err = ccs_configuration_space_set_sampling_method(configuration_space,
+		                                                  (ccs_sampling_method_t)m);
+		assert( err == CCS_SUCCESS );
+		err = ccs_configuration_space_get_sampling_method(configuration_space,
+		                                                  &method);
+		assert( err == CCS_SUCCESS );
+		assert( method == (ccs_sampling_method_t)m );
+		err = ccs_configuration_space_samples(configuration_space,
+		                                      64, configurations);
+		assert( err == CCS_SUCCESS );
+		// Each of the 64 strata of param1 contains a sample. For Latin
+		// hypercube designs, so does each of the 64 strata of the normal
+		// distribution of param4 truncated to its sampling interval
+		int strata[64] = {0};
+		int normal_strata[64] = {0};
+		ccs_float_t pl = gsl_cdf_ugaussian_P(-2.5);
+		ccs_float_t ph = gsl_cdf_ugaussian_P(2.5);
+		for (size_t i = 0; i < 64; i++) {
+			ccs_datum_t value;
+			err = ccs_configuration_check(configurations[i]);
+			assert( err == CCS_SUCCESS );
+			err = ccs_configuration_get_value(configurations[i], 0, &value);
+			assert( err == CCS_SUCCESS );
+			strata[(int)((value.value.f + 5.0) * 6.4)]++;
+			err = ccs_configuration_get_value(configurations[i], 3, &value);
+			assert( err == CCS_SUCCESS );
+			normal_strata[(int)((gsl_cdf_ugaussian_P(value.value.f / 2.0) - pl) /
+			                    (ph - pl) * 64)]++;
+			err = ccs_release_object(configurations[i]);
+			assert( err == CCS_SUCCESS );
+		}
+		for (size_t i = 0; i < 64; i++) {
+			assert( strata[i] == 1 );
+			assert( m != CCS_SAMPLING_LATIN_HYPERCUBE ||
+			        normal_strata[i] == 1 );
+		}
+	}
+
+	err = ccs_expression_parse((ccs_context_t)configuration_space,
+	                           "param1 > 4.0 && param3 == 1", &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_forbidden_clause(configuration_space,
+	                                                   expression);
+	assert( err == CCS_SUCCESS );
+	for (int m = CCS_SAMPLING_LATIN_HYPERCUBE; m < CCS_SAMPLING_METHOD_MAX; m++) {
+		err = ccs_configuration_space_set_sampling_method(configuration_space,
+		                                                  (ccs_sampling_method_t)m);
+		assert( err == CCS_SUCCESS );
+		err = ccs_configuration_space_sample(configuration_space,
+		                                     &configuration);
+		assert( err == CCS_SUCCESS );
+		err = ccs_configuration_check(configuration);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(configuration);
+		assert( err == CCS_SUCCESS );
+		err = ccs_configuration_space_samples(configuration_space,
+		                                      64, configurations);
+		assert( err == CCS_SUCCESS );
+		for (size_t i = 0; i < 64; i++) {
+			err = ccs_configuration_check(configurations[i]);
+			assert( err == CCS_SUCCESS );
+			err = ccs_release_object(configurations[i]);
+			assert( err == CCS_SUCCESS );
+		}
+	}
+
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(distribution);
+	assert( err == CCS_SUCCESS );
+	for (size_t i = 0; i < 4; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(configuration_space);
+	assert( err == CCS_SUCCESS );
+}
+
+// Requests larger than a sampling window are sliced Latin hypercube designs:
+// each window is a Latin hypercube design, and so is the whole request.
+void test_sliced_latin_hypercube() {
+	const size_t              window = 4096;
+	const size_t              num_configurations = 2 * window + 100;
+	ccs_hyperparameter_t      hyperparameter;
+	ccs_configuration_t      *configurations;
+	ccs_configuration_space_t configuration_space;
+	ccs_result_t              err;
+	char                     *strata;
+
+	err = ccs_create_configuration_space("my_config_space", NULL,
+	                                     &configuration_space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_numerical_hyperparameter("param1", CCS_NUM_FLOAT,
+	                                          CCSF(0.0), CCSF(1.0),
+	                                          CCSF(0.0), CCSF(0.0),
+	                                          NULL, &hyperparameter);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameter(configuration_space,
+	                                                 hyperparameter, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_sampling_method(configuration_space,
+		CCS_SAMPLING_LATIN_HYPERCUBE);
+	assert( err == CCS_SUCCESS );
+	configurations = (ccs_configuration_t *)malloc(
+		num_configurations * sizeof(ccs_configuration_t));
+	strata = (char *)malloc(3 * window);
+	assert( configurations && strata );
+	err = ccs_configuration_space_samples(configuration_space,
+	                                      num_configurations, configurations);
+	assert( err == CCS_SUCCESS );
+
+	// The fine strata of the 3 slices design hold at most one sample
+	memset(strata, 0, 3 * window);
+	for (size_t i = 0; i < num_configurations; i++) {
+		ccs_datum_t value;
+		err = ccs_configuration_get_value(configurations[i], 0, &value);
+		assert( err == CCS_SUCCESS );
+		size_t stratum = (size_t)(value.value.f * 3 * window);
+		assert( !strata[stratum] );
+		strata[stratum] = 1;
+	}
+	// Each full window has one sample per coarse stratum
+	for (size_t w = 0; w < 2; w++) {
+		memset(strata, 0, window);
+		for (size_t i = w * window; i < (w + 1) * window; i++) {
+			ccs_datum_t value;
+			err = ccs_configuration_get_value(configurations[i], 0, &value);
+			assert( err == CCS_SUCCESS );
+			size_t stratum = (size_t)(value.value.f * window);
+			assert( !strata[stratum] );
+			strata[stratum] = 1;
+		}
+	}
+	for (size_t i = 0; i < num_configurations; i++) {
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	free(strata);
+	free(configurations);
+	err = ccs_release_object(hyperparameter);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(configuration_space);
+	assert( err == CCS_SUCCESS );
+}
+
+void test_unique_sampling() {
+	ccs_hyperparameter_t      hyperparameters[3];
+	ccs_datum_t               possible_values[3];
+	ccs_expression_t          expressions[2];
+	ccs_configuration_t       configuration;
+	ccs_configuration_t       configurations[20];
+	ccs_configuration_space_t configuration_space;
+	ccs_bool_t                unique;
+	ccs_result_t              err;
+
+	err = ccs_create_configuration_space("my_config_space", NULL,
+	                                     &configuration_space);
+	assert( err == CCS_SUCCESS );
+	possible_values[0] = ccs_int(1);
+	possible_values[1] = ccs_int(2);
+	possible_values[2] = ccs_int(3);
+	err = ccs_create_categorical_hyperparameter("param1", 3, possible_values,
+	                                            0, NULL, hyperparameters);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_numerical_hyperparameter("param2", CCS_NUM_INTEGER,
+	                                          CCSI(0), CCSI(4),
+	                                          CCSI(0), CCSI(0),
+	                                          NULL, hyperparameters+1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_categorical_hyperparameter("param3", 2, possible_values,
+	                                            0, NULL, hyperparameters+2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameters(configuration_space, 3,
+	                                                  hyperparameters, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_parse((ccs_context_t)configuration_space,
+	                           "param1 == 1", expressions);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_condition(configuration_space, 2,
+	                                            expressions[0]);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_parse((ccs_context_t)configuration_space,
+	                           "param1 == 2 && param2 == 3", expressions+1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_forbidden_clause(configuration_space,
+	                                                   expressions[1]);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_get_unique_sampling(configuration_space,
+	                                                  &unique);
+	assert( err == CCS_SUCCESS );
+	assert( unique == CCS_FALSE );
+	err = ccs_configuration_space_set_unique_sampling(configuration_space,
+	                                                  CCS_TRUE);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_get_unique_sampling(configuration_space,
+	                                                  &unique);
+	assert( err == CCS_SUCCESS );
+	assert( unique == CCS_TRUE );
+
+	// 8 configurations where param1 is 1, and 7 others
+	err = ccs_configuration_space_samples(configuration_space, 10,
+	                                      configurations);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_exclude_configurations(configuration_space,
+	                                                     10, configurations);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_samples(configuration_space, 10,
+	                                      configurations + 10);
+	assert( err == -CCS_SAMPLING_EXHAUSTED );
+	for (size_t i = 15; i < 20; i++)
+		assert( configurations[i] == NULL );
+	for (size_t i = 0; i < 15; i++) {
+		err = ccs_configuration_check(configurations[i]);
+		assert( err == CCS_SUCCESS );
+		for (size_t j = 0; j < i; j++) {
+			int cmp;
+			err = ccs_configuration_cmp(configurations[i],
+			                            configurations[j], &cmp);
+			assert( err == CCS_SUCCESS );
+			assert( cmp != 0 );
+		}
+	}
+	err = ccs_configuration_space_sample(configuration_space, &configuration);
+	assert( err == -CCS_SAMPLING_EXHAUSTED );
+
+	// Disabling unique sampling forgets the sampled configurations
+	err = ccs_configuration_space_set_unique_sampling(configuration_space,
+	                                                  CCS_FALSE);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_unique_sampling(configuration_space,
+	                                                  CCS_TRUE);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_exclude_configurations(configuration_space,
+	                                                     14, configurations);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_sample(configuration_space, &configuration);
+	assert( err == CCS_SUCCESS );
+	int cmp;
+	err = ccs_configuration_cmp(configuration, configurations[14], &cmp);
+	assert( err == CCS_SUCCESS );
+	assert( cmp == 0 );
+	err = ccs_release_object(configuration);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_sample(configuration_space, &configuration);
+	assert( err == -CCS_SAMPLING_EXHAUSTED );
+	for (size_t i = 0; i < 2; i++) {
+		err = ccs_release_object(expressions[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	for (size_t i = 0; i < 3; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(configuration_space);
+	assert( err == CCS_SUCCESS );
+
+	// Integer ranges near the extremes are not enumerated
+	err = ccs_create_configuration_space("my_config_space", NULL,
+	                                     &configuration_space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_numerical_hyperparameter("param1", CCS_NUM_INTEGER,
+	                                          CCSI((ccs_int_t)CCS_INT_MIN),
+	                                          CCSI((ccs_int_t)CCS_INT_MIN + (1 << 30)),
+	                                          CCSI(0),
+	                                          CCSI((ccs_int_t)CCS_INT_MIN),
+	                                          NULL, hyperparameters);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameter(configuration_space,
+	                                                 hyperparameters[0], NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_unique_sampling(configuration_space,
+	                                                  CCS_TRUE);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_sample(configuration_space, &configuration);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(configuration);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(hyperparameters[0]);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(configuration_space);
+	assert( err == CCS_SUCCESS );
+
+	// Only the values of the sampling distribution are counted
+	ccs_distribution_t distribution;
+	size_t             index = 0;
+	err = ccs_create_configuration_space("my_config_space", NULL,
+	                                     &configuration_space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_numerical_hyperparameter("param1", CCS_NUM_INTEGER,
+	                                          CCSI(0), CCSI(5),
+	                                          CCSI(0), CCSI(0),
+	                                          NULL, hyperparameters);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameter(configuration_space,
+	                                                 hyperparameters[0], NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_unique_sampling(configuration_space,
+	                                                  CCS_TRUE);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_uniform_distribution(CCS_NUM_INTEGER, CCSI(0), CCSI(2),
+	                                      CCS_LINEAR, CCSI(0), &distribution);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_distribution(configuration_space,
+	                                               distribution, &index);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(distribution);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_samples(configuration_space, 2,
+	                                      configurations + 15);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_sample(configuration_space, &configuration);
+	assert( err == -CCS_SAMPLING_UNSUCCESSFUL );
+	// Back to the whole domain, 3 values remain
+	err = ccs_create_uniform_distribution(CCS_NUM_INTEGER, CCSI(0), CCSI(5),
+	                                      CCS_LINEAR, CCSI(0), &distribution);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_distribution(configuration_space,
+	                                               distribution, &index);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(distribution);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_samples(configuration_space, 3,
+	                                      configurations + 17);
+	assert( err == CCS_SUCCESS );
+	for (size_t i = 15; i < 20; i++) {
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_configuration_space_sample(configuration_space, &configuration);
+	assert( err == -CCS_SAMPLING_EXHAUSTED );
+	err = ccs_release_object(hyperparameters[0]);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(configuration_space);
+	assert( err == CCS_SUCCESS );
+
+	for (size_t i = 0; i < 15; i++) {
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+}
+
+void test_check_configurations() {
+	ccs_hyperparameter_t         hyperparameters[3];
+	ccs_datum_t                  possible_values[3];
+	ccs_expression_t             expressions[2];
+	ccs_configuration_t          configurations[101];
+	ccs_configuration_space_t    configuration_space, configuration_space2;
+	ccs_datum_t                  values[7][3];
+	ccs_bool_t                   valids[101];
+	ccs_configuration_validity_t reasons[101];
+	ccs_configuration_validity_t expected[7] = {
+		CCS_CONFIGURATION_VALID,
+		CCS_CONFIGURATION_INVALID_ACTIVATION,
+		CCS_CONFIGURATION_INVALID_ACTIVATION,
+		CCS_CONFIGURATION_INVALID_VALUE,
+		CCS_CONFIGURATION_FORBIDDEN,
+		CCS_CONFIGURATION_INVALID_VALUE,
+		CCS_CONFIGURATION_VALID };
+	ccs_result_t                 err;
+
+	err = ccs_create_configuration_space("my_config_space", NULL,
+	                                     &configuration_space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_numerical_hyperparameter("param1", CCS_NUM_FLOAT,
+	                                          CCSF(-5.0), CCSF(5.0),
+	                                          CCSF(0.0), CCSF(0.0),
+	                                          NULL, hyperparameters);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_numerical_hyperparameter("param2", CCS_NUM_INTEGER,
+	                                          CCSI(0), CCSI(10),
+	                                          CCSI(0), CCSI(0),
+	                                          NULL, hyperparameters+1);
+	assert( err == CCS_SUCCESS );
+	possible_values[0] = ccs_int(1);
+	possible_values[1] = ccs_float(2.0);
+	possible_values[2] = ccs_string("3");
+	err = ccs_create_categorical_hyperparameter("param3", 3, possible_values,
+	                                            0, NULL, hyperparameters+2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameters(configuration_space, 3,
+	                                                  hyperparameters, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_parse((ccs_context_t)configuration_space,
+	                           "param2 < 5", expressions);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_condition(configuration_space, 0,
+	                                            expressions[0]);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_parse((ccs_context_t)configuration_space,
+	                           "param2 == 7", expressions+1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_forbidden_clause(configuration_space,
+	                                                   expressions[1]);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_samples(configuration_space, 100,
+	                                      configurations);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_configuration_space("my_config_space2", NULL,
+	                                     &configuration_space2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_configuration(configuration_space2, 0, NULL, NULL,
+	                               configurations + 100);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_check_configurations(configuration_space,
+	                                                   101, configurations,
+	                                                   valids, reasons);
+	assert( err == CCS_SUCCESS );
+	for (size_t i = 0; i < 100; i++) {
+		assert( valids[i] == CCS_TRUE );
+		assert( reasons[i] == CCS_CONFIGURATION_VALID );
+	}
+	assert( valids[100] == CCS_FALSE );
+	assert( reasons[100] == CCS_CONFIGURATION_INVALID_SPACE );
+
+	values[0][0] = ccs_float(1.0);
+	values[0][1] = ccs_int(2);
+	values[0][2] = ccs_int(1);
+	values[1][0] = ccs_inactive;
+	values[1][1] = ccs_int(2);
+	values[1][2] = ccs_int(1);
+	values[2][0] = ccs_float(1.0);
+	values[2][1] = ccs_int(6);
+	values[2][2] = ccs_int(1);
+	values[3][0] = ccs_float(7.0);
+	values[3][1] = ccs_int(2);
+	values[3][2] = ccs_int(1);
+	values[4][0] = ccs_inactive;
+	values[4][1] = ccs_int(7);
+	values[4][2] = ccs_int(1);
+	values[5][0] = ccs_inactive;
+	values[5][1] = ccs_int(6);
+	values[5][2] = ccs_string("4");
+	values[6][0] = ccs_inactive;
+	values[6][1] = ccs_int(6);
+	values[6][2] = ccs_string("3");
+	err = ccs_configuration_space_check_configurations_values(
+		configuration_space, 7, 3, (ccs_datum_t *)values, valids, reasons);
+	assert( err == CCS_SUCCESS );
+	for (size_t i = 0; i < 7; i++) {
+		assert( reasons[i] == expected[i] );
+		assert( valids[i] == (expected[i] == CCS_CONFIGURATION_VALID ?
+		                      CCS_TRUE : CCS_FALSE) );
+		err = ccs_configuration_space_check_configuration_values(
+			configuration_space, 3, values[i]);
+		assert( err == (expected[i] == CCS_CONFIGURATION_VALID ?
+		                CCS_SUCCESS : -CCS_INVALID_CONFIGURATION) );
+	}
+	err = ccs_configuration_space_check_configurations_values(
+		configuration_space, 7, 3, (ccs_datum_t *)values, valids, NULL);
+	assert( err == CCS_SUCCESS );
+	assert( valids[0] == CCS_TRUE && valids[3] == CCS_FALSE );
+	err = ccs_configuration_space_check_configurations_values(
+		configuration_space, 3, 2, (ccs_datum_t *)values, valids, reasons);
+	assert( err == CCS_SUCCESS );
+	for (size_t i = 0; i < 3; i++)
+		assert( reasons[i] == CCS_CONFIGURATION_INVALID_SPACE );
+	err = ccs_configuration_space_check_configurations_values(
+		configuration_space, 7, 3, (ccs_datum_t *)values, NULL, reasons);
+	assert( err == -CCS_INVALID_VALUE );
+
+	for (size_t i = 0; i < 101; i++) {
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	for (size_t i = 0; i < 2; i++) {
+		err = ccs_release_object(expressions[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	for (size_t i = 0; i < 3; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(configuration_space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(configuration_space2);
+	assert( err == CCS_SUCCESS );
+}
+
 int main() {
 	ccs_init();
 	test_create();
 	test_add();
 	test_add_list();
 	test_sample();
+	test_sample_parallel();
+	test_create_configurations();
 	test_set_distribution();
+	test_sampling_methods();
+	test_sliced_latin_hypercube();
+	test_unique_sampling();
+	test_check_configurations();
 	ccs_fini();
 	return 0;
 }
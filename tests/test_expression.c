@@ -63,25 +63,26 @@ void test_expression_wrapper(ccs_expression_type_t type,
 
 	err = ccs_create_expression(type, count, nodes, &expression);
 	assert( err == CCS_SUCCESS );
-	err = ccs_expression_eval(expression, (ccs_context_t)context, inputs, &result);
-	assert( err == eerr );
-	if (eerr != CCS_SUCCESS) {
-		err = ccs_release_object(expression);
+	// Evaluate the expression tree, then the compiled expression
+	for (int i = 0; i < 2; i++) {
+		err = ccs_expression_eval(expression, (ccs_context_t)context, inputs, &result);
+		assert( err == eerr );
+		if (eerr == CCS_SUCCESS) {
+			assert( result.type == eres.type );
+			switch (result.type) {
+			case CCS_INTEGER:
+			case CCS_BOOLEAN:
+				assert( result.value.i == eres.value.i );
+				break;
+			case CCS_FLOAT:
+				assert( result.value.f == eres.value.f );
+				break;
+			default:
+				assert( 0 );
+			}
+		}
+		err = ccs_expression_compile(expression, (ccs_context_t)context);
 		assert( err == CCS_SUCCESS );
-		return;
-	}
-	assert( result.type == eres.type );
-	switch (result.type) {
-	case CCS_INTEGER:
-	case CCS_BOOLEAN:
-		assert( result.value.i == eres.value.i );
-		break;
-	case CCS_FLOAT:
-		assert( result.value.f == eres.value.f );
-		break;
-	default:
-		assert( 0 );
-
 	}
 	err = ccs_release_object(expression);
 	assert( err == CCS_SUCCESS );
@@ -673,6 +674,81 @@ void test_in() {
 	assert( err == CCS_SUCCESS );
 }
 
+void test_in_large() {
+	ccs_expression_t          list, expression;
+	ccs_hyperparameter_t      hyperparameter;
+	ccs_configuration_space_t space;
+	ccs_datum_t               values[200];
+	ccs_datum_t               value, result;
+	ccs_result_t              err;
+
+	hyperparameter = create_dummy_categorical("param1");
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameter(space, hyperparameter, NULL);
+	assert( err == CCS_SUCCESS );
+
+	// Only the first two values are valid values of param1
+	values[0] = ccs_string("toto");
+	values[1] = ccs_float(2.0);
+	for (size_t i = 2; i < 200; i++)
+		values[i] = ccs_int(200 - i);
+	err = ccs_create_expression(CCS_LIST, 200, values, &list);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_binary_expression(CCS_IN, ccs_object(hyperparameter),
+	                                   ccs_object(list), &expression);
+	assert( err == CCS_SUCCESS );
+
+	// Values not found before the first invalid element fail
+	for (int i = 0; i < 2; i++) {
+		value = ccs_string("toto");
+		err = ccs_expression_eval(expression, (ccs_context_t)space, &value, &result);
+		assert( err == CCS_SUCCESS );
+		assert( result.type == CCS_BOOLEAN && result.value.i == CCS_TRUE );
+		value = ccs_float(2.0);
+		err = ccs_expression_eval(expression, (ccs_context_t)space, &value, &result);
+		assert( err == CCS_SUCCESS );
+		assert( result.type == CCS_BOOLEAN && result.value.i == CCS_TRUE );
+		value = ccs_int(1);
+		err = ccs_expression_eval(expression, (ccs_context_t)space, &value, &result);
+		assert( err == -CCS_INVALID_VALUE );
+		err = ccs_expression_compile(expression, (ccs_context_t)space);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(list);
+	assert( err == CCS_SUCCESS );
+
+	for (size_t i = 0; i < 200; i++)
+		values[i] = ccs_float(0.5 * i);
+	err = ccs_create_expression(CCS_LIST, 200, values, &list);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_binary_expression(CCS_IN, ccs_int(42), ccs_object(list),
+	                                   &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_eval(expression, NULL, NULL, &result);
+	assert( err == CCS_SUCCESS );
+	assert( result.type == CCS_BOOLEAN && result.value.i == CCS_TRUE );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_binary_expression(CCS_IN, ccs_float(42.25),
+	                                   ccs_object(list), &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_eval(expression, NULL, NULL, &result);
+	assert( err == CCS_SUCCESS );
+	assert( result.type == CCS_BOOLEAN && result.value.i == CCS_FALSE );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(list);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_release_object(hyperparameter);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
+
 void
 test_compound() {
 	ccs_expression_t      expression1, expression2;
@@ -832,6 +908,329 @@ void test_check_context() {
 	assert( err == CCS_SUCCESS );
 }
 
+void test_compile() {
+	ccs_expression_t          expression;
+	ccs_hyperparameter_t      hyperparameter1, hyperparameter2;
+	ccs_configuration_space_t space1, space2;
+	ccs_datum_t               values[2];
+	ccs_datum_t               result;
+	ccs_result_t              err;
+
+	hyperparameter1 = create_dummy_numerical("param1");
+	hyperparameter2 = create_dummy_numerical("param2");
+
+	err = ccs_create_configuration_space("space1", NULL, &space1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameter(space1, hyperparameter1, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameter(space1, hyperparameter2, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_configuration_space("space2", NULL, &space2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameter(space2, hyperparameter2, NULL);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_create_binary_expression(CCS_LESS, ccs_object(hyperparameter2),
+	                                   ccs_float(1.0), &expression);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_expression_compile(expression, NULL);
+	assert( err == -CCS_INVALID_VALUE );
+	err = ccs_expression_compile(expression, (ccs_context_t)space1);
+	assert( err == CCS_SUCCESS );
+
+	values[0] = ccs_float(2.0);
+	values[1] = ccs_float(0.0);
+	err = ccs_expression_eval(expression, (ccs_context_t)space1, values, &result);
+	assert( err == CCS_SUCCESS );
+	assert( result.type == CCS_BOOLEAN && result.value.i == CCS_TRUE );
+	values[1] = ccs_inactive;
+	err = ccs_expression_eval(expression, (ccs_context_t)space1, values, &result);
+	assert( err == -CCS_INACTIVE_HYPERPARAMETER );
+
+	// Other contexts still evaluate the expression tree
+	values[0] = ccs_float(2.0);
+	err = ccs_expression_eval(expression, (ccs_context_t)space2, values, &result);
+	assert( err == CCS_SUCCESS );
+	assert( result.type == CCS_BOOLEAN && result.value.i == CCS_FALSE );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+
+	// Variables evaluated alternately in contexts where their
+	// hyperparameter has different indexes
+	err = ccs_create_variable(hyperparameter2, &expression);
+	assert( err == CCS_SUCCESS );
+	values[0] = ccs_float(2.0);
+	values[1] = ccs_float(3.0);
+	for (int i = 0; i < 3; i++) {
+		err = ccs_expression_eval(expression, (ccs_context_t)space1, values, &result);
+		assert( err == CCS_SUCCESS );
+		assert( result.type == CCS_FLOAT && result.value.f == 3.0 );
+		err = ccs_expression_eval(expression, (ccs_context_t)space2, values, &result);
+		assert( err == CCS_SUCCESS );
+		assert( result.type == CCS_FLOAT && result.value.f == 2.0 );
+	}
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(hyperparameter1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(hyperparameter2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(space1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(space2);
+	assert( err == CCS_SUCCESS );
+}
+
+void test_eval_batch() {
+	ccs_expression_t          expression1, expression2;
+	ccs_hyperparameter_t      hyperparameter1, hyperparameter2;
+	ccs_configuration_space_t space;
+	ccs_datum_t               values[8];
+	ccs_datum_t               results[4];
+	ccs_result_t              err;
+
+	hyperparameter1 = create_dummy_numerical("param1");
+	hyperparameter2 = create_dummy_numerical("param2");
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameter(space, hyperparameter1, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameter(space, hyperparameter2, NULL);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_create_binary_expression(CCS_LESS, ccs_object(hyperparameter2),
+	                                   ccs_float(1.0), &expression1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_binary_expression(CCS_OR, ccs_object(expression1),
+	    ccs_object(hyperparameter1), &expression2);
+	assert( err == CCS_SUCCESS );
+
+	values[0] = ccs_bool(CCS_FALSE);
+	values[1] = ccs_float(0.0);
+	values[2] = ccs_bool(CCS_FALSE);
+	values[3] = ccs_float(2.0);
+	values[4] = ccs_inactive;
+	values[5] = ccs_float(2.0);
+	values[6] = ccs_bool(CCS_TRUE);
+	values[7] = ccs_inactive;
+
+	err = ccs_expression_eval_batch(expression2, (ccs_context_t)space, 4,
+	                                values, results);
+	assert( err == CCS_SUCCESS );
+	assert( results[0].type == CCS_BOOLEAN && results[0].value.i == CCS_TRUE );
+	assert( results[1].type == CCS_BOOLEAN && results[1].value.i == CCS_FALSE );
+	assert( results[2].type == CCS_INACTIVE );
+	assert( results[3].type == CCS_BOOLEAN && results[3].value.i == CCS_TRUE );
+
+	// The right operand of the OR is not evaluated for the first row
+	values[0] = ccs_float(3.0);
+	err = ccs_expression_eval_batch(expression2, (ccs_context_t)space, 1,
+	                                values, results);
+	assert( err == CCS_SUCCESS );
+	assert( results[0].type == CCS_BOOLEAN && results[0].value.i == CCS_TRUE );
+	values[2] = ccs_float(3.0);
+	err = ccs_expression_eval_batch(expression2, (ccs_context_t)space, 2,
+	                                values, results);
+	assert( err == -CCS_INVALID_VALUE );
+
+	err = ccs_release_object(expression1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(hyperparameter1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(hyperparameter2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
+
+// Numeric columns are evaluated with typed loops, the results must be the
+// same as evaluating the rows one at a time
+void test_eval_batch_numeric() {
+	ccs_expression_type_t types[] = {
+		CCS_EQUAL, CCS_NOT_EQUAL, CCS_LESS, CCS_GREATER,
+		CCS_LESS_OR_EQUAL, CCS_GREATER_OR_EQUAL,
+		CCS_ADD, CCS_SUBSTRACT, CCS_MULTIPLY, CCS_DIVIDE, CCS_MODULO };
+	ccs_datum_t operands[] = {
+		ccs_int(3), ccs_int(-2), ccs_int(0), ccs_float(0.0),
+		ccs_float(-0.0), ccs_float(2.5), ccs_inactive };
+	const size_t num_types = sizeof(types) / sizeof(types[0]);
+	const size_t num_operands = sizeof(operands) / sizeof(operands[0]);
+	ccs_hyperparameter_t      hyperparameter1, hyperparameter2;
+	ccs_configuration_space_t space;
+	ccs_expression_t          expression;
+	ccs_datum_t               values[2 * 4];
+	ccs_datum_t               results[4], result;
+	ccs_result_t              err, expected_err;
+
+	hyperparameter1 = create_dummy_numerical("param1");
+	hyperparameter2 = create_dummy_numerical("param2");
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameter(space, hyperparameter1, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameter(space, hyperparameter2, NULL);
+	assert( err == CCS_SUCCESS );
+
+	for (size_t t = 0; t < num_types; t++)
+	for (size_t literal = 0; literal < 2; literal++)
+	for (size_t a = 0; a < num_operands; a++)
+	for (size_t b = 0; b < num_operands; b++) {
+		if (literal && operands[b].type == CCS_INACTIVE)
+			continue;
+		err = ccs_create_binary_expression(types[t],
+		    ccs_object(hyperparameter1),
+		    literal ? operands[b] : ccs_object(hyperparameter2),
+		    &expression);
+		assert( err == CCS_SUCCESS );
+		// Rows with the same types, then mixed types on the left
+		for (size_t i = 0; i < 4; i++) {
+			values[2 * i] = operands[i < 2 ? a : (a + i) % num_operands];
+			values[2 * i + 1] = operands[b];
+		}
+		expected_err = CCS_SUCCESS;
+		for (size_t i = 0; i < 4; i++) {
+			err = ccs_expression_eval(expression, (ccs_context_t)space,
+			                          values + 2 * i, &result);
+			if (err == -CCS_INACTIVE_HYPERPARAMETER)
+				continue;
+			if (err != CCS_SUCCESS) {
+				expected_err = err;
+				break;
+			}
+		}
+		err = ccs_expression_eval_batch(expression, (ccs_context_t)space, 4,
+		                                values, results);
+		assert( err == expected_err );
+		for (size_t i = 0; expected_err == CCS_SUCCESS && i < 4; i++) {
+			err = ccs_expression_eval(expression, (ccs_context_t)space,
+			                          values + 2 * i, &result);
+			if (err == -CCS_INACTIVE_HYPERPARAMETER) {
+				assert( results[i].type == CCS_INACTIVE );
+				continue;
+			}
+			assert( err == CCS_SUCCESS );
+			assert( results[i].type == result.type );
+			assert( !memcmp(&results[i].value, &result.value,
+			                sizeof(ccs_value_t)) );
+		}
+		err = ccs_release_object(expression);
+		assert( err == CCS_SUCCESS );
+	}
+
+	err = ccs_release_object(hyperparameter1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(hyperparameter2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
+
+void test_simplify() {
+	ccs_expression_t          expression1, expression2, expression3;
+	ccs_expression_t          simplified, nodes[2];
+	ccs_expression_type_t     type;
+	ccs_hyperparameter_t      hyperparameter;
+	ccs_datum_t               value;
+	ccs_result_t              err;
+
+	hyperparameter = create_dummy_numerical("param1");
+
+	// 1 + 2 < param1 becomes param1 > 3
+	err = ccs_create_binary_expression(CCS_ADD, ccs_int(1), ccs_int(2),
+	                                   &expression1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_binary_expression(CCS_LESS, ccs_object(expression1),
+	                                   ccs_object(hyperparameter), &expression2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_simplify(expression2, &simplified);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_get_type(simplified, &type);
+	assert( err == CCS_SUCCESS );
+	assert( type == CCS_GREATER );
+	err = ccs_expression_get_nodes(simplified, 2, nodes, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_get_type(nodes[0], &type);
+	assert( err == CCS_SUCCESS );
+	assert( type == CCS_VARIABLE );
+	err = ccs_literal_get_value(nodes[1], &value);
+	assert( err == CCS_SUCCESS );
+	assert( value.type == CCS_INTEGER && value.value.i == 3 );
+	err = ccs_release_object(simplified);
+	assert( err == CCS_SUCCESS );
+
+	// !!(false || 1 + 2 < param1) becomes param1 > 3
+	err = ccs_create_binary_expression(CCS_OR, ccs_false,
+	                                   ccs_object(expression2), &expression1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_unary_expression(CCS_NOT, ccs_object(expression1),
+	                                  &expression3);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_unary_expression(CCS_NOT, ccs_object(expression3),
+	                                  &expression1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression3);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_simplify(expression1, &simplified);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_get_type(simplified, &type);
+	assert( err == CCS_SUCCESS );
+	assert( type == CCS_GREATER );
+	err = ccs_release_object(simplified);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression1);
+	assert( err == CCS_SUCCESS );
+
+	// Constant expressions that fail are kept
+	err = ccs_create_binary_expression(CCS_ADD, ccs_int(1), ccs_string("a"),
+	                                   &expression1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_simplify(expression1, &simplified);
+	assert( err == CCS_SUCCESS );
+	assert( simplified == expression1 );
+	err = ccs_release_object(simplified);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression1);
+	assert( err == CCS_SUCCESS );
+
+	// true || param1 becomes true, even though param1 is not a boolean
+	err = ccs_create_binary_expression(CCS_OR, ccs_true,
+	                                   ccs_object(hyperparameter), &expression1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_simplify(expression1, &simplified);
+	assert( err == CCS_SUCCESS );
+	err = ccs_literal_get_value(simplified, &value);
+	assert( err == CCS_SUCCESS );
+	assert( value.type == CCS_BOOLEAN && value.value.i == CCS_TRUE );
+	err = ccs_release_object(simplified);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression1);
+	assert( err == CCS_SUCCESS );
+
+	// false || param1 is kept as param1 is not a boolean
+	err = ccs_create_binary_expression(CCS_OR, ccs_false,
+	                                   ccs_object(hyperparameter), &expression1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_simplify(expression1, &simplified);
+	assert( err == CCS_SUCCESS );
+	assert( simplified == expression1 );
+	err = ccs_release_object(simplified);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression1);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_release_object(expression2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(hyperparameter);
+	assert( err == CCS_SUCCESS );
+}
+
 int main() {
 	ccs_init();
 	test_equal_literal();
@@ -854,7 +1253,12 @@ int main() {
 	test_arithmetic_greater_or_equal();
 	test_compound();
 	test_in();
+	test_in_large();
 	test_get_hyperparameters();
 	test_check_context();
+	test_compile();
+	test_eval_batch();
+	test_eval_batch_numeric();
+	test_simplify();
 	ccs_fini();
 }
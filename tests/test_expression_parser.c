@@ -0,0 +1,140 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <cconfigspace.h>
+#include <string.h>
+
+void check_parse(ccs_context_t  context,
+                 const char    *str,
+                 ccs_datum_t   *values,
+                 ccs_datum_t    eres) {
+	ccs_expression_t expression;
+	ccs_datum_t      result;
+	ccs_result_t     err;
+
+	err = ccs_expression_parse(context, str, &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_eval(expression, context, values, &result);
+	assert( err == CCS_SUCCESS );
+	assert( result.type == eres.type );
+	if (eres.type == CCS_STRING)
+		assert( strcmp(result.value.s, eres.value.s) == 0 );
+	else
+		assert( memcmp(&result.value, &eres.value, sizeof(ccs_value_t)) == 0 );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+}
+
+void test_parse() {
+	ccs_expression_t      expression;
+	ccs_expression_t      nodes[2];
+	ccs_expression_type_t type;
+	ccs_result_t          err;
+
+	err = ccs_expression_parse(NULL,
+	    "1.0 + 1 == 2 || +1 == 3e0 && \"y\\nes\" == 'no' ", &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_get_type(expression, &type);
+	assert( err == CCS_SUCCESS );
+	assert( type == CCS_OR );
+	err = ccs_expression_get_nodes(expression, 2, nodes, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_get_type(nodes[0], &type);
+	assert( err == CCS_SUCCESS );
+	assert( type == CCS_EQUAL );
+	err = ccs_expression_get_type(nodes[1], &type);
+	assert( err == CCS_SUCCESS );
+	assert( type == CCS_AND );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+
+	check_parse(NULL, "(1 + 3) * 2", NULL, ccs_int(8));
+	check_parse(NULL, "1 + 3 * 2", NULL, ccs_int(7));
+	check_parse(NULL, "5 - 2 - 1", NULL, ccs_int(2));
+	check_parse(NULL, "5 - +(+2 - 1)", NULL, ccs_int(4));
+	check_parse(NULL, "5-1", NULL, ccs_int(4));
+	check_parse(NULL, "-5 - -1", NULL, ccs_int(-4));
+	check_parse(NULL, "- 5 * 2", NULL, ccs_int(-10));
+	check_parse(NULL, "1.5e1 / 2", NULL, ccs_float(7.5));
+	check_parse(NULL, "5 # [3.0, 5]", NULL, ccs_true);
+	check_parse(NULL, "5 # [3.0, 4]", NULL, ccs_false);
+	check_parse(NULL, "5 # []", NULL, ccs_false);
+	check_parse(NULL, "!5 # [5] || false", NULL, ccs_false);
+	check_parse(NULL, "'a\\'b' == \"a'b\"", NULL, ccs_true);
+	check_parse(NULL, "\"tab\\t\"", NULL, ccs_string("tab\t"));
+	check_parse(NULL, "true", NULL, ccs_true);
+	check_parse(NULL, "none", NULL, ccs_none);
+	check_parse(NULL, "1 <= 2 != false", NULL, ccs_true);
+}
+
+void test_parse_variables() {
+	ccs_hyperparameter_t      hyperparameters[2];
+	ccs_configuration_space_t space;
+	ccs_expression_t          expression;
+	ccs_datum_t               values[2];
+	ccs_datum_t               possible_values[3];
+	ccs_result_t              err;
+
+	err = ccs_create_numerical_hyperparameter("param1", CCS_NUM_INTEGER,
+	                                          CCSI(0), CCSI(10), CCSI(0),
+	                                          CCSI(0), NULL, hyperparameters);
+	assert( err == CCS_SUCCESS );
+	possible_values[0] = ccs_string("foo");
+	possible_values[1] = ccs_string("bar");
+	possible_values[2] = ccs_string("baz");
+	err = ccs_create_categorical_hyperparameter("none_of_them", 3,
+	                                            possible_values, 0, NULL,
+	                                            hyperparameters + 1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameters(space, 2,
+	                                                  hyperparameters, NULL);
+	assert( err == CCS_SUCCESS );
+
+	values[0] = ccs_int(3);
+	values[1] = ccs_string("bar");
+	check_parse((ccs_context_t)space, "param1 < 5 && none_of_them # ['bar', 'baz']",
+	            values, ccs_true);
+	check_parse((ccs_context_t)space, "param1*2>=6==(none_of_them=='foo')",
+	            values, ccs_false);
+
+	err = ccs_expression_parse((ccs_context_t)space, "param2 < 5", &expression);
+	assert( err == -CCS_INVALID_NAME );
+	err = ccs_expression_parse(NULL, "param1 < 5", &expression);
+	assert( err == -CCS_INVALID_OBJECT );
+
+	for (size_t i = 0; i < 2; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
+
+void test_parse_errors() {
+	const char *strs[] = {
+		"", "1 +", "(1 + 2", "1 + 2)", "1 2", "5 # 3", "5 # [1,]",
+		"5 # [1 + 2]", "''", "'abc", "'a\\qb'", "1.", "1 ^ 2", "1 =! 2",
+		"99999999999999999999"
+	};
+	ccs_expression_t expression;
+	ccs_result_t     err;
+
+	for (size_t i = 0; i < sizeof(strs)/sizeof(*strs); i++) {
+		err = ccs_expression_parse(NULL, strs[i], &expression);
+		assert( err == -CCS_INVALID_VALUE );
+	}
+	err = ccs_expression_parse(NULL, NULL, &expression);
+	assert( err == -CCS_INVALID_VALUE );
+	err = ccs_expression_parse(NULL, "1", NULL);
+	assert( err == -CCS_INVALID_VALUE );
+}
+
+int main() {
+	ccs_init();
+	test_parse();
+	test_parse_variables();
+	test_parse_errors();
+	ccs_fini();
+	return 0;
+}
@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <stdio.h>
 #include <assert.h>
 #include <cconfigspace.h>
 #include <string.h>
@@ -203,11 +204,519 @@ test_combined() {
 	assert( err == CCS_SUCCESS );
 }
 
+void
+test_narrow() {
+	ccs_hyperparameter_t      hyperparameters[4];
+	ccs_configuration_space_t space;
+	ccs_expression_t          expression, lower, upper;
+	ccs_configuration_t       configuration;
+	ccs_datum_t               values[4];
+	ccs_configuration_t       configurations[100];
+	ccs_result_t              err;
+
+	hyperparameters[0] = create_numerical("param1");
+	hyperparameters[1] = create_numerical("param2");
+	hyperparameters[2] = create_numerical("param3");
+	hyperparameters[3] = create_numerical("param4");
+
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_add_hyperparameters(space, 4, hyperparameters,
+	                                                  NULL);
+	assert( err == CCS_SUCCESS );
+
+	// Each clause rejects 90% of the values of its hyperparameter, so
+	// rejecting whole configurations would only accept one in 10^4.
+	for (int i = 0; i < 4; i++) {
+		err = ccs_create_binary_expression(CCS_LESS,
+		                                   ccs_object(hyperparameters[i]),
+		                                   ccs_float(-0.1), &lower);
+		assert( err == CCS_SUCCESS );
+		err = ccs_create_binary_expression(CCS_GREATER,
+		                                   ccs_object(hyperparameters[i]),
+		                                   ccs_float(0.1), &upper);
+		assert( err == CCS_SUCCESS );
+		err = ccs_create_binary_expression(CCS_OR, ccs_object(lower),
+		                                   ccs_object(upper), &expression);
+		assert( err == CCS_SUCCESS );
+		err = ccs_configuration_space_add_forbidden_clause(space, expression);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(expression);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(lower);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(upper);
+		assert( err == CCS_SUCCESS );
+	}
+
+	err = ccs_configuration_space_sample(space, &configuration);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_check_configuration(space, configuration);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(configuration);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_samples(space, 100, configurations);
+	assert( err == CCS_SUCCESS );
+
+	for (int i = 0; i < 100; i ++) {
+		err = ccs_configuration_get_values(configurations[i], 4, values, NULL);
+		assert( err == CCS_SUCCESS );
+		for (int j = 0; j < 4; j++) {
+			assert( values[j].type == CCS_FLOAT );
+			assert( values[j].value.f >= -0.1 && values[j].value.f <= 0.1 );
+		}
+		err = ccs_configuration_space_check_configuration(space, configurations[i]);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+
+	for (int i =0; i < 4; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
+
+void
+test_reorder() {
+	ccs_hyperparameter_t      hyperparameters[2];
+	ccs_configuration_space_t space;
+	ccs_expression_t          expressions[2], clauses[2];
+	ccs_datum_t               values[2];
+	ccs_configuration_t       configurations[1000];
+	ccs_result_t              err;
+
+	hyperparameters[0] = create_numerical("param1");
+	hyperparameters[1] = create_numerical("param2");
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameters(space, 2, hyperparameters, NULL);
+	assert( err == CCS_SUCCESS );
+
+	// The first clause rarely rejects, the second one often does
+	err = ccs_create_binary_expression(CCS_GREATER, ccs_object(hyperparameters[0]),
+	                                   ccs_float(0.9), expressions);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_binary_expression(CCS_GREATER, ccs_object(hyperparameters[1]),
+	                                   ccs_float(0.25), expressions + 1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_forbidden_clauses(space, 2, expressions);
+	assert( err == CCS_SUCCESS );
+
+	for (int j = 0; j < 2; j++) {
+		for (int k = 0; k < 3; k++) {
+			err = ccs_configuration_space_samples(space, 1000, configurations);
+			assert( err == CCS_SUCCESS );
+			for (int i = 0; i < 1000; i++) {
+				err = ccs_configuration_get_values(configurations[i], 2, values, NULL);
+				assert( err == CCS_SUCCESS );
+				assert( values[0].value.f <= 0.9 );
+				assert( values[1].value.f <= 0.25 );
+				err = ccs_configuration_space_check_configuration(space, configurations[i]);
+				assert( err == CCS_SUCCESS );
+				err = ccs_release_object(configurations[i]);
+				assert( err == CCS_SUCCESS );
+			}
+		}
+		err = ccs_configuration_space_freeze_forbidden_clauses_order(space, CCS_TRUE);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_configuration_space_freeze_forbidden_clauses_order(space, CCS_FALSE);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_get_forbidden_clauses(space, 2, clauses, NULL);
+	assert( err == CCS_SUCCESS );
+	assert( clauses[0] == expressions[0] );
+	assert( clauses[1] == expressions[1] );
+
+	for (int i = 0; i < 2; i++) {
+		err = ccs_release_object(expressions[i]);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
+
+
+void
+test_inactive() {
+	ccs_hyperparameter_t      hyperparameters[2];
+	ccs_configuration_space_t space;
+	ccs_expression_t          expression, expressions[2], nodes[2];
+	ccs_datum_t               values[2];
+	ccs_configuration_t       configurations[1000];
+	ccs_result_t              err;
+
+	hyperparameters[0] = create_numerical("param1");
+	hyperparameters[1] = create_numerical("param2");
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameters(space, 2, hyperparameters, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_binary_expression(CCS_GREATER, ccs_object(hyperparameters[0]),
+	                                   ccs_float(0.0), &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_condition(space, 1, expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+
+	// The first clause can only reject configurations where param2 is
+	// active, the second one must still be tested when it is not.
+	err = ccs_expression_parse((ccs_context_t)space,
+	                           "param2 < 0.0 || param2 > 0.75", expressions);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_binary_expression(CCS_GREATER, ccs_object(hyperparameters[1]),
+	                                   ccs_float(0.5), nodes);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_binary_expression(CCS_LESS, ccs_object(hyperparameters[0]),
+	                                   ccs_float(-0.5), nodes + 1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_binary_expression(CCS_OR, ccs_object(nodes[0]),
+	                                   ccs_object(nodes[1]), expressions + 1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_forbidden_clauses(space, 2, expressions);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_samples(space, 1000, configurations);
+	assert( err == CCS_SUCCESS );
+	for (int i = 0; i < 1000; i++) {
+		err = ccs_configuration_get_values(configurations[i], 2, values, NULL);
+		assert( err == CCS_SUCCESS );
+		assert( values[0].type == CCS_FLOAT );
+		assert( values[0].value.f >= -0.5 );
+		if (values[0].value.f > 0.0) {
+			assert( values[1].type == CCS_FLOAT );
+			assert( values[1].value.f >= 0.0 && values[1].value.f <= 0.5 );
+		} else
+			assert( values[1].type == CCS_INACTIVE );
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+
+	values[0] = ccs_float(-0.75);
+	values[1] = ccs_inactive;
+	err = ccs_configuration_space_check_configuration_values(space, 2, values);
+	assert( err == -CCS_INVALID_CONFIGURATION );
+	values[0] = ccs_float(-0.25);
+	err = ccs_configuration_space_check_configuration_values(space, 2, values);
+	assert( err == CCS_SUCCESS );
+
+	for (int i = 0; i < 2; i++) {
+		err = ccs_release_object(nodes[i]);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(expressions[i]);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
+
+void
+test_categorical() {
+	ccs_hyperparameter_t      hyperparameters[3];
+	ccs_configuration_space_t space;
+	ccs_expression_t          expression, expressions[2];
+	ccs_datum_t               possible_values[4];
+	ccs_datum_t               values[3], result;
+	ccs_configuration_t       configurations[1000];
+	ccs_result_t              err;
+
+	possible_values[0] = ccs_string("a");
+	possible_values[1] = ccs_string("b");
+	possible_values[2] = ccs_string("c");
+	err = ccs_create_categorical_hyperparameter("cat1", 3, possible_values, 0,
+	                                            NULL, hyperparameters);
+	assert( err == CCS_SUCCESS );
+	for (int i = 0; i < 4; i++)
+		possible_values[i] = ccs_int(i + 1);
+	err = ccs_create_ordinal_hyperparameter("ord", 4, possible_values, 0,
+	                                        NULL, hyperparameters + 1);
+	assert( err == CCS_SUCCESS );
+	possible_values[0] = ccs_string("x");
+	possible_values[1] = ccs_string("y");
+	err = ccs_create_categorical_hyperparameter("cat2", 2, possible_values, 0,
+	                                            NULL, hyperparameters + 2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameters(space, 3, hyperparameters, NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_parse((ccs_context_t)space, "cat1 == 'a'", &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_condition(space, 2, expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_expression_parse((ccs_context_t)space,
+	                           "cat1 == 'b' && ord > 2", expressions);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_parse((ccs_context_t)space,
+	                           "cat2 == 'y' || ord == 4", expressions + 1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_forbidden_clauses(space, 2, expressions);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_samples(space, 1000, configurations);
+	assert( err == CCS_SUCCESS );
+	for (int i = 0; i < 1000; i++) {
+		err = ccs_configuration_get_values(configurations[i], 3, values, NULL);
+		assert( err == CCS_SUCCESS );
+		for (int j = 0; j < 2; j++) {
+			err = ccs_expression_eval(expressions[j], (ccs_context_t)space,
+			                          values, &result);
+			assert( err == CCS_SUCCESS || err == -CCS_INACTIVE_HYPERPARAMETER );
+			assert( err || result.type != CCS_BOOLEAN || result.value.i != CCS_TRUE );
+		}
+		assert( values[1].value.i != 4 );
+		err = ccs_configuration_space_check_configuration(space, configurations[i]);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+
+	values[0] = ccs_string("b");
+	values[1] = ccs_int(3);
+	values[2] = ccs_inactive;
+	err = ccs_configuration_space_check_configuration_values(space, 3, values);
+	assert( err == -CCS_INVALID_CONFIGURATION );
+	values[1] = ccs_int(2);
+	err = ccs_configuration_space_check_configuration_values(space, 3, values);
+	assert( err == CCS_SUCCESS );
+	values[0] = ccs_string("a");
+	values[2] = ccs_string("y");
+	err = ccs_configuration_space_check_configuration_values(space, 3, values);
+	assert( err == -CCS_INVALID_CONFIGURATION );
+	values[2] = ccs_string("x");
+	err = ccs_configuration_space_check_configuration_values(space, 3, values);
+	assert( err == CCS_SUCCESS );
+
+	for (int i = 0; i < 2; i++) {
+		err = ccs_release_object(expressions[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	for (int i = 0; i < 3; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
+
+// A forbidden clause on a conditional hyperparameter rejects the rows where
+// it is active, which makes its parent favor the values that deactivate it:
+// with param2 active when param1 > 0, and forbidden when param2 > 0, a third
+// of the configurations have param1 > 0.
+void
+test_conditional() {
+	ccs_hyperparameter_t      hyperparameters[2];
+	ccs_configuration_space_t space;
+	ccs_expression_t          expression;
+	ccs_configuration_t       configurations[2000];
+	ccs_datum_t               values[2];
+	ccs_result_t              err;
+	size_t                    count = 0;
+
+	hyperparameters[0] = create_numerical("param1");
+	hyperparameters[1] = create_numerical("param2");
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameters(space, 2, hyperparameters,
+	                                                  NULL);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_parse((ccs_context_t)space, "param1 > 0.0",
+	                           &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_set_condition(space, 1, expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_parse((ccs_context_t)space, "param2 > 0.0",
+	                           &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_forbidden_clause(space, expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_configuration_space_samples(space, 2000, configurations);
+	assert( err == CCS_SUCCESS );
+	for (int i = 0; i < 2000; i++) {
+		err = ccs_configuration_get_values(configurations[i], 2, values, NULL);
+		assert( err == CCS_SUCCESS );
+		if (values[0].value.f > 0.0) {
+			count++;
+			assert( values[1].type == CCS_FLOAT );
+			assert( values[1].value.f <= 0.0 );
+		} else
+			assert( values[1].type == CCS_INACTIVE );
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	assert( count > 2000 * 0.28 && count < 2000 * 0.39 );
+
+	for (int i = 0; i < 2; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
+
+// Forbidden clauses over unconditional hyperparameters restrict the values
+// they are sampled from, so designs keep their strata on the allowed values.
+void
+test_restricted() {
+	ccs_hyperparameter_t      hyperparameters[5];
+	ccs_configuration_space_t space;
+	ccs_expression_t          expression;
+	ccs_datum_t               possible_values[100];
+	ccs_datum_t               values[5];
+	ccs_configuration_t       configurations[4000];
+	ccs_result_t              err;
+	char                      clause[512];
+	int                       length;
+	int                       strata[200], counts[100], pairs[4][4];
+
+	err = ccs_create_numerical_hyperparameter("f", CCS_NUM_FLOAT,
+	                                          CCSF(-1.0), CCSF(1.0),
+	                                          CCSF(0.0), CCSF(0.0),
+	                                          NULL, hyperparameters);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_numerical_hyperparameter("n", CCS_NUM_INTEGER,
+	                                          CCSI(0), CCSI(100),
+	                                          CCSI(0), CCSI(99),
+	                                          NULL, hyperparameters + 1);
+	assert( err == CCS_SUCCESS );
+	for (int i = 0; i < 100; i++)
+		possible_values[i] = ccs_int(i);
+	err = ccs_create_categorical_hyperparameter("c", 100, possible_values, 90,
+	                                            NULL, hyperparameters + 2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_categorical_hyperparameter("a", 4, possible_values, 0,
+	                                            NULL, hyperparameters + 3);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_categorical_hyperparameter("b", 4, possible_values, 1,
+	                                            NULL, hyperparameters + 4);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_configuration_space("space", NULL, &space);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_hyperparameters(space, 5, hyperparameters,
+	                                                  NULL);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_expression_parse((ccs_context_t)space, "f < 0.0 || f > 0.5",
+	                           &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_forbidden_clause(space, expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+	// 99 of the 100 values of n, and 90 of the 100 values of c
+	length = sprintf(clause, "n # [0");
+	for (int i = 1; i < 99; i++)
+		length += sprintf(clause + length, ", %d", i);
+	sprintf(clause + length, "]");
+	err = ccs_expression_parse((ccs_context_t)space, clause, &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_forbidden_clause(space, expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+	length = sprintf(clause, "c # [0");
+	for (int i = 1; i < 90; i++)
+		length += sprintf(clause + length, ", %d", i);
+	sprintf(clause + length, "]");
+	err = ccs_expression_parse((ccs_context_t)space, clause, &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_forbidden_clause(space, expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_expression_parse((ccs_context_t)space, "a == b", &expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_add_forbidden_clause(space, expression);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(expression);
+	assert( err == CCS_SUCCESS );
+
+	// Each of the 100 strata of the allowed values of f holds a sample,
+	// each allowed value of c 10 samples, and each value of a 25 samples.
+	err = ccs_configuration_space_set_sampling_method(space,
+		CCS_SAMPLING_LATIN_HYPERCUBE);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_samples(space, 100, configurations);
+	assert( err == CCS_SUCCESS );
+	memset(strata, 0, sizeof(strata));
+	memset(counts, 0, sizeof(counts));
+	memset(pairs, 0, sizeof(pairs));
+	for (int i = 0; i < 100; i++) {
+		err = ccs_configuration_get_values(configurations[i], 5, values, NULL);
+		assert( err == CCS_SUCCESS );
+		assert( values[0].value.f >= 0.0 && values[0].value.f <= 0.5 );
+		strata[(int)(values[0].value.f * 200)]++;
+		assert( values[1].value.i == 99 );
+		assert( values[2].value.i >= 90 );
+		counts[values[2].value.i]++;
+		assert( values[3].value.i != values[4].value.i );
+		pairs[values[3].value.i][values[4].value.i]++;
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	for (int i = 0; i < 100; i++)
+		assert( strata[i] == 1 );
+	for (int i = 90; i < 100; i++)
+		assert( counts[i] == 10 );
+	for (int i = 0; i < 4; i++)
+		assert( pairs[i][0] + pairs[i][1] + pairs[i][2] + pairs[i][3] == 25 );
+
+	// The 12 allowed pairs of a and b are equally likely
+	err = ccs_configuration_space_set_sampling_method(space,
+		CCS_SAMPLING_RANDOM);
+	assert( err == CCS_SUCCESS );
+	err = ccs_configuration_space_samples(space, 4000, configurations);
+	assert( err == CCS_SUCCESS );
+	memset(pairs, 0, sizeof(pairs));
+	for (int i = 0; i < 4000; i++) {
+		err = ccs_configuration_get_values(configurations[i], 5, values, NULL);
+		assert( err == CCS_SUCCESS );
+		assert( values[1].value.i == 99 );
+		pairs[values[3].value.i][values[4].value.i]++;
+		err = ccs_release_object(configurations[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			assert( i == j ? pairs[i][j] == 0 :
+			        pairs[i][j] > 250 && pairs[i][j] < 420 );
+
+	for (int i = 0; i < 5; i++) {
+		err = ccs_release_object(hyperparameters[i]);
+		assert( err == CCS_SUCCESS );
+	}
+	err = ccs_release_object(space);
+	assert( err == CCS_SUCCESS );
+}
 
 int main() {
 	ccs_init();
 	test_simple();
 	test_combined();
+	test_narrow();
+	test_reorder();
+	test_inactive();
+	test_categorical();
+	test_conditional();
+	test_restricted();
 	ccs_fini();
 	return 0;
 }
@@ -634,6 +634,76 @@ static void test_normal_distribution_soa_samples() {
 	assert( err == CCS_SUCCESS );
 }
 
+// Rejected values are drawn again before the next value is drawn, so
+// samples are the same as with a gsl_ran_gaussian rejection loop.
+static void test_normal_distribution_rejection_sequence() {
+	ccs_distribution_t distrib = NULL;
+	ccs_rng_t          rng = NULL, rng2 = NULL;
+	ccs_result_t       err = CCS_SUCCESS;
+	ccs_numeric_t      samples[2*NUM_SAMPLES];
+	gsl_rng           *grng;
+
+	err = ccs_rng_create(&rng);
+	assert( err == CCS_SUCCESS );
+	err = ccs_rng_create(&rng2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_rng_get_gsl_rng(rng2, &grng);
+	assert( err == CCS_SUCCESS );
+
+	// Half of the values are rejected
+	err = ccs_create_normal_distribution(CCS_NUM_FLOAT, 0.0, 2.0,
+	                                     CCS_LOGARITHMIC, CCSF(2.0),
+	                                     &distrib);
+	assert( err == CCS_SUCCESS );
+	for (size_t stride = 1; stride <= 2; stride++) {
+		err = ccs_rng_set_seed(rng, 10);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_set_seed(rng2, 10);
+		assert( err == CCS_SUCCESS );
+		err = ccs_distribution_strided_samples(distrib, rng, NUM_SAMPLES,
+		                                       stride, samples);
+		assert( err == CCS_SUCCESS );
+		for (size_t i = 0; i < NUM_SAMPLES; i++) {
+			ccs_float_t v;
+			do {
+				v = gsl_ran_gaussian(grng, 2.0);
+			} while (v < 0.0);
+			v = round(exp(v) * 0.5) * 2.0;
+			assert( samples[i*stride].f == v );
+		}
+	}
+	err = ccs_release_object(distrib);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_create_normal_distribution(CCS_NUM_INTEGER, 1.0, 2.0,
+	                                     CCS_LOGARITHMIC, CCSI(0),
+	                                     &distrib);
+	assert( err == CCS_SUCCESS );
+	for (size_t stride = 1; stride <= 2; stride++) {
+		err = ccs_rng_set_seed(rng, 10);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_set_seed(rng2, 10);
+		assert( err == CCS_SUCCESS );
+		err = ccs_distribution_strided_samples(distrib, rng, NUM_SAMPLES,
+		                                       stride, samples);
+		assert( err == CCS_SUCCESS );
+		for (size_t i = 0; i < NUM_SAMPLES; i++) {
+			ccs_float_t v;
+			do {
+				v = gsl_ran_gaussian(grng, 2.0) + 1.0;
+			} while (v < log(0.5));
+			assert( samples[i*stride].i == (ccs_int_t)round(exp(v)) );
+		}
+	}
+	err = ccs_release_object(distrib);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_release_object(rng);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(rng2);
+	assert( err == CCS_SUCCESS );
+}
+
 int main() {
 	ccs_init();
 	test_create_normal_distribution();
@@ -648,6 +718,7 @@ int main() {
 	test_normal_distribution_float_log_quantize();
 	test_normal_distribution_strided_samples();
 	test_normal_distribution_soa_samples();
+	test_normal_distribution_rejection_sequence();
 	ccs_fini();
 	return 0;
 }
@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <cconfigspace.h>
 #include <gsl/gsl_rng.h>
@@ -116,6 +117,255 @@ static void test_rng_uniform() {
 	assert( err == CCS_SUCCESS );
 }
 
+static void test_rng_uniform_fill() {
+	const gsl_rng_type *types[2] = { gsl_rng_default, ccs_rng_philox4x32_10 };
+	const size_t        sizes[5] = { 1, 3, 4, 70, 200 };
+	ccs_rng_t           rng = NULL;
+	ccs_result_t        err = CCS_SUCCESS;
+	double              d[278], f[278];
+
+	for (int t = 0; t < 2; t++) {
+		err = ccs_rng_create_with_type(types[t], &rng);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_set_seed(rng, 10);
+		assert( err == CCS_SUCCESS );
+		for (int j = 0; j < 278; j++) {
+			err = ccs_rng_uniform(rng, d + j);
+			assert( err == CCS_SUCCESS );
+		}
+		err = ccs_rng_set_seed(rng, 10);
+		assert( err == CCS_SUCCESS );
+		for (size_t j = 0, k = 0; j < 5; k += sizes[j++]) {
+			err = ccs_rng_uniform_fill(rng, sizes[j], f + k);
+			assert( err == CCS_SUCCESS );
+		}
+		for (int j = 0; j < 278; j++) {
+			assert( d[j] == f[j] );
+			assert( f[j] >= 0.0 );
+			assert( f[j] <  1.0 );
+		}
+		err = ccs_rng_uniform_fill(rng, 1, NULL);
+		assert( err == -CCS_INVALID_VALUE );
+		err = ccs_rng_uniform_fill(rng, 0, NULL);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(rng);
+		assert( err == CCS_SUCCESS );
+	}
+}
+
+static void test_rng_philox() {
+	ccs_rng_t         rng = NULL;
+	ccs_result_t      err = CCS_SUCCESS;
+	unsigned long int i = 0;
+	// Known answer of Philox4x32-10 for a null key and counter
+	unsigned long int expected[4] =
+		{ 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+
+	err = ccs_rng_create_with_type(ccs_rng_philox4x32_10, &rng);
+	assert( err == CCS_SUCCESS );
+	err = ccs_rng_max(rng, &i);
+	assert( err == CCS_SUCCESS );
+	assert( i == 0xffffffff );
+	err = ccs_rng_set_seed(rng, 0);
+	assert( err == CCS_SUCCESS );
+	for (int j = 0; j < 4; j++) {
+		err = ccs_rng_get(rng, &i);
+		assert( err == CCS_SUCCESS );
+		assert( i == expected[j] );
+	}
+	err = ccs_release_object(rng);
+	assert( err == CCS_SUCCESS );
+}
+
+static void test_rng_jump() {
+	const gsl_rng_type *types[2] = { gsl_rng_default, ccs_rng_philox4x32_10 };
+	const uint64_t      jumps[6] = { 0, 1, 3, 4, 5, 70 };
+	ccs_rng_t           rng = NULL, rng2 = NULL;
+	ccs_result_t        err = CCS_SUCCESS;
+	unsigned long int   i1, i2;
+
+	for (int t = 0; t < 2; t++) {
+		err = ccs_rng_create_with_type(types[t], &rng);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_create_with_type(types[t], &rng2);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_set_seed(rng, 10);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_set_seed(rng2, 10);
+		assert( err == CCS_SUCCESS );
+		for (int j = 0; j < 6; j++) {
+			for (uint64_t k = 0; k < jumps[j]; k++) {
+				err = ccs_rng_get(rng, &i1);
+				assert( err == CCS_SUCCESS );
+			}
+			err = ccs_rng_jump(rng2, jumps[j]);
+			assert( err == CCS_SUCCESS );
+			err = ccs_rng_get(rng, &i1);
+			assert( err == CCS_SUCCESS );
+			err = ccs_rng_get(rng2, &i2);
+			assert( err == CCS_SUCCESS );
+			assert( i1 == i2 );
+		}
+		err = ccs_rng_jump(NULL, 1);
+		assert( err == -CCS_INVALID_OBJECT );
+		err = ccs_release_object(rng);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(rng2);
+		assert( err == CCS_SUCCESS );
+	}
+
+	// Jumps far ahead are constant time and carry into the upper counter words
+	err = ccs_rng_create_with_type(ccs_rng_philox4x32_10, &rng);
+	assert( err == CCS_SUCCESS );
+	err = ccs_rng_create_with_type(ccs_rng_philox4x32_10, &rng2);
+	assert( err == CCS_SUCCESS );
+	err = ccs_rng_jump(rng, UINT64_MAX);
+	assert( err == CCS_SUCCESS );
+	err = ccs_rng_jump(rng, 1);
+	assert( err == CCS_SUCCESS );
+	err = ccs_rng_jump(rng2, (uint64_t)1 << 63);
+	assert( err == CCS_SUCCESS );
+	err = ccs_rng_jump(rng2, (uint64_t)1 << 63);
+	assert( err == CCS_SUCCESS );
+	for (int j = 0; j < 8; j++) {
+		err = ccs_rng_get(rng, &i1);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_get(rng2, &i2);
+		assert( err == CCS_SUCCESS );
+		assert( i1 == i2 );
+	}
+	err = ccs_release_object(rng);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(rng2);
+	assert( err == CCS_SUCCESS );
+}
+
+static void test_rng_split() {
+	const gsl_rng_type *types[2] = { gsl_rng_default, ccs_rng_philox4x32_10 };
+	ccs_rng_t           rng = NULL, children[4], children2[4];
+	ccs_result_t        err = CCS_SUCCESS;
+	const gsl_rng_type *t;
+	unsigned long int   v[4], v2;
+
+	for (int k = 0; k < 2; k++) {
+		err = ccs_rng_create_with_type(types[k], &rng);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_set_seed(rng, 10);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_split(rng, 4, children);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_set_seed(rng, 10);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_split(rng, 4, children2);
+		assert( err == CCS_SUCCESS );
+		for (int j = 0; j < 4; j++) {
+			err = ccs_rng_get_type(children[j], &t);
+			assert( err == CCS_SUCCESS );
+			assert( t == types[k] );
+			err = ccs_rng_get(children[j], v + j);
+			assert( err == CCS_SUCCESS );
+			err = ccs_rng_get(children2[j], &v2);
+			assert( err == CCS_SUCCESS );
+			assert( v[j] == v2 );
+			for (int l = 0; l < j; l++)
+				assert( v[l] != v[j] );
+			err = ccs_release_object(children[j]);
+			assert( err == CCS_SUCCESS );
+			err = ccs_release_object(children2[j]);
+			assert( err == CCS_SUCCESS );
+		}
+		err = ccs_rng_split(rng, 1, NULL);
+		assert( err == -CCS_INVALID_VALUE );
+		err = ccs_rng_split(rng, 0, NULL);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_split(NULL, 1, children);
+		assert( err == -CCS_INVALID_OBJECT );
+		err = ccs_release_object(rng);
+		assert( err == CCS_SUCCESS );
+	}
+}
+
+static void test_rng_state() {
+	const gsl_rng_type *types[2] = { gsl_rng_default, ccs_rng_philox4x32_10 };
+	ccs_rng_t           rng = NULL, rng2 = NULL, rng3 = NULL;
+	ccs_result_t        err = CCS_SUCCESS;
+	size_t              size, size2;
+	char               *state;
+	unsigned long int   v1[10], v2;
+
+	for (int t = 0; t < 2; t++) {
+		err = ccs_rng_create_with_type(types[t], &rng);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_create_with_type(types[t], &rng2);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_create_with_type(types[1 - t], &rng3);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_set_seed(rng, 10);
+		assert( err == CCS_SUCCESS );
+		// Start in the middle of a Philox block
+		err = ccs_rng_jump(rng, 3);
+		assert( err == CCS_SUCCESS );
+
+		err = ccs_rng_get_state(rng, 0, NULL, &size);
+		assert( err == CCS_SUCCESS );
+		assert( size > 0 );
+		state = (char *)malloc(size + 1);
+		assert( state );
+		err = ccs_rng_get_state(rng, size - 1, state, NULL);
+		assert( err == -CCS_INVALID_VALUE );
+		err = ccs_rng_get_state(rng, size + 1, state, &size2);
+		assert( err == CCS_SUCCESS );
+		assert( size2 == size );
+		err = ccs_rng_get_state(rng, 0, NULL, NULL);
+		assert( err == -CCS_INVALID_VALUE );
+		err = ccs_rng_get_state(rng, 1, NULL, &size2);
+		assert( err == -CCS_INVALID_VALUE );
+
+		for (int j = 0; j < 10; j++) {
+			err = ccs_rng_get(rng, v1 + j);
+			assert( err == CCS_SUCCESS );
+		}
+		err = ccs_rng_set_state(rng, size, state);
+		assert( err == CCS_SUCCESS );
+		err = ccs_rng_set_state(rng2, size, state);
+		assert( err == CCS_SUCCESS );
+		for (int j = 0; j < 10; j++) {
+			err = ccs_rng_get(rng, &v2);
+			assert( err == CCS_SUCCESS );
+			assert( v1[j] == v2 );
+			err = ccs_rng_get(rng2, &v2);
+			assert( err == CCS_SUCCESS );
+			assert( v1[j] == v2 );
+		}
+
+		err = ccs_rng_set_state(rng3, size, state);
+		assert( err == -CCS_INVALID_VALUE );
+		if (types[t] == ccs_rng_philox4x32_10) {
+			// Corrupted index of the last generated word
+			uint32_t index = 5;
+			memcpy(state + size - sizeof(uint32_t), &index, sizeof(index));
+			err = ccs_rng_set_state(rng, size, state);
+			assert( err == -CCS_INVALID_VALUE );
+		}
+		err = ccs_rng_set_state(rng, size - 1, state);
+		assert( err == -CCS_INVALID_VALUE );
+		err = ccs_rng_set_state(rng, size, NULL);
+		assert( err == -CCS_INVALID_VALUE );
+		err = ccs_rng_get_state(NULL, size, state, NULL);
+		assert( err == -CCS_INVALID_OBJECT );
+		err = ccs_rng_set_state(NULL, size, state);
+		assert( err == -CCS_INVALID_OBJECT );
+
+		free(state);
+		err = ccs_release_object(rng);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(rng2);
+		assert( err == CCS_SUCCESS );
+		err = ccs_release_object(rng3);
+		assert( err == CCS_SUCCESS );
+	}
+}
+
 int main() {
 	ccs_init();
 	test_rng_create_with_type();
@@ -123,6 +373,11 @@ int main() {
 	test_rng_min_max();
 	test_rng_get();
 	test_rng_uniform();
+	test_rng_uniform_fill();
+	test_rng_philox();
+	test_rng_jump();
+	test_rng_split();
+	test_rng_state();
 	ccs_fini();
 	return 0;
 }
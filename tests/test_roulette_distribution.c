@@ -213,6 +213,50 @@ void test_roulette_distribution_zero() {
 	assert( err == CCS_SUCCESS );
 }
 
+// Many areas, with every tenth area empty, as used by the alias table
+void test_roulette_distribution_many() {
+	ccs_distribution_t distrib = NULL;
+	ccs_rng_t          rng = NULL;
+	ccs_result_t       err = CCS_SUCCESS;
+	const size_t       num_samples = 100 * NUM_SAMPLES;
+	const size_t       num_areas = 1000;
+	ccs_numeric_t     *samples;
+	ccs_float_t        areas[1000];
+	int                counts[10] = { 0 };
+
+	samples = (ccs_numeric_t *)malloc(num_samples * sizeof(ccs_numeric_t));
+	assert( samples );
+	for(size_t i = 0; i < num_areas; i++)
+		areas[i] = (double)(i % 10);
+
+	err = ccs_rng_create(&rng);
+	assert( err == CCS_SUCCESS );
+	err = ccs_create_roulette_distribution(
+		num_areas,
+		areas,
+		&distrib);
+	assert( err == CCS_SUCCESS );
+
+	err = ccs_distribution_samples(distrib, rng, num_samples, samples);
+	assert( err == CCS_SUCCESS );
+
+	for(size_t i = 0; i < num_samples; i++) {
+		assert( samples[i].i >=0 && samples[i].i < (ccs_int_t)num_areas );
+		counts[samples[i].i % 10]++;
+	}
+	assert( counts[0] == 0 );
+	for(size_t i = 1; i < 10; i++) {
+		ccs_float_t target = num_samples * i / 45.0;
+		assert( counts[i] >= target * 0.95 && counts[i] <= target * 1.05 );
+	}
+
+	free(samples);
+	err = ccs_release_object(distrib);
+	assert( err == CCS_SUCCESS );
+	err = ccs_release_object(rng);
+	assert( err == CCS_SUCCESS );
+}
+
 void test_roulette_distribution_strided_samples() {
 	ccs_distribution_t distrib1 = NULL;
 	ccs_distribution_t distrib2 = NULL;
@@ -346,6 +390,7 @@ int main() {
 	test_create_roulette_distribution_errors();
 	test_roulette_distribution();
 	test_roulette_distribution_zero();
+	test_roulette_distribution_many();
 	test_roulette_distribution_strided_samples();
 	test_roulette_distribution_soa_samples();
 	ccs_fini();